@@ -0,0 +1,145 @@
+#pragma once
+
+// Runtime for ROMs compiled ahead of time by recompile (see recompiler.cpp).
+//
+// A compiled ROM is a translation unit with one function per basic block plus a
+// Chip8AotProgram describing them. Each block function runs its instructions straight
+// against a Chip8 and returns how many it retired, with the program counter, current_opcode
+// and the clock (advance_cycles()) left exactly as step() would leave them. Chip8Aot looks
+// up the block at the program counter and runs it, and everything else goes through
+// step() one instruction at a time: indirect BNNN targets, FX0A, idle loops, code the
+// analysis never reached, and blocks whose bytes in memory no longer match the ROM the
+// program was compiled from.
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "cpu.cpp"
+
+typedef uint32_t (*Chip8AotEntry)(Chip8 &c);
+
+struct Chip8AotBlock
+{
+    Chip8AotEntry entry;
+    uint16_t start;
+    uint16_t end;          // One past its last byte
+    uint32_t length;       // Instructions retired when it runs to the end
+    uint32_t timer_reach;  // Position of its last FX07/FX15/FX18, 0 without any
+};
+
+struct Chip8AotProgram
+{
+    QuirkProfile quirks;
+    const Chip8AotBlock* blocks;
+    size_t block_count;
+    const uint8_t* image;  // Memory the blocks were compiled from, starting at image_start
+    uint16_t image_start;
+    uint16_t image_end;
+    uint64_t code_pages;   // 64-byte pages holding compiled code
+};
+
+class Chip8Aot {
+public:
+
+    Chip8Aot(Chip8 &cpu, const Chip8AotProgram &program) : cpu(cpu), program(program)
+    {
+        for (auto &b : block_at)
+            b = no_block;
+    }
+
+    Chip8Aot(const Chip8Aot &) = delete;
+    Chip8Aot &operator=(const Chip8Aot &) = delete;
+
+    // False when the machine runs another quirk profile, everything is interpreted then
+    bool compatible() const { return cpu.quirks == program.quirks; }
+
+    // Blocks whose code is still what was compiled
+    size_t valid_blocks()
+    {
+        revalidate(~0ull);
+        size_t valid = 0;
+        for (auto b : block_at)
+            valid += b >= 0 ? 1 : 0;
+        return valid;
+    }
+
+    // Same contract as Chip8::run_cycles()
+    StopReason run_cycles(uint64_t n)
+    {
+        if (cpu.status == StopReason::Halted || cpu.status == StopReason::Fault)
+            return cpu.status;
+
+        // Blocks don't report single instructions, traced or profiled runs are interpreted
+        if (cpu.trace != nullptr || cpu.profile != nullptr || !compatible())
+            return cpu.run_cycles(n);
+
+        uint64_t executed = 0;
+        while (executed < n)
+        {
+            if (cpu.code_dirty_pages != 0)
+            {
+                uint64_t dirty = cpu.code_dirty_pages;
+                cpu.code_dirty_pages = 0;
+                revalidate(dirty);
+            }
+
+            uint16_t pc = cpu.program_counter;
+            if (!(pc & 1) && pc <= 0xFFE)
+            {
+                int32_t id = block_at[pc >> 1];
+                if (id >= 0)
+                {
+                    const Chip8AotBlock &block = program.blocks[id];
+                    // Timer opcodes have to run before the frame's tick, advance_cycles() does the rest
+                    if (block.length <= n - executed && cpu.cycles_per_frame - cpu.cycles_into_frame >= block.timer_reach)
+                    {
+                        executed += block.entry(cpu);
+                        if (cpu.status == StopReason::Halted || cpu.status == StopReason::Fault)
+                            return cpu.status;
+                        continue;
+                    }
+                }
+            }
+
+            StopReason reason = cpu.step();
+            ++executed;
+            if (reason == StopReason::Idle)
+                executed += cpu.skip_idle(n - executed);
+            else if (reason != StopReason::None)
+                return reason;
+        }
+        return StopReason::CycleLimit;
+    }
+
+private:
+
+    static const int32_t no_block = -1;
+
+    Chip8 &cpu;
+    const Chip8AotProgram &program;
+    int32_t block_at[4096 / 2];
+
+    // Blocks on dirty pages are switched on or off depending on whether their bytes match
+    void revalidate(uint64_t dirty)
+    {
+        if (!(dirty & program.code_pages))
+            return;
+        for (size_t id = 0; id < program.block_count; ++id)
+        {
+            const Chip8AotBlock &block = program.blocks[id];
+            if (!(dirty & pages(block)))
+                continue;
+            bool same = memcmp(cpu.memory + block.start, program.image + (block.start - program.image_start),
+                               block.end - block.start) == 0;
+            block_at[block.start >> 1] = same ? static_cast<int32_t>(id) : no_block;
+        }
+    }
+
+    static uint64_t pages(const Chip8AotBlock &block)
+    {
+        uint64_t mask = 0;
+        for (uint32_t page = block.start >> 6; page <= static_cast<uint32_t>(block.end - 1) >> 6; ++page)
+            mask |= 1ull << page;
+        return mask;
+    }
+};
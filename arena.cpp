@@ -0,0 +1,119 @@
+#pragma once
+
+// Pool of machines that all restart from one boot image. The image is a Chip8 after init()
+// with the ROM already at 0x200 and every program slot decoded, so reset() copies it over
+// an instance instead of running init(), loadROM() and decoding the program again.
+//
+// The decoded cache is most of a Chip8 (32 KB of 38) and an instance's cache only differs
+// from the image on pages it wrote or after a display mode switch, which
+// decoded_changed_pages tracks. So reset() is one block copy of everything in front of the
+// cache, one of the few fields behind it, and 512 bytes per changed page. Slots are cache
+// line aligned so instances never share a line.
+//
+// Chip8 has to stay trivially copyable for this, nothing in it owns memory.
+
+#include <new>
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+#include <vector>
+#include "cpu.cpp"
+
+static_assert(std::is_trivially_copyable<Chip8>::value, "Chip8Arena copies machines with memcpy");
+
+class Chip8Arena {
+public:
+
+    explicit Chip8Arena(size_t instances, QuirkProfile quirks = QuirkProfile::Original)
+        : slots(instances + 1), count(instances)
+    {
+        for (auto &s : slots)
+            new (s.bytes) Chip8(quirks);
+
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(&boot());
+        cache_start = reinterpret_cast<const uint8_t*>(&boot().decoded) - base;
+        cache_end = cache_start + sizeof(boot().decoded);
+
+        boot().init();
+        reset_all();
+    }
+
+    Chip8Arena(const Chip8Arena &) = delete;
+    Chip8Arena &operator=(const Chip8Arena &) = delete;
+
+    size_t size() const { return count; }
+
+    Chip8 &operator[](size_t i) { return *reinterpret_cast<Chip8*>(slots[i + 1].bytes); }
+
+    // The image instances reset to. Change it directly (cycles_per_frame, seed_random() and so
+    // on) and call reset_all(), or use load() for the common case.
+    Chip8 &boot() { return *reinterpret_cast<Chip8*>(slots[0].bytes); }
+
+    // Makes a fresh machine with this ROM the boot image and resets every instance to it
+    bool load(const uint8_t* rom, size_t size)
+    {
+        Chip8 &image = boot();
+        image.init();
+        if (!loadROM(rom, size, image))
+            return false;
+        reset_all();
+        return true;
+    }
+
+    // Back to the boot image. The trace and profile hooks stay attached.
+    void reset(size_t i)
+    {
+        Chip8 &cpu = (*this)[i];
+        const Chip8 &image = boot();
+        Chip8Trace* trace = cpu.trace;
+        Chip8Profile* profile = cpu.profile;
+        uint64_t changed = cpu.decoded_changed_pages;
+
+        uint8_t* to = reinterpret_cast<uint8_t*>(&cpu);
+        const uint8_t* from = reinterpret_cast<const uint8_t*>(&image);
+        memcpy(to, from, cache_start);
+        memcpy(to + cache_end, from + cache_end, sizeof(Chip8) - cache_end);
+
+        const size_t slots_per_page = 32;
+        while (changed != 0)
+        {
+            int page = __builtin_ctzll(changed);
+            changed &= changed - 1;
+            memcpy(&cpu.decoded[page * slots_per_page], &image.decoded[page * slots_per_page],
+                   slots_per_page * sizeof(Chip8::DecodedOp));
+        }
+
+        cpu.trace = trace;
+        cpu.profile = profile;
+    }
+
+    // Call after changing boot() directly. Decodes the whole image and puts every instance on it.
+    void reset_all()
+    {
+        Chip8 &image = boot();
+        for (uint32_t pc = 0x200; pc < 0x1000; pc += 2)
+            image.fetch(static_cast<uint16_t>(pc));
+        image.decoded_changed_pages = 0;
+
+        // Instances may not have seen this image yet, copy their whole cache once
+        for (size_t i = 0; i < count; ++i)
+        {
+            (*this)[i].decoded_changed_pages = ~0ull;
+            reset(i);
+        }
+    }
+
+private:
+
+    struct alignas(64) Slot
+    {
+        unsigned char bytes[sizeof(Chip8)];
+    };
+
+    std::vector<Slot> slots;  // Slot 0 is the boot image
+    size_t count;
+
+    // Byte range of Chip8::decoded
+    size_t cache_start;
+    size_t cache_end;
+};
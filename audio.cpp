@@ -0,0 +1,174 @@
+#pragma once
+
+// Beeper. The emulation thread calls frame() once per 60 Hz frame with whether the sound
+// timer is running, which goes into a single-producer single-consumer ring. The audio
+// thread calls fill() from its callback and turns the frames into a square wave, one
+// frame's worth of samples (sample_rate / 60) per entry. Neither side ever waits on the
+// other: frame() drops the entry when the ring is full (no device draining it, SDL's dummy
+// driver), and fill() keeps playing the last state for a frame when the ring runs dry,
+// then goes quiet. When the emulator gets ahead, fill() skips to the newest entries so
+// the tone never lags the picture by more than max_backlog frames.
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+class Chip8Beeper {
+public:
+
+    static const size_t capacity = 64;  // Frames, about a second
+
+    explicit Chip8Beeper(int sample_rate = 44100, int tone_hz = 440, int16_t volume = 3000)
+        : sample_rate(sample_rate), volume(volume)
+    {
+        set_tone(tone_hz);
+    }
+
+    void set_tone(int hz) { phase_step = static_cast<uint32_t>((static_cast<uint64_t>(hz) << 32) / sample_rate); }
+
+    // Producer side, once per emulated frame
+    void frame(bool tone_on)
+    {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= capacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        frames[h & (capacity - 1)] = tone_on ? 1 : 0;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // Consumer side, signed 16-bit mono
+    void fill(int16_t* out, size_t samples)
+    {
+        for (size_t i = 0; i < samples; ++i)
+        {
+            if (samples_left == 0)
+                next_frame();
+            --samples_left;
+
+            if (tone_on)
+            {
+                out[i] = phase < 0x80000000u ? volume : static_cast<int16_t>(-volume);
+                phase += phase_step;
+            }
+            else
+                out[i] = 0;
+        }
+    }
+
+    uint64_t dropped_frames() const { return dropped.load(std::memory_order_relaxed); }
+
+    // Frames queued beyond this are skipped, the tone keeps up with the picture instead
+    uint32_t max_backlog = 2;
+
+private:
+
+    int sample_rate;
+    int16_t volume;
+
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) std::atomic<uint64_t> dropped{0};
+    uint8_t frames[capacity] = {};
+
+    // Audio thread only
+    uint32_t phase = 0;
+    uint32_t phase_step = 0;
+    uint32_t samples_left = 0;
+    uint32_t sample_remainder = 0;  // sample_rate / 60 isn't whole, spread the rest
+    uint32_t starved = 0;
+    bool tone_on = false;
+
+    void next_frame()
+    {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t available = head.load(std::memory_order_acquire) - t;
+        if (available > max_backlog)
+        {
+            t += available - max_backlog;
+            available = max_backlog;
+        }
+
+        if (available > 0)
+        {
+            tone_on = frames[t & (capacity - 1)] != 0;
+            tail.store(t + 1, std::memory_order_release);
+            starved = 0;
+        }
+        else if (++starved > 1)
+            tone_on = false;  // Emulator paused or gone, don't hold a note forever
+        if (!tone_on)
+            phase = 0;
+
+        sample_remainder += sample_rate % 60;
+        samples_left = sample_rate / 60 + sample_remainder / 60;
+        sample_remainder %= 60;
+    }
+};
+
+// Mono 16-bit WAV file, for listening to headless runs
+class Chip8WavWriter {
+public:
+
+    ~Chip8WavWriter() { close(); }
+
+    bool open(const char* filename, int rate)
+    {
+        close();
+        file = fopen(filename, "wb");
+        if (file == nullptr)
+            return false;
+        sample_rate = rate;
+        samples = 0;
+        write_header();
+        return true;
+    }
+
+    void write(const int16_t* data, size_t count)
+    {
+        if (file == nullptr)
+            return;
+        fwrite(data, sizeof(int16_t), count, file);
+        samples += count;
+    }
+
+    // Fills in the sizes now that they are known
+    void close()
+    {
+        if (file == nullptr)
+            return;
+        fseek(file, 0, SEEK_SET);
+        write_header();
+        fclose(file);
+        file = nullptr;
+    }
+
+private:
+
+    FILE* file = nullptr;
+    int sample_rate = 44100;
+    uint64_t samples = 0;
+
+    void put32(uint32_t v) { fwrite(&v, 4, 1, file); }
+    void put16(uint16_t v) { fwrite(&v, 2, 1, file); }
+
+    void write_header()
+    {
+        uint32_t data_bytes = static_cast<uint32_t>(samples * sizeof(int16_t));
+        fwrite("RIFF", 1, 4, file);
+        put32(36 + data_bytes);
+        fwrite("WAVEfmt ", 1, 8, file);
+        put32(16);
+        put16(1);                                // PCM
+        put16(1);                                // Mono
+        put32(static_cast<uint32_t>(sample_rate));
+        put32(static_cast<uint32_t>(sample_rate) * 2);
+        put16(2);                                // Bytes per sample frame
+        put16(16);
+        fwrite("data", 1, 4, file);
+        put32(data_bytes);
+    }
+};
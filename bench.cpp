@@ -0,0 +1,416 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "arena.cpp"
+#include "compact.cpp"
+#include "cpu.cpp"
+#include "jit.cpp"
+#include "pixels.cpp"
+
+using namespace std;
+
+// Benchmark suite. Each workload is a small generated ROM that loops forever on one kind
+// of opcode, plus any real ROMs given on the command line. Every workload runs a fixed
+// number of frames through run_frame() (on the JIT with --jit), best of a few repeats,
+// and reports instructions per second, ns per instruction and frames per second. Frame time
+// spent blocked on FX0A isn't instructions, so workloads that wait only get frames per second.
+//
+// Usage: bench [--jit] [--json] [--quirks profile] [--frames N] [--ipf N] [--repeat N] [rom...]
+
+struct Workload
+{
+    string name;
+    vector<uint8_t> image;  // Loaded at 0x200
+};
+
+// Builds a ROM image from opcodes placed at given addresses, gaps are zero
+class RomBuilder {
+public:
+
+    RomBuilder &at(uint16_t address, const vector<uint16_t> &opcodes)
+    {
+        for (uint16_t op : opcodes)
+        {
+            put(address++, static_cast<uint8_t>(op >> 8));
+            put(address++, static_cast<uint8_t>(op & 0xFF));
+        }
+        return *this;
+    }
+
+    RomBuilder &data(uint16_t address, const vector<uint8_t> &bytes)
+    {
+        for (uint8_t b : bytes)
+            put(address++, b);
+        return *this;
+    }
+
+    vector<uint8_t> image;
+
+private:
+
+    void put(uint16_t address, uint8_t value)
+    {
+        size_t offset = address - 0x200;
+        if (image.size() <= offset)
+            image.resize(offset + 1, 0);
+        image[offset] = value;
+    }
+};
+
+static vector<Workload> synthetic_workloads()
+{
+    const vector<uint8_t> sprite = {0xFF, 0x81, 0xBD, 0xA5, 0xA5, 0xBD, 0x81, 0xFF,
+                                    0x3C, 0x42, 0x99, 0xA5, 0xA5, 0x99, 0x42, 0x3C,
+                                    0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F,
+                                    0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55};
+    vector<Workload> workloads;
+
+    // 8XY* arithmetic and logic
+    workloads.push_back({"alu", RomBuilder().at(0x200, {
+        0x6001, 0x6102, 0x6203, 0x6304,
+        0x8014, 0x8125, 0x8236, 0x8347, 0x830E, 0x8011, 0x8122, 0x8233, 0x8340, 0x7101,
+        0x1208}).image});
+
+    // Skips taken and not taken, jumps, calls and returns
+    workloads.push_back({"branch", RomBuilder()
+        .at(0x200, {0x6000, 0x6105, 0x7001, 0x4005, 0x6000, 0x2220, 0x5010, 0x9010,
+                    0x1204, 0x3001, 0x1204, 0x1204})
+        .at(0x220, {0x7201, 0x00EE}).image});
+
+    // 8 and 15 row sprites across the low-res screen, cleared every so often
+    workloads.push_back({"draw", RomBuilder()
+        .at(0x200, {0xA300, 0x6000, 0x6100, 0xD015, 0x7003, 0x7105, 0xD01F, 0x7207,
+                    0x3200, 0x1206, 0x00E0, 0x1206})
+        .data(0x300, sprite).image});
+
+    // SUPER-CHIP scrolls interleaved with 16x16 draws in extended mode
+    workloads.push_back({"scroll", RomBuilder()
+        .at(0x200, {0x00FF, 0xA300, 0x6000, 0x6100, 0xD010, 0x00C3, 0x00FB, 0x7009,
+                    0xD015, 0x00FC, 0x7105, 0x1208})
+        .data(0x300, sprite).image});
+
+    // FX55/FX65 register block moves, BCD and I arithmetic
+    workloads.push_back({"memory", RomBuilder().at(0x200, {
+        0x6001, 0xA400, 0xF755, 0xF765, 0xF033, 0xF01E, 0xF755, 0x7001, 0x1202}).image});
+
+    // FX0A with no key held, every frame waits
+    workloads.push_back({"keywait", RomBuilder().at(0x200, {0xF00A, 0x1200}).image});
+
+    // Delay timer polling, the usual way games wait for the next frame
+    workloads.push_back({"delaywait", RomBuilder().at(0x200, {0x6002, 0xF015, 0xF007, 0x3000, 0x1204, 0x1200}).image});
+
+    return workloads;
+}
+
+static bool load_workload_file(const char* path, Workload &workload)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr)
+        return false;
+    vector<uint8_t> image(4096 - 0x200);
+    size_t size = fread(image.data(), 1, image.size(), file);
+    fclose(file);
+    image.resize(size);
+
+    const char* slash = strrchr(path, '/');
+    workload.name = slash ? slash + 1 : path;
+    workload.image = image;
+    return size > 0;
+}
+
+// The workload a measurement runs on, by name so it doesn't depend on the order they're built in
+static const Workload &find_workload(const vector<Workload> &workloads, const char* name)
+{
+    for (auto &w : workloads)
+        if (w.name == name)
+            return w;
+    return workloads[0];
+}
+
+// A file name as a JSON string body, quotes, backslashes and control characters escaped
+static string json_escape(const string &text)
+{
+    string out;
+    for (unsigned char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += static_cast<char>(c);
+        }
+        else if (c < 0x20)
+        {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            out += code;
+        }
+        else
+            out += static_cast<char>(c);
+    }
+    return out;
+}
+
+struct Result
+{
+    string name;
+    uint64_t instructions;  // Executed, without the frame time spent waiting for a key
+    uint64_t waited;        // Instruction slots run_frame() spent waiting on FX0A
+    uint64_t frames;
+    double seconds;
+    string stop;
+};
+
+static Result run_workload(const Workload &workload, bool use_jit, QuirkProfile quirks, uint64_t frames, uint32_t ipf, int repeat)
+{
+    Result best = {workload.name, 0, 0, 0, 0, "frame-boundary"};
+
+    for (int r = 0; r < repeat; ++r)
+    {
+        Chip8 cpu(quirks);
+        cpu.init();
+        cpu.cycles_per_frame = ipf;
+        memcpy(&cpu.memory[0x200], workload.image.data(), workload.image.size());
+        cpu.invalidate_decoded(0x200, static_cast<uint32_t>(workload.image.size()));
+        unique_ptr<Chip8Jit> jit;
+        if (use_jit)
+            jit.reset(new Chip8Jit(cpu));
+
+        StopReason stop = StopReason::FrameBoundary;
+        uint64_t waited = 0;
+        auto start = chrono::steady_clock::now();
+        uint64_t frame = 0;
+        for (; frame < frames; ++frame)
+        {
+            StopReason reason = jit ? cpu.run_frame_on(*jit, &waited) : cpu.run_frame_on(cpu, &waited);
+            if (reason == StopReason::Halted || reason == StopReason::Fault)
+            {
+                stop = reason;
+                break;
+            }
+            if (reason == StopReason::WaitingForKey)
+                stop = reason;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        if (r == 0 || seconds < best.seconds)
+            best = {workload.name, cpu.cycle_count - waited, waited, frame, seconds, stop_reason_name(stop)};
+    }
+    return best;
+}
+
+struct ResetCost
+{
+    double init_ns;   // init() plus loadROM()
+    double arena_ns;  // Chip8Arena::reset()
+};
+
+// Average cost of putting a machine back to the start of a workload, both ways
+static ResetCost measure_resets(const Workload &workload, QuirkProfile quirks)
+{
+    const int resets = 20000;
+    const size_t instances = 16;
+    ResetCost cost;
+
+    Chip8 cpu(quirks);
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < resets; ++r)
+    {
+        cpu.init();
+        loadROM(workload.image.data(), workload.image.size(), cpu);
+    }
+    cost.init_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / resets;
+
+    Chip8Arena arena(instances, quirks);
+    arena.load(workload.image.data(), workload.image.size());
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < resets; ++r)
+        arena.reset(r % instances);
+    cost.arena_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / resets;
+    return cost;
+}
+
+struct CompactCost
+{
+    size_t instances;
+    double bytes_per_instance;  // States plus the pages and displays they own
+    double frame_ns;            // One frame of one instance, open() and close() included
+};
+
+// Round robin over a big Chip8CompactPool, a frame per instance per round
+static CompactCost measure_compact(const Workload &workload, QuirkProfile quirks, uint32_t ipf)
+{
+    const int rounds = 3;
+    CompactCost cost;
+    cost.instances = 100000;
+    Chip8CompactPool pool(cost.instances, quirks);
+    pool.cycles_per_frame = ipf;
+    pool.load(workload.image.data(), workload.image.size());
+
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (size_t i = 0; i < cost.instances; ++i)
+            pool.run_frame(i);
+    cost.frame_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / (rounds * cost.instances);
+    cost.bytes_per_instance = static_cast<double>(pool.instance_bytes()) / cost.instances;
+    return cost;
+}
+
+struct DisplayCost
+{
+    double lores_ns;    // 64x32 frame to 128x64 pixels
+    double hires_ns;    // 128x64 frame to 128x64 pixels
+    double scalar_ns;   // 128x64 through chip8_expand_bits_scalar()
+};
+
+// Cost of converting a whole random frame, every row changed
+static DisplayCost measure_display()
+{
+    const int conversions = 20000;
+    DisplayCost cost;
+    Chip8Frame frame = {};
+    uint64_t seed = 1;
+    auto noise = [&seed] { return seed = seed * 6364136223846793005ull + 1442695040888963407ull; };
+    for (auto &row : frame.graphics)
+        row = noise();
+    for (auto &row : frame.graphics_extended)
+        for (auto &half : row)
+            half = noise();
+
+    Chip8PixelBuffer buffer;
+    int first, count;
+    double* targets[2] = {&cost.lores_ns, &cost.hires_ns};
+    for (int extended = 0; extended < 2; ++extended)
+    {
+        frame.extended = extended != 0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < conversions; ++i)
+        {
+            buffer.invalidate();
+            buffer.convert(frame, first, count);
+        }
+        *targets[extended] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / conversions;
+    }
+
+    vector<uint32_t> pixels(128 * 64);
+    Chip8Palette palette = {0x000000FF, 0xFFFFFFFF};
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < conversions; ++i)
+    {
+        for (int y = 0; y < 64; ++y)
+        {
+            chip8_expand_bits_scalar(frame.graphics_extended[y][0], palette, 1, &pixels[y * 128]);
+            chip8_expand_bits_scalar(frame.graphics_extended[y][1], palette, 1, &pixels[y * 128 + 64]);
+        }
+        asm volatile("" : : "r"(pixels.data()) : "memory");
+    }
+    cost.scalar_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / conversions;
+    return cost;
+}
+
+int main(int argc, char* argv[])
+{
+    bool use_jit = false;
+    bool json = false;
+    uint64_t frames = 100000;
+    uint32_t ipf = 100;
+    int repeat = 3;
+    QuirkProfile quirks = QuirkProfile::Original;
+    vector<Workload> workloads = synthetic_workloads();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--jit") == 0)
+            use_jit = true;
+        else if (strcmp(argv[i], "--json") == 0)
+            json = true;
+        else if (strcmp(argv[i], "--quirks") == 0 && i + 1 < argc)
+        {
+            if (!parse_quirk_profile(argv[++i], quirks))
+            {
+                cerr << "Unknown quirk profile: " << argv[i] << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--ipf") == 0 && i + 1 < argc)
+            ipf = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = atoi(argv[++i]);
+        else
+        {
+            Workload rom;
+            if (!load_workload_file(argv[i], rom))
+            {
+                cerr << "Could not open ROM: " << argv[i] << endl;
+                return EXIT_FAILURE;
+            }
+            workloads.push_back(rom);
+        }
+    }
+    if (ipf == 0)
+        ipf = 1;
+    if (repeat < 1)
+        repeat = 1;
+
+    vector<Result> results;
+    for (auto &w : workloads)
+        results.push_back(run_workload(w, use_jit, quirks, frames, ipf, repeat));
+
+    const Workload &compact_workload = find_workload(workloads, "memory");
+    ResetCost reset = measure_resets(find_workload(workloads, "alu"), quirks);
+    DisplayCost display = measure_display();
+    CompactCost compact = measure_compact(compact_workload, quirks, ipf);
+
+    const char* engine = use_jit ? "jit" : "interpreter";
+    const char* profile = quirk_profile_name(quirks);
+    if (json)
+    {
+        printf("{\"engine\": \"%s\", \"quirks\": \"%s\", \"frames\": %llu, \"instructions_per_frame\": %u, \"results\": [\n",
+               engine, profile, static_cast<unsigned long long>(frames), ipf);
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result &r = results[i];
+            printf("  {\"name\": \"%s\", \"instructions\": %llu, \"waited\": %llu, \"frames\": %llu, \"seconds\": %.6f, ",
+                   json_escape(r.name).c_str(), static_cast<unsigned long long>(r.instructions),
+                   static_cast<unsigned long long>(r.waited), static_cast<unsigned long long>(r.frames), r.seconds);
+            if (r.waited)
+                printf("\"mips\": null, \"ns_per_instruction\": null, ");
+            else
+                printf("\"mips\": %.3f, \"ns_per_instruction\": %.3f, ", r.instructions / r.seconds / 1e6,
+                       r.seconds * 1e9 / r.instructions);
+            printf("\"fps\": %.1f, \"stop\": \"%s\"}%s\n", r.frames / r.seconds, r.stop.c_str(),
+                   i + 1 < results.size() ? "," : "");
+        }
+        printf("], \"reset_ns\": {\"init\": %.1f, \"arena\": %.1f}, \"display_ns\": {\"lores\": %.1f, \"hires\": %.1f, \"scalar\": %.1f}, "
+               "\"compact\": {\"instances\": %zu, \"bytes_per_instance\": %.1f, \"frame_ns\": %.1f}}\n",
+               reset.init_ns, reset.arena_ns, display.lores_ns, display.hires_ns, display.scalar_ns,
+               compact.instances, compact.bytes_per_instance, compact.frame_ns);
+        return EXIT_SUCCESS;
+    }
+
+    printf("Engine: %s, %s quirks, %llu frames of %u instructions, best of %d\n\n",
+           engine, profile, static_cast<unsigned long long>(frames), ipf, repeat);
+    printf("%-20s %14s %10s %12s %14s  %s\n", "workload", "instructions", "MIPS", "ns/instr", "frames/s", "stop");
+    for (auto &r : results)
+    {
+        if (r.waited)
+            printf("%-20s %14llu %10s %12s %14.0f  %s\n", r.name.c_str(),
+                   static_cast<unsigned long long>(r.instructions), "-", "-", r.frames / r.seconds, r.stop.c_str());
+        else
+            printf("%-20s %14llu %10.1f %12.2f %14.0f  %s\n", r.name.c_str(),
+                   static_cast<unsigned long long>(r.instructions), r.instructions / r.seconds / 1e6,
+                   r.seconds * 1e9 / r.instructions, r.frames / r.seconds, r.stop.c_str());
+    }
+    printf("\nReset: init + loadROM %.1f ns, arena %.1f ns\n", reset.init_ns, reset.arena_ns);
+    printf("Display to pixels: 64x32 %.1f ns, 128x64 %.1f ns, 128x64 scalar %.1f ns\n",
+           display.lores_ns, display.hires_ns, display.scalar_ns);
+    printf("Compact pool: %zu instances of %s, %.0f bytes each (a Chip8 is %zu), %.1f ns per instance frame\n",
+           compact.instances, compact_workload.name.c_str(), compact.bytes_per_instance, sizeof(Chip8), compact.frame_ns);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+// Generated by recompile from build/check/original_00.ch8 with original quirks, don't edit.
+// 6 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_original_00_blocks {
+
+typedef OriginalQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xF1, 0x65, 0xF0, 0x07, 0xF4, 0x55, 0xFE, 0x55, 0xF8, 0x07, 0x00, 0xEE,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0xF165, 0x165, 0x1, 0x6, 0x5, 0x65};
+static const Chip8::DecodedOp op_204 = {nullptr, 0xF455, 0x455, 0x4, 0x5, 0x5, 0x55};
+static const Chip8::DecodedOp op_206 = {nullptr, 0xFE55, 0xE55, 0xE, 0x5, 0x5, 0x55};
+static const Chip8::DecodedOp op_20A = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F165  LD V1, [I]
+    Chip8::op_FX65<Q>(c, op_200);
+    // 202  F007  LD V0, DT
+    v[0x0] = c.delay_timer;
+    // 204  F455  LD [I], V4
+    Chip8::op_FX55<Q>(c, op_204);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x206;
+        c.current_opcode = 0xF455;
+        c.advance_cycles(3);
+        return 3;
+    }
+    // 206  FE55  LD [I], VE
+    Chip8::op_FX55<Q>(c, op_206);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x208;
+        c.current_opcode = 0xFE55;
+        c.advance_cycles(4);
+        return 4;
+    }
+    // 208  F807  LD V8, DT
+    v[0x8] = c.delay_timer;
+    // 20A  00EE  RET
+    c.program_counter = 0x20A;
+    Chip8::op_00EE(c, op_20A);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(6);
+    return 6;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x20C, 6, 5},
+};
+
+} // namespace check_original_00_blocks
+
+static const Chip8AotProgram check_original_00 = {
+    QuirkProfile::Original, check_original_00_blocks::blocks, sizeof(check_original_00_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_original_00_blocks::image, 0x200, 0x20C, check_original_00_blocks::code_pages
+};
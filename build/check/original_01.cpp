@@ -0,0 +1,91 @@
+// Generated by recompile from build/check/original_01.ch8 with original quirks, don't edit.
+// 7 reached instructions, 5 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_original_01_blocks {
+
+typedef OriginalQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xC5, 0x86, 0x88, 0xF0, 0x00, 0xE0, 0x12, 0x0C, 0xF3, 0x07, 0x00, 0xC3, 0x46, 0x00, 0x12, 0x04,
+    0x00, 0xEE,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  C586  RND V5, 0x86
+    v[0x5] = static_cast<uint8_t>(c.next_random() & 0x86);
+    // 202  88F0  LD V8, VF
+    v[0x8] = v[0xF];
+    c.program_counter = 0x204;
+    c.current_opcode = 0x88F0;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8::DecodedOp op_204 = {nullptr, 0x00E0, 0x0E0, 0x0, 0xE, 0x0, 0xE0};
+
+static uint32_t block_204(Chip8 &c)
+{
+    // 204  00E0  CLS
+    if (c.extendedScreenMode) Chip8::op_00E0<true>(c, op_204); else Chip8::op_00E0<false>(c, op_204);
+    // 206  120C  JP 0x20C
+    c.program_counter = 0x20C;
+    c.current_opcode = 0x120C;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_20C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20C  4600  SNE V6, 0x00
+    c.program_counter = v[0x6] != 0x00 ? 0x210 : 0x20E;
+    c.current_opcode = 0x4600;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20E(Chip8 &c)
+{
+    // 20E  1204  JP 0x204
+    c.program_counter = 0x204;
+    c.current_opcode = 0x1204;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_210 = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_210(Chip8 &c)
+{
+    // 210  00EE  RET
+    c.program_counter = 0x210;
+    Chip8::op_00EE(c, op_210);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x204, 2, 0},
+    {&block_204, 0x204, 0x208, 2, 0},
+    {&block_20C, 0x20C, 0x20E, 1, 0},
+    {&block_20E, 0x20E, 0x210, 1, 0},
+    {&block_210, 0x210, 0x212, 1, 0},
+};
+
+} // namespace check_original_01_blocks
+
+static const Chip8AotProgram check_original_01 = {
+    QuirkProfile::Original, check_original_01_blocks::blocks, sizeof(check_original_01_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_original_01_blocks::image, 0x200, 0x212, check_original_01_blocks::code_pages
+};
@@ -0,0 +1,164 @@
+// Generated by recompile from build/check/original_03.ch8 with original quirks, don't edit.
+// 17 reached instructions, 9 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_original_03_blocks {
+
+typedef OriginalQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x00, 0xFB, 0x8B, 0x34, 0xFB, 0x07, 0x22, 0x10, 0xF4, 0x07, 0x22, 0x0A, 0x7F, 0x65, 0x3A, 0x02,
+    0x70, 0x08, 0x88, 0x24, 0xF9, 0x55, 0x84, 0x92, 0x93, 0x80, 0x65, 0x96, 0x55, 0xE0, 0xF3, 0x75,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0x00FB, 0x0FB, 0x0, 0xF, 0xB, 0xFB};
+static const Chip8::DecodedOp op_206 = {nullptr, 0x2210, 0x210, 0x2, 0x1, 0x0, 0x10};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  00FB  SCR
+    if (c.extendedScreenMode) Chip8::op_00FB<true>(c, op_200); else Chip8::op_00FB<false>(c, op_200);
+    // 202  8B34  ADD VB, V3
+    { unsigned sum = v[0xB] + v[0x3]; v[0xB] = static_cast<uint8_t>(sum); v[0xF] = sum > 255u; }
+    // 204  FB07  LD VB, DT
+    v[0xB] = c.delay_timer;
+    // 206  2210  CALL 0x210
+    c.program_counter = 0x206;
+    Chip8::op_2NNN(c, op_206);
+    c.current_opcode = 0x2210;
+    c.advance_cycles(4);
+    return 4;
+}
+
+
+static uint32_t block_208(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 208  F407  LD V4, DT
+    v[0x4] = c.delay_timer;
+    c.program_counter = 0x20A;
+    c.current_opcode = 0xF407;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20A = {nullptr, 0x220A, 0x20A, 0x2, 0x0, 0xA, 0x0A};
+
+static uint32_t block_20A(Chip8 &c)
+{
+    // 20A  220A  CALL 0x20A
+    c.program_counter = 0x20A;
+    Chip8::op_2NNN(c, op_20A);
+    c.current_opcode = 0x220A;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20C  7F65  ADD VF, 0x65
+    v[0xF] += 0x65;
+    // 20E  3A02  SE VA, 0x02
+    c.program_counter = v[0xA] == 0x02 ? 0x212 : 0x210;
+    c.current_opcode = 0x3A02;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_210(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 210  7008  ADD V0, 0x08
+    v[0x0] += 0x08;
+    c.program_counter = 0x212;
+    c.current_opcode = 0x7008;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_214 = {nullptr, 0xF955, 0x955, 0x9, 0x5, 0x5, 0x55};
+
+static uint32_t block_212(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 212  8824  ADD V8, V2
+    { unsigned sum = v[0x8] + v[0x2]; v[0x8] = static_cast<uint8_t>(sum); v[0xF] = sum > 255u; }
+    // 214  F955  LD [I], V9
+    Chip8::op_FX55<Q>(c, op_214);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x216;
+        c.current_opcode = 0xF955;
+        c.advance_cycles(2);
+        return 2;
+    }
+    // 216  8492  AND V4, V9
+    v[0x4] &= v[0x9];
+    // 218  9380  SNE V3, V8
+    c.program_counter = v[0x3] != v[0x8] ? 0x21C : 0x21A;
+    c.current_opcode = 0x9380;
+    c.advance_cycles(4);
+    return 4;
+}
+
+
+static uint32_t block_21A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 21A  6596  LD V5, 0x96
+    v[0x5] = 0x96;
+    c.program_counter = 0x21C;
+    c.current_opcode = 0x6596;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_21C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 21C  55E0  SE V5, VE
+    c.program_counter = v[0x5] == v[0xE] ? 0x220 : 0x21E;
+    c.current_opcode = 0x55E0;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_21E = {nullptr, 0xF375, 0x375, 0x3, 0x7, 0x5, 0x75};
+
+static uint32_t block_21E(Chip8 &c)
+{
+    // 21E  F375  LD R, V3
+    Chip8::op_FX75(c, op_21E);
+    c.program_counter = 0x220;
+    c.current_opcode = 0xF375;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x208, 4, 3},
+    {&block_208, 0x208, 0x20A, 1, 1},
+    {&block_20A, 0x20A, 0x20C, 1, 0},
+    {&block_20C, 0x20C, 0x210, 2, 0},
+    {&block_210, 0x210, 0x212, 1, 0},
+    {&block_212, 0x212, 0x21A, 4, 0},
+    {&block_21A, 0x21A, 0x21C, 1, 0},
+    {&block_21C, 0x21C, 0x21E, 1, 0},
+    {&block_21E, 0x21E, 0x220, 1, 0},
+};
+
+} // namespace check_original_03_blocks
+
+static const Chip8AotProgram check_original_03 = {
+    QuirkProfile::Original, check_original_03_blocks::blocks, sizeof(check_original_03_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_original_03_blocks::image, 0x200, 0x220, check_original_03_blocks::code_pages
+};
@@ -0,0 +1,106 @@
+// Generated by recompile from build/check/original_04.ch8 with original quirks, don't edit.
+// 9 reached instructions, 6 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_original_04_blocks {
+
+typedef OriginalQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x22, 0x1A, 0x70, 0xF2, 0x9E, 0x60, 0x00, 0xFB, 0x12, 0x06, 0x22, 0x14, 0x7B, 0x13, 0xF4, 0x18,
+    0x8A, 0x93, 0x6E, 0xAD, 0x12, 0x06, 0xA2, 0x06, 0x84, 0x40, 0x64, 0x8C, 0x12, 0x16,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0x221A, 0x21A, 0x2, 0x1, 0xA, 0x1A};
+
+static uint32_t block_200(Chip8 &c)
+{
+    // 200  221A  CALL 0x21A
+    c.program_counter = 0x200;
+    Chip8::op_2NNN(c, op_200);
+    c.current_opcode = 0x221A;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_202(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 202  70F2  ADD V0, 0xF2
+    v[0x0] += 0xF2;
+    // 204  9E60  SNE VE, V6
+    c.program_counter = v[0xE] != v[0x6] ? 0x208 : 0x206;
+    c.current_opcode = 0x9E60;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8::DecodedOp op_206 = {nullptr, 0x00FB, 0x0FB, 0x0, 0xF, 0xB, 0xFB};
+
+static uint32_t block_206(Chip8 &c)
+{
+    // 206  00FB  SCR
+    if (c.extendedScreenMode) Chip8::op_00FB<true>(c, op_206); else Chip8::op_00FB<false>(c, op_206);
+    c.program_counter = 0x208;
+    c.current_opcode = 0x00FB;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_208(Chip8 &c)
+{
+    // 208  1206  JP 0x206
+    c.program_counter = 0x206;
+    c.current_opcode = 0x1206;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_216(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 216  A206  LD I, 0x206
+    c.index = 0x206;
+    // 218  8440  LD V4, V4
+    v[0x4] = v[0x4];
+    c.program_counter = 0x21A;
+    c.current_opcode = 0x8440;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_21A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 21A  648C  LD V4, 0x8C
+    v[0x4] = 0x8C;
+    // 21C  1216  JP 0x216
+    c.program_counter = 0x216;
+    c.current_opcode = 0x1216;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+    {&block_202, 0x202, 0x206, 2, 0},
+    {&block_206, 0x206, 0x208, 1, 0},
+    {&block_208, 0x208, 0x20A, 1, 0},
+    {&block_216, 0x216, 0x21A, 2, 0},
+    {&block_21A, 0x21A, 0x21E, 2, 0},
+};
+
+} // namespace check_original_04_blocks
+
+static const Chip8AotProgram check_original_04 = {
+    QuirkProfile::Original, check_original_04_blocks::blocks, sizeof(check_original_04_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_original_04_blocks::image, 0x200, 0x21E, check_original_04_blocks::code_pages
+};
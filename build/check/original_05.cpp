@@ -0,0 +1,46 @@
+// Generated by recompile from build/check/original_05.ch8 with original quirks, don't edit.
+// 4 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_original_05_blocks {
+
+typedef OriginalQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xD0, 0x37, 0xFA, 0x18, 0x88, 0x03, 0x00, 0xEE,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0xD037, 0x037, 0x0, 0x3, 0x7, 0x37};
+static const Chip8::DecodedOp op_206 = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  D037  DRW V0, V3, 7
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_200); else Chip8::op_DXYN<false, Q>(c, op_200);
+    // 202  FA18  LD ST, VA
+    c.sound_timer = v[0xA];
+    // 204  8803  XOR V8, V0
+    v[0x8] ^= v[0x0];
+    // 206  00EE  RET
+    c.program_counter = 0x206;
+    Chip8::op_00EE(c, op_206);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(4);
+    return 4;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x208, 4, 2},
+};
+
+} // namespace check_original_05_blocks
+
+static const Chip8AotProgram check_original_05 = {
+    QuirkProfile::Original, check_original_05_blocks::blocks, sizeof(check_original_05_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_original_05_blocks::image, 0x200, 0x208, check_original_05_blocks::code_pages
+};
@@ -0,0 +1,52 @@
+// Generated by recompile from build/check/original_06.ch8 with original quirks, don't edit.
+// 3 reached instructions, 2 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_original_06_blocks {
+
+typedef OriginalQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x22, 0x00, 0xF5, 0x07, 0x12, 0x02,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0x2200, 0x200, 0x2, 0x0, 0x0, 0x00};
+
+static uint32_t block_200(Chip8 &c)
+{
+    // 200  2200  CALL 0x200
+    c.program_counter = 0x200;
+    Chip8::op_2NNN(c, op_200);
+    c.current_opcode = 0x2200;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_202(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 202  F507  LD V5, DT
+    v[0x5] = c.delay_timer;
+    // 204  1202  JP 0x202
+    c.program_counter = 0x202;
+    c.current_opcode = 0x1202;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+    {&block_202, 0x202, 0x206, 2, 1},
+};
+
+} // namespace check_original_06_blocks
+
+static const Chip8AotProgram check_original_06 = {
+    QuirkProfile::Original, check_original_06_blocks::blocks, sizeof(check_original_06_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_original_06_blocks::image, 0x200, 0x206, check_original_06_blocks::code_pages
+};
@@ -0,0 +1,121 @@
+// Generated by recompile from build/check/original_07.ch8 with original quirks, don't edit.
+// 17 reached instructions, 6 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_original_07_blocks {
+
+typedef OriginalQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x97, 0xA0, 0xF0, 0x07, 0x78, 0x9C, 0x41, 0x01, 0x82, 0x36, 0xF9, 0x29, 0xA2, 0x1C, 0x00, 0xFB,
+    0x7F, 0xC5, 0xFD, 0x07, 0xF6, 0x0A, 0x8C, 0xE5, 0xC1, 0xCA, 0xF1, 0x15, 0xF8, 0x15, 0x7A, 0x21,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  97A0  SNE V7, VA
+    c.program_counter = v[0x7] != v[0xA] ? 0x204 : 0x202;
+    c.current_opcode = 0x97A0;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_202(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 202  F007  LD V0, DT
+    v[0x0] = c.delay_timer;
+    c.program_counter = 0x204;
+    c.current_opcode = 0xF007;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_204(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 204  789C  ADD V8, 0x9C
+    v[0x8] += 0x9C;
+    // 206  4101  SNE V1, 0x01
+    c.program_counter = v[0x1] != 0x01 ? 0x20A : 0x208;
+    c.current_opcode = 0x4101;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_208(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 208  8236  SHR V2, V3
+    { uint8_t s = v[0x2]; v[0x2] = s >> 1; v[0xF] = s & 1; }
+    c.program_counter = 0x20A;
+    c.current_opcode = 0x8236;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20E = {nullptr, 0x00FB, 0x0FB, 0x0, 0xF, 0xB, 0xFB};
+
+static uint32_t block_20A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20A  F929  LD F, V9
+    c.index = static_cast<uint16_t>(chip8_font_address + (v[0x9] & 0xF) * 5);
+    // 20C  A21C  LD I, 0x21C
+    c.index = 0x21C;
+    // 20E  00FB  SCR
+    if (c.extendedScreenMode) Chip8::op_00FB<true>(c, op_20E); else Chip8::op_00FB<false>(c, op_20E);
+    // 210  7FC5  ADD VF, 0xC5
+    v[0xF] += 0xC5;
+    // 212  FD07  LD VD, DT
+    v[0xD] = c.delay_timer;
+    c.program_counter = 0x214;
+    c.current_opcode = 0xFD07;
+    c.advance_cycles(5);
+    return 5;
+}
+
+
+static uint32_t block_216(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 216  8CE5  SUB VC, VE
+    { uint8_t flag = v[0xC] >= v[0xE]; v[0xC] -= v[0xE]; v[0xF] = flag; }
+    // 218  C1CA  RND V1, 0xCA
+    v[0x1] = static_cast<uint8_t>(c.next_random() & 0xCA);
+    // 21A  F115  LD DT, V1
+    c.delay_timer = v[0x1];
+    // 21C  F815  LD DT, V8
+    c.delay_timer = v[0x8];
+    // 21E  7A21  ADD VA, 0x21
+    v[0xA] += 0x21;
+    c.program_counter = 0x220;
+    c.current_opcode = 0x7A21;
+    c.advance_cycles(5);
+    return 5;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+    {&block_202, 0x202, 0x204, 1, 1},
+    {&block_204, 0x204, 0x208, 2, 0},
+    {&block_208, 0x208, 0x20A, 1, 0},
+    {&block_20A, 0x20A, 0x214, 5, 5},
+    {&block_216, 0x216, 0x220, 5, 4},
+};
+
+} // namespace check_original_07_blocks
+
+static const Chip8AotProgram check_original_07 = {
+    QuirkProfile::Original, check_original_07_blocks::blocks, sizeof(check_original_07_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_original_07_blocks::image, 0x200, 0x220, check_original_07_blocks::code_pages
+};
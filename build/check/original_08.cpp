@@ -0,0 +1,24 @@
+// Generated by recompile from build/check/original_08.ch8 with original quirks, don't edit.
+// 1 reached instructions, 0 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_original_08_blocks {
+
+typedef OriginalQuirks Q;
+static const uint64_t code_pages = 0x0000000000000000ull;
+
+static const uint8_t image[] = {
+};
+
+static const Chip8AotBlock blocks[] = {
+};
+
+} // namespace check_original_08_blocks
+
+static const Chip8AotProgram check_original_08 = {
+    QuirkProfile::Original, check_original_08_blocks::blocks, sizeof(check_original_08_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_original_08_blocks::image, 0x000, 0x000, check_original_08_blocks::code_pages
+};
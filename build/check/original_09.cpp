@@ -0,0 +1,118 @@
+// Generated by recompile from build/check/original_09.ch8 with original quirks, don't edit.
+// 10 reached instructions, 6 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_original_09_blocks {
+
+typedef OriginalQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xF6, 0x1E, 0x00, 0xE0, 0x22, 0x1C, 0x3E, 0x00, 0xF5, 0x1E, 0xF6, 0x55, 0x00, 0xEE, 0x4D, 0x00,
+    0x9F, 0xB0, 0x7E, 0xA4, 0xED, 0xA1, 0x8B, 0x84, 0x6F, 0x3D, 0xFD, 0x07, 0x5D, 0x20, 0x00, 0xEE,
+};
+
+static const Chip8::DecodedOp op_202 = {nullptr, 0x00E0, 0x0E0, 0x0, 0xE, 0x0, 0xE0};
+static const Chip8::DecodedOp op_204 = {nullptr, 0x221C, 0x21C, 0x2, 0x1, 0xC, 0x1C};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F61E  ADD I, V6
+    c.index = static_cast<uint16_t>((c.index + v[0x6]) & 0xFFF);
+    // 202  00E0  CLS
+    if (c.extendedScreenMode) Chip8::op_00E0<true>(c, op_202); else Chip8::op_00E0<false>(c, op_202);
+    // 204  221C  CALL 0x21C
+    c.program_counter = 0x204;
+    Chip8::op_2NNN(c, op_204);
+    c.current_opcode = 0x221C;
+    c.advance_cycles(3);
+    return 3;
+}
+
+
+static uint32_t block_206(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 206  3E00  SE VE, 0x00
+    c.program_counter = v[0xE] == 0x00 ? 0x20A : 0x208;
+    c.current_opcode = 0x3E00;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_208(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 208  F51E  ADD I, V5
+    c.index = static_cast<uint16_t>((c.index + v[0x5]) & 0xFFF);
+    c.program_counter = 0x20A;
+    c.current_opcode = 0xF51E;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20A = {nullptr, 0xF655, 0x655, 0x6, 0x5, 0x5, 0x55};
+static const Chip8::DecodedOp op_20C = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_20A(Chip8 &c)
+{
+    // 20A  F655  LD [I], V6
+    Chip8::op_FX55<Q>(c, op_20A);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x20C;
+        c.current_opcode = 0xF655;
+        c.advance_cycles(1);
+        return 1;
+    }
+    // 20C  00EE  RET
+    c.program_counter = 0x20C;
+    Chip8::op_00EE(c, op_20C);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_21C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 21C  5D20  SE VD, V2
+    c.program_counter = v[0xD] == v[0x2] ? 0x220 : 0x21E;
+    c.current_opcode = 0x5D20;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_21E = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_21E(Chip8 &c)
+{
+    // 21E  00EE  RET
+    c.program_counter = 0x21E;
+    Chip8::op_00EE(c, op_21E);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x206, 3, 0},
+    {&block_206, 0x206, 0x208, 1, 0},
+    {&block_208, 0x208, 0x20A, 1, 0},
+    {&block_20A, 0x20A, 0x20E, 2, 0},
+    {&block_21C, 0x21C, 0x21E, 1, 0},
+    {&block_21E, 0x21E, 0x220, 1, 0},
+};
+
+} // namespace check_original_09_blocks
+
+static const Chip8AotProgram check_original_09 = {
+    QuirkProfile::Original, check_original_09_blocks::blocks, sizeof(check_original_09_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_original_09_blocks::image, 0x200, 0x220, check_original_09_blocks::code_pages
+};
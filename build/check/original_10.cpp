@@ -0,0 +1,68 @@
+// Generated by recompile from build/check/original_10.ch8 with original quirks, don't edit.
+// 7 reached instructions, 3 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_original_10_blocks {
+
+typedef OriginalQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xFD, 0x07, 0xFC, 0x15, 0x62, 0x10, 0x4D, 0x00, 0xA3, 0x00, 0x61, 0x7E,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  FD07  LD VD, DT
+    v[0xD] = c.delay_timer;
+    // 202  FC15  LD DT, VC
+    c.delay_timer = v[0xC];
+    // 204  6210  LD V2, 0x10
+    v[0x2] = 0x10;
+    // 206  4D00  SNE VD, 0x00
+    c.program_counter = v[0xD] != 0x00 ? 0x20A : 0x208;
+    c.current_opcode = 0x4D00;
+    c.advance_cycles(4);
+    return 4;
+}
+
+
+static uint32_t block_208(Chip8 &c)
+{
+    // 208  A300  LD I, 0x300
+    c.index = 0x300;
+    c.program_counter = 0x20A;
+    c.current_opcode = 0xA300;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20A  617E  LD V1, 0x7E
+    v[0x1] = 0x7E;
+    c.program_counter = 0x20C;
+    c.current_opcode = 0x617E;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x208, 4, 2},
+    {&block_208, 0x208, 0x20A, 1, 0},
+    {&block_20A, 0x20A, 0x20C, 1, 0},
+};
+
+} // namespace check_original_10_blocks
+
+static const Chip8AotProgram check_original_10 = {
+    QuirkProfile::Original, check_original_10_blocks::blocks, sizeof(check_original_10_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_original_10_blocks::image, 0x200, 0x20C, check_original_10_blocks::code_pages
+};
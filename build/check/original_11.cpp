@@ -0,0 +1,107 @@
+// Generated by recompile from build/check/original_11.ch8 with original quirks, don't edit.
+// 11 reached instructions, 6 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_original_11_blocks {
+
+typedef OriginalQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x5B, 0x50, 0x74, 0x46, 0xFF, 0x07, 0x5B, 0x90, 0xA2, 0x06, 0x12, 0x18, 0xFA, 0x07, 0xF8, 0x07,
+    0x38, 0x00, 0x12, 0x0E, 0x65, 0xEF, 0xF2, 0x33, 0xF4, 0x07, 0xCB, 0x96, 0xFF, 0x15, 0x69, 0xA4,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  5B50  SE VB, V5
+    c.program_counter = v[0xB] == v[0x5] ? 0x204 : 0x202;
+    c.current_opcode = 0x5B50;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_202(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 202  7446  ADD V4, 0x46
+    v[0x4] += 0x46;
+    c.program_counter = 0x204;
+    c.current_opcode = 0x7446;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_204(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 204  FF07  LD VF, DT
+    v[0xF] = c.delay_timer;
+    // 206  5B90  SE VB, V9
+    c.program_counter = v[0xB] == v[0x9] ? 0x20A : 0x208;
+    c.current_opcode = 0x5B90;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_208(Chip8 &c)
+{
+    // 208  A206  LD I, 0x206
+    c.index = 0x206;
+    c.program_counter = 0x20A;
+    c.current_opcode = 0xA206;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20A(Chip8 &c)
+{
+    // 20A  1218  JP 0x218
+    c.program_counter = 0x218;
+    c.current_opcode = 0x1218;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_218(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 218  F407  LD V4, DT
+    v[0x4] = c.delay_timer;
+    // 21A  CB96  RND VB, 0x96
+    v[0xB] = static_cast<uint8_t>(c.next_random() & 0x96);
+    // 21C  FF15  LD DT, VF
+    c.delay_timer = v[0xF];
+    // 21E  69A4  LD V9, 0xA4
+    v[0x9] = 0xA4;
+    c.program_counter = 0x220;
+    c.current_opcode = 0x69A4;
+    c.advance_cycles(4);
+    return 4;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+    {&block_202, 0x202, 0x204, 1, 0},
+    {&block_204, 0x204, 0x208, 2, 1},
+    {&block_208, 0x208, 0x20A, 1, 0},
+    {&block_20A, 0x20A, 0x20C, 1, 0},
+    {&block_218, 0x218, 0x220, 4, 3},
+};
+
+} // namespace check_original_11_blocks
+
+static const Chip8AotProgram check_original_11 = {
+    QuirkProfile::Original, check_original_11_blocks::blocks, sizeof(check_original_11_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_original_11_blocks::image, 0x200, 0x220, check_original_11_blocks::code_pages
+};
@@ -0,0 +1,101 @@
+// Generated by check --generate, don't edit.
+
+#include "original_00.cpp"
+#include "original_01.cpp"
+#include "original_02.cpp"
+#include "original_03.cpp"
+#include "original_04.cpp"
+#include "original_05.cpp"
+#include "original_06.cpp"
+#include "original_07.cpp"
+#include "original_08.cpp"
+#include "original_09.cpp"
+#include "original_10.cpp"
+#include "original_11.cpp"
+#include "vip_00.cpp"
+#include "vip_01.cpp"
+#include "vip_02.cpp"
+#include "vip_03.cpp"
+#include "vip_04.cpp"
+#include "vip_05.cpp"
+#include "vip_06.cpp"
+#include "vip_07.cpp"
+#include "vip_08.cpp"
+#include "vip_09.cpp"
+#include "vip_10.cpp"
+#include "vip_11.cpp"
+#include "schip_00.cpp"
+#include "schip_01.cpp"
+#include "schip_02.cpp"
+#include "schip_03.cpp"
+#include "schip_04.cpp"
+#include "schip_05.cpp"
+#include "schip_06.cpp"
+#include "schip_07.cpp"
+#include "schip_08.cpp"
+#include "schip_09.cpp"
+#include "schip_10.cpp"
+#include "schip_11.cpp"
+#include "xochip_00.cpp"
+#include "xochip_01.cpp"
+#include "xochip_02.cpp"
+#include "xochip_03.cpp"
+#include "xochip_04.cpp"
+#include "xochip_05.cpp"
+#include "xochip_06.cpp"
+#include "xochip_07.cpp"
+#include "xochip_08.cpp"
+#include "xochip_09.cpp"
+#include "xochip_10.cpp"
+#include "xochip_11.cpp"
+
+static const Chip8CheckProgram check_programs[] = {
+    {"build/check/original_00.ch8", &check_original_00},
+    {"build/check/original_01.ch8", &check_original_01},
+    {"build/check/original_02.ch8", &check_original_02},
+    {"build/check/original_03.ch8", &check_original_03},
+    {"build/check/original_04.ch8", &check_original_04},
+    {"build/check/original_05.ch8", &check_original_05},
+    {"build/check/original_06.ch8", &check_original_06},
+    {"build/check/original_07.ch8", &check_original_07},
+    {"build/check/original_08.ch8", &check_original_08},
+    {"build/check/original_09.ch8", &check_original_09},
+    {"build/check/original_10.ch8", &check_original_10},
+    {"build/check/original_11.ch8", &check_original_11},
+    {"build/check/vip_00.ch8", &check_vip_00},
+    {"build/check/vip_01.ch8", &check_vip_01},
+    {"build/check/vip_02.ch8", &check_vip_02},
+    {"build/check/vip_03.ch8", &check_vip_03},
+    {"build/check/vip_04.ch8", &check_vip_04},
+    {"build/check/vip_05.ch8", &check_vip_05},
+    {"build/check/vip_06.ch8", &check_vip_06},
+    {"build/check/vip_07.ch8", &check_vip_07},
+    {"build/check/vip_08.ch8", &check_vip_08},
+    {"build/check/vip_09.ch8", &check_vip_09},
+    {"build/check/vip_10.ch8", &check_vip_10},
+    {"build/check/vip_11.ch8", &check_vip_11},
+    {"build/check/schip_00.ch8", &check_schip_00},
+    {"build/check/schip_01.ch8", &check_schip_01},
+    {"build/check/schip_02.ch8", &check_schip_02},
+    {"build/check/schip_03.ch8", &check_schip_03},
+    {"build/check/schip_04.ch8", &check_schip_04},
+    {"build/check/schip_05.ch8", &check_schip_05},
+    {"build/check/schip_06.ch8", &check_schip_06},
+    {"build/check/schip_07.ch8", &check_schip_07},
+    {"build/check/schip_08.ch8", &check_schip_08},
+    {"build/check/schip_09.ch8", &check_schip_09},
+    {"build/check/schip_10.ch8", &check_schip_10},
+    {"build/check/schip_11.ch8", &check_schip_11},
+    {"build/check/xochip_00.ch8", &check_xochip_00},
+    {"build/check/xochip_01.ch8", &check_xochip_01},
+    {"build/check/xochip_02.ch8", &check_xochip_02},
+    {"build/check/xochip_03.ch8", &check_xochip_03},
+    {"build/check/xochip_04.ch8", &check_xochip_04},
+    {"build/check/xochip_05.ch8", &check_xochip_05},
+    {"build/check/xochip_06.ch8", &check_xochip_06},
+    {"build/check/xochip_07.ch8", &check_xochip_07},
+    {"build/check/xochip_08.ch8", &check_xochip_08},
+    {"build/check/xochip_09.ch8", &check_xochip_09},
+    {"build/check/xochip_10.ch8", &check_xochip_10},
+    {"build/check/xochip_11.ch8", &check_xochip_11},
+};
@@ -0,0 +1,144 @@
+// Generated by recompile from build/check/schip_00.ch8 with schip quirks, don't edit.
+// 17 reached instructions, 7 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_00_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x30, 0x02, 0xFA, 0x33, 0xFD, 0x15, 0x12, 0x14, 0xA2, 0x18, 0x73, 0xF9, 0xFE, 0x15, 0xD9, 0xAF,
+    0xF2, 0x55, 0x00, 0xC3, 0x98, 0x40, 0x71, 0x2B, 0xD9, 0xFD, 0xF1, 0x18, 0x79, 0x57, 0x22, 0x08,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  3002  SE V0, 0x02
+    c.program_counter = v[0x0] == 0x02 ? 0x204 : 0x202;
+    c.current_opcode = 0x3002;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_202 = {nullptr, 0xFA33, 0xA33, 0xA, 0x3, 0x3, 0x33};
+
+static uint32_t block_202(Chip8 &c)
+{
+    // 202  FA33  LD B, VA
+    Chip8::op_FX33(c, op_202);
+    c.program_counter = 0x204;
+    c.current_opcode = 0xFA33;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_204(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 204  FD15  LD DT, VD
+    c.delay_timer = v[0xD];
+    // 206  1214  JP 0x214
+    c.program_counter = 0x214;
+    c.current_opcode = 0x1214;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8::DecodedOp op_20E = {nullptr, 0xD9AF, 0x9AF, 0x9, 0xA, 0xF, 0xAF};
+static const Chip8::DecodedOp op_210 = {nullptr, 0xF255, 0x255, 0x2, 0x5, 0x5, 0x55};
+static const Chip8::DecodedOp op_212 = {nullptr, 0x00C3, 0x0C3, 0x0, 0xC, 0x3, 0xC3};
+
+static uint32_t block_208(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 208  A218  LD I, 0x218
+    c.index = 0x218;
+    // 20A  73F9  ADD V3, 0xF9
+    v[0x3] += 0xF9;
+    // 20C  FE15  LD DT, VE
+    c.delay_timer = v[0xE];
+    // 20E  D9AF  DRW V9, VA, 15
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_20E); else Chip8::op_DXYN<false, Q>(c, op_20E);
+    // 210  F255  LD [I], V2
+    Chip8::op_FX55<Q>(c, op_210);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x212;
+        c.current_opcode = 0xF255;
+        c.advance_cycles(5);
+        return 5;
+    }
+    // 212  00C3  SCD 3
+    if (c.extendedScreenMode) Chip8::op_00CN<true>(c, op_212); else Chip8::op_00CN<false>(c, op_212);
+    c.program_counter = 0x214;
+    c.current_opcode = 0x00C3;
+    c.advance_cycles(6);
+    return 6;
+}
+
+
+static uint32_t block_214(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 214  9840  SNE V8, V4
+    c.program_counter = v[0x8] != v[0x4] ? 0x218 : 0x216;
+    c.current_opcode = 0x9840;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_216(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 216  712B  ADD V1, 0x2B
+    v[0x1] += 0x2B;
+    c.program_counter = 0x218;
+    c.current_opcode = 0x712B;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_218 = {nullptr, 0xD9FD, 0x9FD, 0x9, 0xF, 0xD, 0xFD};
+static const Chip8::DecodedOp op_21E = {nullptr, 0x2208, 0x208, 0x2, 0x0, 0x8, 0x08};
+
+static uint32_t block_218(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 218  D9FD  DRW V9, VF, 13
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_218); else Chip8::op_DXYN<false, Q>(c, op_218);
+    // 21A  F118  LD ST, V1
+    c.sound_timer = v[0x1];
+    // 21C  7957  ADD V9, 0x57
+    v[0x9] += 0x57;
+    // 21E  2208  CALL 0x208
+    c.program_counter = 0x21E;
+    Chip8::op_2NNN(c, op_21E);
+    c.current_opcode = 0x2208;
+    c.advance_cycles(4);
+    return 4;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+    {&block_202, 0x202, 0x204, 1, 0},
+    {&block_204, 0x204, 0x208, 2, 1},
+    {&block_208, 0x208, 0x214, 6, 3},
+    {&block_214, 0x214, 0x216, 1, 0},
+    {&block_216, 0x216, 0x218, 1, 0},
+    {&block_218, 0x218, 0x220, 4, 2},
+};
+
+} // namespace check_schip_00_blocks
+
+static const Chip8AotProgram check_schip_00 = {
+    QuirkProfile::SuperChip, check_schip_00_blocks::blocks, sizeof(check_schip_00_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_00_blocks::image, 0x200, 0x220, check_schip_00_blocks::code_pages
+};
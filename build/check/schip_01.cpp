@@ -0,0 +1,41 @@
+// Generated by recompile from build/check/schip_01.ch8 with schip quirks, don't edit.
+// 2 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_01_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x00, 0xFF, 0x00, 0xEE,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0x00FF, 0x0FF, 0x0, 0xF, 0xF, 0xFF};
+static const Chip8::DecodedOp op_202 = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_200(Chip8 &c)
+{
+    // 200  00FF  HIGH
+    Chip8::op_00FF(c, op_200);
+    // 202  00EE  RET
+    c.program_counter = 0x202;
+    Chip8::op_00EE(c, op_202);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x204, 2, 0},
+};
+
+} // namespace check_schip_01_blocks
+
+static const Chip8AotProgram check_schip_01 = {
+    QuirkProfile::SuperChip, check_schip_01_blocks::blocks, sizeof(check_schip_01_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_01_blocks::image, 0x200, 0x204, check_schip_01_blocks::code_pages
+};
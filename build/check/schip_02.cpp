@@ -0,0 +1,142 @@
+// Generated by recompile from build/check/schip_02.ch8 with schip quirks, don't edit.
+// 17 reached instructions, 6 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_02_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xFB, 0x33, 0xF7, 0x55, 0x43, 0x01, 0xF9, 0x07, 0x39, 0x00, 0x12, 0x06, 0x3C, 0x01, 0xFC, 0x07,
+    0xF3, 0x15, 0xF7, 0x65, 0xF7, 0x18, 0xFD, 0x15, 0x8F, 0xE2, 0xFE, 0x55, 0x63, 0xE0, 0xF3, 0x18,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0xFB33, 0xB33, 0xB, 0x3, 0x3, 0x33};
+static const Chip8::DecodedOp op_202 = {nullptr, 0xF755, 0x755, 0x7, 0x5, 0x5, 0x55};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  FB33  LD B, VB
+    Chip8::op_FX33(c, op_200);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x202;
+        c.current_opcode = 0xFB33;
+        c.advance_cycles(1);
+        return 1;
+    }
+    // 202  F755  LD [I], V7
+    Chip8::op_FX55<Q>(c, op_202);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x204;
+        c.current_opcode = 0xF755;
+        c.advance_cycles(2);
+        return 2;
+    }
+    // 204  4301  SNE V3, 0x01
+    c.program_counter = v[0x3] != 0x01 ? 0x208 : 0x206;
+    c.current_opcode = 0x4301;
+    c.advance_cycles(3);
+    return 3;
+}
+
+
+static uint32_t block_208(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 208  3900  SE V9, 0x00
+    c.program_counter = v[0x9] == 0x00 ? 0x20C : 0x20A;
+    c.current_opcode = 0x3900;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20A(Chip8 &c)
+{
+    // 20A  1206  JP 0x206
+    c.program_counter = 0x206;
+    c.current_opcode = 0x1206;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20C  3C01  SE VC, 0x01
+    c.program_counter = v[0xC] == 0x01 ? 0x210 : 0x20E;
+    c.current_opcode = 0x3C01;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20E  FC07  LD VC, DT
+    v[0xC] = c.delay_timer;
+    c.program_counter = 0x210;
+    c.current_opcode = 0xFC07;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_212 = {nullptr, 0xF765, 0x765, 0x7, 0x6, 0x5, 0x65};
+static const Chip8::DecodedOp op_21A = {nullptr, 0xFE55, 0xE55, 0xE, 0x5, 0x5, 0x55};
+
+static uint32_t block_210(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 210  F315  LD DT, V3
+    c.delay_timer = v[0x3];
+    // 212  F765  LD V7, [I]
+    Chip8::op_FX65<Q>(c, op_212);
+    // 214  F718  LD ST, V7
+    c.sound_timer = v[0x7];
+    // 216  FD15  LD DT, VD
+    c.delay_timer = v[0xD];
+    // 218  8FE2  AND VF, VE
+    v[0xF] &= v[0xE];
+    // 21A  FE55  LD [I], VE
+    Chip8::op_FX55<Q>(c, op_21A);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x21C;
+        c.current_opcode = 0xFE55;
+        c.advance_cycles(6);
+        return 6;
+    }
+    // 21C  63E0  LD V3, 0xE0
+    v[0x3] = 0xE0;
+    // 21E  F318  LD ST, V3
+    c.sound_timer = v[0x3];
+    c.program_counter = 0x220;
+    c.current_opcode = 0xF318;
+    c.advance_cycles(8);
+    return 8;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x206, 3, 0},
+    {&block_208, 0x208, 0x20A, 1, 0},
+    {&block_20A, 0x20A, 0x20C, 1, 0},
+    {&block_20C, 0x20C, 0x20E, 1, 0},
+    {&block_20E, 0x20E, 0x210, 1, 1},
+    {&block_210, 0x210, 0x220, 8, 8},
+};
+
+} // namespace check_schip_02_blocks
+
+static const Chip8AotProgram check_schip_02 = {
+    QuirkProfile::SuperChip, check_schip_02_blocks::blocks, sizeof(check_schip_02_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_02_blocks::image, 0x200, 0x220, check_schip_02_blocks::code_pages
+};
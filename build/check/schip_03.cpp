@@ -0,0 +1,69 @@
+// Generated by recompile from build/check/schip_03.ch8 with schip quirks, don't edit.
+// 6 reached instructions, 3 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_03_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xC9, 0xA7, 0x79, 0xAB, 0x22, 0x1E, 0xB2, 0x0C, 0xF8, 0x29, 0xF1, 0x18, 0x62, 0x1D, 0x82, 0xFE,
+    0x00, 0xFE, 0x60, 0xFB, 0x4B, 0x00, 0xFF, 0x18, 0x12, 0x14, 0x84, 0x52, 0x6B, 0x8C, 0x8F, 0x73,
+};
+
+static const Chip8::DecodedOp op_204 = {nullptr, 0x221E, 0x21E, 0x2, 0x1, 0xE, 0x1E};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  C9A7  RND V9, 0xA7
+    v[0x9] = static_cast<uint8_t>(c.next_random() & 0xA7);
+    // 202  79AB  ADD V9, 0xAB
+    v[0x9] += 0xAB;
+    // 204  221E  CALL 0x21E
+    c.program_counter = 0x204;
+    Chip8::op_2NNN(c, op_204);
+    c.current_opcode = 0x221E;
+    c.advance_cycles(3);
+    return 3;
+}
+
+
+static uint32_t block_206(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 206  B20C  JP V0, 0x20C
+    c.program_counter = (v[0x2] + 0x20C) & 0xFFF;
+    c.current_opcode = 0xB20C;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_21E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 21E  8F73  XOR VF, V7
+    v[0xF] ^= v[0x7];
+    c.program_counter = 0x220;
+    c.current_opcode = 0x8F73;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x206, 3, 0},
+    {&block_206, 0x206, 0x208, 1, 0},
+    {&block_21E, 0x21E, 0x220, 1, 0},
+};
+
+} // namespace check_schip_03_blocks
+
+static const Chip8AotProgram check_schip_03 = {
+    QuirkProfile::SuperChip, check_schip_03_blocks::blocks, sizeof(check_schip_03_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_03_blocks::image, 0x200, 0x220, check_schip_03_blocks::code_pages
+};
@@ -0,0 +1,50 @@
+// Generated by recompile from build/check/schip_04.ch8 with schip quirks, don't edit.
+// 6 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_04_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xCC, 0xA8, 0x6A, 0x32, 0x70, 0xF4, 0xF9, 0x1E, 0xF3, 0x65, 0x00, 0xEE,
+};
+
+static const Chip8::DecodedOp op_208 = {nullptr, 0xF365, 0x365, 0x3, 0x6, 0x5, 0x65};
+static const Chip8::DecodedOp op_20A = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  CCA8  RND VC, 0xA8
+    v[0xC] = static_cast<uint8_t>(c.next_random() & 0xA8);
+    // 202  6A32  LD VA, 0x32
+    v[0xA] = 0x32;
+    // 204  70F4  ADD V0, 0xF4
+    v[0x0] += 0xF4;
+    // 206  F91E  ADD I, V9
+    c.index = static_cast<uint16_t>((c.index + v[0x9]) & 0xFFF);
+    // 208  F365  LD V3, [I]
+    Chip8::op_FX65<Q>(c, op_208);
+    // 20A  00EE  RET
+    c.program_counter = 0x20A;
+    Chip8::op_00EE(c, op_20A);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(6);
+    return 6;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x20C, 6, 0},
+};
+
+} // namespace check_schip_04_blocks
+
+static const Chip8AotProgram check_schip_04 = {
+    QuirkProfile::SuperChip, check_schip_04_blocks::blocks, sizeof(check_schip_04_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_04_blocks::image, 0x200, 0x20C, check_schip_04_blocks::code_pages
+};
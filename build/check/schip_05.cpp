@@ -0,0 +1,39 @@
+// Generated by recompile from build/check/schip_05.ch8 with schip quirks, don't edit.
+// 2 reached instructions, 1 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_05_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xF6, 0x18, 0xB2, 0x62,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F618  LD ST, V6
+    c.sound_timer = v[0x6];
+    // 202  B262  JP V0, 0x262
+    c.program_counter = (v[0x2] + 0x262) & 0xFFF;
+    c.current_opcode = 0xB262;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x204, 2, 1},
+};
+
+} // namespace check_schip_05_blocks
+
+static const Chip8AotProgram check_schip_05 = {
+    QuirkProfile::SuperChip, check_schip_05_blocks::blocks, sizeof(check_schip_05_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_05_blocks::image, 0x200, 0x204, check_schip_05_blocks::code_pages
+};
@@ -0,0 +1,38 @@
+// Generated by recompile from build/check/schip_06.ch8 with schip quirks, don't edit.
+// 1 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_06_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x00, 0xFD,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0x00FD, 0x0FD, 0x0, 0xF, 0xD, 0xFD};
+
+static uint32_t block_200(Chip8 &c)
+{
+    // 200  00FD  EXIT
+    c.program_counter = 0x200;
+    Chip8::op_00FD(c, op_200);
+    c.current_opcode = 0x00FD;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+};
+
+} // namespace check_schip_06_blocks
+
+static const Chip8AotProgram check_schip_06 = {
+    QuirkProfile::SuperChip, check_schip_06_blocks::blocks, sizeof(check_schip_06_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_06_blocks::image, 0x200, 0x202, check_schip_06_blocks::code_pages
+};
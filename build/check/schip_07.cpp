@@ -0,0 +1,151 @@
+// Generated by recompile from build/check/schip_07.ch8 with schip quirks, don't edit.
+// 17 reached instructions, 8 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_07_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xF1, 0x55, 0x39, 0x02, 0x8B, 0xF7, 0x8C, 0x35, 0x83, 0x72, 0xF4, 0x07, 0x52, 0xF0, 0x57, 0x40,
+    0x63, 0xA4, 0xFC, 0x07, 0x5E, 0x10, 0x00, 0xEE, 0xF1, 0x65, 0x83, 0xC2, 0xCA, 0x04, 0xFD, 0x1E,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0xF155, 0x155, 0x1, 0x5, 0x5, 0x55};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F155  LD [I], V1
+    Chip8::op_FX55<Q>(c, op_200);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x202;
+        c.current_opcode = 0xF155;
+        c.advance_cycles(1);
+        return 1;
+    }
+    // 202  3902  SE V9, 0x02
+    c.program_counter = v[0x9] == 0x02 ? 0x206 : 0x204;
+    c.current_opcode = 0x3902;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_204(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 204  8BF7  SUBN VB, VF
+    { uint8_t flag = v[0xF] >= v[0xB]; v[0xB] = v[0xF] - v[0xB]; v[0xF] = flag; }
+    c.program_counter = 0x206;
+    c.current_opcode = 0x8BF7;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_206(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 206  8C35  SUB VC, V3
+    { uint8_t flag = v[0xC] >= v[0x3]; v[0xC] -= v[0x3]; v[0xF] = flag; }
+    // 208  8372  AND V3, V7
+    v[0x3] &= v[0x7];
+    // 20A  F407  LD V4, DT
+    v[0x4] = c.delay_timer;
+    // 20C  52F0  SE V2, VF
+    c.program_counter = v[0x2] == v[0xF] ? 0x210 : 0x20E;
+    c.current_opcode = 0x52F0;
+    c.advance_cycles(4);
+    return 4;
+}
+
+
+static uint32_t block_20E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20E  5740  SE V7, V4
+    c.program_counter = v[0x7] == v[0x4] ? 0x212 : 0x210;
+    c.current_opcode = 0x5740;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_210(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 210  63A4  LD V3, 0xA4
+    v[0x3] = 0xA4;
+    c.program_counter = 0x212;
+    c.current_opcode = 0x63A4;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_212(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 212  FC07  LD VC, DT
+    v[0xC] = c.delay_timer;
+    // 214  5E10  SE VE, V1
+    c.program_counter = v[0xE] == v[0x1] ? 0x218 : 0x216;
+    c.current_opcode = 0x5E10;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8::DecodedOp op_216 = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_216(Chip8 &c)
+{
+    // 216  00EE  RET
+    c.program_counter = 0x216;
+    Chip8::op_00EE(c, op_216);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_218 = {nullptr, 0xF165, 0x165, 0x1, 0x6, 0x5, 0x65};
+
+static uint32_t block_218(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 218  F165  LD V1, [I]
+    Chip8::op_FX65<Q>(c, op_218);
+    // 21A  83C2  AND V3, VC
+    v[0x3] &= v[0xC];
+    // 21C  CA04  RND VA, 0x04
+    v[0xA] = static_cast<uint8_t>(c.next_random() & 0x04);
+    // 21E  FD1E  ADD I, VD
+    c.index = static_cast<uint16_t>((c.index + v[0xD]) & 0xFFF);
+    c.program_counter = 0x220;
+    c.current_opcode = 0xFD1E;
+    c.advance_cycles(4);
+    return 4;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x204, 2, 0},
+    {&block_204, 0x204, 0x206, 1, 0},
+    {&block_206, 0x206, 0x20E, 4, 3},
+    {&block_20E, 0x20E, 0x210, 1, 0},
+    {&block_210, 0x210, 0x212, 1, 0},
+    {&block_212, 0x212, 0x216, 2, 1},
+    {&block_216, 0x216, 0x218, 1, 0},
+    {&block_218, 0x218, 0x220, 4, 0},
+};
+
+} // namespace check_schip_07_blocks
+
+static const Chip8AotProgram check_schip_07 = {
+    QuirkProfile::SuperChip, check_schip_07_blocks::blocks, sizeof(check_schip_07_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_07_blocks::image, 0x200, 0x220, check_schip_07_blocks::code_pages
+};
@@ -0,0 +1,164 @@
+// Generated by recompile from build/check/schip_08.ch8 with schip quirks, don't edit.
+// 16 reached instructions, 8 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_08_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000300ull;
+
+static const uint8_t image[] = {
+    0x93, 0x90, 0x82, 0xC1, 0xFE, 0x33, 0xFD, 0x07, 0xFB, 0x55, 0xF3, 0x55, 0x00, 0xFB, 0x34, 0x02,
+    0x22, 0x3A, 0x00, 0x00, 0x8E, 0x15, 0x3D, 0x01, 0xF2, 0x15, 0x9C, 0x00, 0xAF, 0x88, 0x12, 0x16,
+    0x80, 0x08, 0x00, 0xFE, 0x7C, 0xF4, 0x00, 0xEE, 0x5F, 0xC0, 0x68, 0xCB, 0xF5, 0x15, 0xFD, 0x07,
+    0x6F, 0x9F, 0x5F, 0x80, 0xF3, 0x85, 0x9D, 0xC0, 0x00, 0xEE, 0x8C, 0x00, 0xFD, 0x07, 0x3D, 0x00,
+    0x12, 0x3C, 0x69, 0x26, 0xB2, 0x02,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  9390  SNE V3, V9
+    c.program_counter = v[0x3] != v[0x9] ? 0x204 : 0x202;
+    c.current_opcode = 0x9390;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_202(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 202  82C1  OR V2, VC
+    v[0x2] |= v[0xC];
+    c.program_counter = 0x204;
+    c.current_opcode = 0x82C1;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_204 = {nullptr, 0xFE33, 0xE33, 0xE, 0x3, 0x3, 0x33};
+static const Chip8::DecodedOp op_208 = {nullptr, 0xFB55, 0xB55, 0xB, 0x5, 0x5, 0x55};
+static const Chip8::DecodedOp op_20A = {nullptr, 0xF355, 0x355, 0x3, 0x5, 0x5, 0x55};
+static const Chip8::DecodedOp op_20C = {nullptr, 0x00FB, 0x0FB, 0x0, 0xF, 0xB, 0xFB};
+
+static uint32_t block_204(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 204  FE33  LD B, VE
+    Chip8::op_FX33(c, op_204);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x206;
+        c.current_opcode = 0xFE33;
+        c.advance_cycles(1);
+        return 1;
+    }
+    // 206  FD07  LD VD, DT
+    v[0xD] = c.delay_timer;
+    // 208  FB55  LD [I], VB
+    Chip8::op_FX55<Q>(c, op_208);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x20A;
+        c.current_opcode = 0xFB55;
+        c.advance_cycles(3);
+        return 3;
+    }
+    // 20A  F355  LD [I], V3
+    Chip8::op_FX55<Q>(c, op_20A);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x20C;
+        c.current_opcode = 0xF355;
+        c.advance_cycles(4);
+        return 4;
+    }
+    // 20C  00FB  SCR
+    if (c.extendedScreenMode) Chip8::op_00FB<true>(c, op_20C); else Chip8::op_00FB<false>(c, op_20C);
+    // 20E  3402  SE V4, 0x02
+    c.program_counter = v[0x4] == 0x02 ? 0x212 : 0x210;
+    c.current_opcode = 0x3402;
+    c.advance_cycles(6);
+    return 6;
+}
+
+static const Chip8::DecodedOp op_210 = {nullptr, 0x223A, 0x23A, 0x2, 0x3, 0xA, 0x3A};
+
+static uint32_t block_210(Chip8 &c)
+{
+    // 210  223A  CALL 0x23A
+    c.program_counter = 0x210;
+    Chip8::op_2NNN(c, op_210);
+    c.current_opcode = 0x223A;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_23A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 23A  8C00  LD VC, V0
+    v[0xC] = v[0x0];
+    c.program_counter = 0x23C;
+    c.current_opcode = 0x8C00;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_23E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 23E  3D00  SE VD, 0x00
+    c.program_counter = v[0xD] == 0x00 ? 0x242 : 0x240;
+    c.current_opcode = 0x3D00;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_240(Chip8 &c)
+{
+    // 240  123C  JP 0x23C
+    c.program_counter = 0x23C;
+    c.current_opcode = 0x123C;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_242(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 242  6926  LD V9, 0x26
+    v[0x9] = 0x26;
+    // 244  B202  JP V0, 0x202
+    c.program_counter = (v[0x2] + 0x202) & 0xFFF;
+    c.current_opcode = 0xB202;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+    {&block_202, 0x202, 0x204, 1, 0},
+    {&block_204, 0x204, 0x210, 6, 2},
+    {&block_210, 0x210, 0x212, 1, 0},
+    {&block_23A, 0x23A, 0x23C, 1, 0},
+    {&block_23E, 0x23E, 0x240, 1, 0},
+    {&block_240, 0x240, 0x242, 1, 0},
+    {&block_242, 0x242, 0x246, 2, 0},
+};
+
+} // namespace check_schip_08_blocks
+
+static const Chip8AotProgram check_schip_08 = {
+    QuirkProfile::SuperChip, check_schip_08_blocks::blocks, sizeof(check_schip_08_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_08_blocks::image, 0x200, 0x246, check_schip_08_blocks::code_pages
+};
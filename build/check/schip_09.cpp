@@ -0,0 +1,41 @@
+// Generated by recompile from build/check/schip_09.ch8 with schip quirks, don't edit.
+// 3 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_09_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x7D, 0x74, 0x80, 0xC4, 0x12, 0x00,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  7D74  ADD VD, 0x74
+    v[0xD] += 0x74;
+    // 202  80C4  ADD V0, VC
+    { unsigned sum = v[0x0] + v[0xC]; v[0x0] = static_cast<uint8_t>(sum); v[0xF] = sum > 255u; }
+    // 204  1200  JP 0x200
+    c.program_counter = 0x200;
+    c.current_opcode = 0x1200;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x206, 3, 0},
+};
+
+} // namespace check_schip_09_blocks
+
+static const Chip8AotProgram check_schip_09 = {
+    QuirkProfile::SuperChip, check_schip_09_blocks::blocks, sizeof(check_schip_09_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_09_blocks::image, 0x200, 0x206, check_schip_09_blocks::code_pages
+};
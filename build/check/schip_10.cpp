@@ -0,0 +1,44 @@
+// Generated by recompile from build/check/schip_10.ch8 with schip quirks, don't edit.
+// 3 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_10_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x8A, 0x44, 0xFC, 0x65, 0x00, 0xEE,
+};
+
+static const Chip8::DecodedOp op_202 = {nullptr, 0xFC65, 0xC65, 0xC, 0x6, 0x5, 0x65};
+static const Chip8::DecodedOp op_204 = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  8A44  ADD VA, V4
+    { unsigned sum = v[0xA] + v[0x4]; v[0xA] = static_cast<uint8_t>(sum); v[0xF] = sum > 255u; }
+    // 202  FC65  LD VC, [I]
+    Chip8::op_FX65<Q>(c, op_202);
+    // 204  00EE  RET
+    c.program_counter = 0x204;
+    Chip8::op_00EE(c, op_204);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x206, 3, 0},
+};
+
+} // namespace check_schip_10_blocks
+
+static const Chip8AotProgram check_schip_10 = {
+    QuirkProfile::SuperChip, check_schip_10_blocks::blocks, sizeof(check_schip_10_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_10_blocks::image, 0x200, 0x206, check_schip_10_blocks::code_pages
+};
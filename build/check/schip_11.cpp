@@ -0,0 +1,145 @@
+// Generated by recompile from build/check/schip_11.ch8 with schip quirks, don't edit.
+// 17 reached instructions, 5 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_schip_11_blocks {
+
+typedef SuperChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000300ull;
+
+static const uint8_t image[] = {
+    0xF8, 0x65, 0xFE, 0x1E, 0xF1, 0x07, 0x3E, 0x00, 0x81, 0xF3, 0xF6, 0x33, 0x8E, 0x9E, 0x22, 0x34,
+    0xCD, 0x82, 0x00, 0xEE, 0xFE, 0x15, 0xA3, 0x00, 0xF7, 0x1E, 0xF1, 0x29, 0x6E, 0xEE, 0x86, 0x0E,
+    0x80, 0x08, 0x75, 0xD7, 0x00, 0xFD, 0xFE, 0x65, 0xF8, 0x18, 0x6B, 0xEF, 0xF2, 0x07, 0x00, 0xEE,
+    0xB2, 0x14, 0x3E, 0x01, 0xFA, 0x1E, 0xF7, 0x1E, 0xF1, 0x15, 0x64, 0x92, 0xF4, 0x55, 0xFB, 0x33,
+    0x00, 0xEE,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0xF865, 0x865, 0x8, 0x6, 0x5, 0x65};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F865  LD V8, [I]
+    Chip8::op_FX65<Q>(c, op_200);
+    // 202  FE1E  ADD I, VE
+    c.index = static_cast<uint16_t>((c.index + v[0xE]) & 0xFFF);
+    // 204  F107  LD V1, DT
+    v[0x1] = c.delay_timer;
+    // 206  3E00  SE VE, 0x00
+    c.program_counter = v[0xE] == 0x00 ? 0x20A : 0x208;
+    c.current_opcode = 0x3E00;
+    c.advance_cycles(4);
+    return 4;
+}
+
+
+static uint32_t block_208(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 208  81F3  XOR V1, VF
+    v[0x1] ^= v[0xF];
+    c.program_counter = 0x20A;
+    c.current_opcode = 0x81F3;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20A = {nullptr, 0xF633, 0x633, 0x6, 0x3, 0x3, 0x33};
+static const Chip8::DecodedOp op_20E = {nullptr, 0x2234, 0x234, 0x2, 0x3, 0x4, 0x34};
+
+static uint32_t block_20A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20A  F633  LD B, V6
+    Chip8::op_FX33(c, op_20A);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x20C;
+        c.current_opcode = 0xF633;
+        c.advance_cycles(1);
+        return 1;
+    }
+    // 20C  8E9E  SHL VE, V9
+    { uint8_t s = v[0xE]; v[0xE] = static_cast<uint8_t>(s << 1); v[0xF] = s >> 7; }
+    // 20E  2234  CALL 0x234
+    c.program_counter = 0x20E;
+    Chip8::op_2NNN(c, op_20E);
+    c.current_opcode = 0x2234;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8::DecodedOp op_212 = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_210(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 210  CD82  RND VD, 0x82
+    v[0xD] = static_cast<uint8_t>(c.next_random() & 0x82);
+    // 212  00EE  RET
+    c.program_counter = 0x212;
+    Chip8::op_00EE(c, op_212);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8::DecodedOp op_23C = {nullptr, 0xF455, 0x455, 0x4, 0x5, 0x5, 0x55};
+static const Chip8::DecodedOp op_23E = {nullptr, 0xFB33, 0xB33, 0xB, 0x3, 0x3, 0x33};
+static const Chip8::DecodedOp op_240 = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_234(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 234  FA1E  ADD I, VA
+    c.index = static_cast<uint16_t>((c.index + v[0xA]) & 0xFFF);
+    // 236  F71E  ADD I, V7
+    c.index = static_cast<uint16_t>((c.index + v[0x7]) & 0xFFF);
+    // 238  F115  LD DT, V1
+    c.delay_timer = v[0x1];
+    // 23A  6492  LD V4, 0x92
+    v[0x4] = 0x92;
+    // 23C  F455  LD [I], V4
+    Chip8::op_FX55<Q>(c, op_23C);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x23E;
+        c.current_opcode = 0xF455;
+        c.advance_cycles(5);
+        return 5;
+    }
+    // 23E  FB33  LD B, VB
+    Chip8::op_FX33(c, op_23E);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x240;
+        c.current_opcode = 0xFB33;
+        c.advance_cycles(6);
+        return 6;
+    }
+    // 240  00EE  RET
+    c.program_counter = 0x240;
+    Chip8::op_00EE(c, op_240);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(7);
+    return 7;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x208, 4, 3},
+    {&block_208, 0x208, 0x20A, 1, 0},
+    {&block_20A, 0x20A, 0x210, 3, 0},
+    {&block_210, 0x210, 0x214, 2, 0},
+    {&block_234, 0x234, 0x242, 7, 3},
+};
+
+} // namespace check_schip_11_blocks
+
+static const Chip8AotProgram check_schip_11 = {
+    QuirkProfile::SuperChip, check_schip_11_blocks::blocks, sizeof(check_schip_11_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_schip_11_blocks::image, 0x200, 0x242, check_schip_11_blocks::code_pages
+};
@@ -0,0 +1,51 @@
+// Generated by recompile from build/check/vip_00.ch8 with vip quirks, don't edit.
+// 3 reached instructions, 2 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_00_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xF9, 0x07, 0x12, 0x0A, 0x56, 0x30, 0xA2, 0x38, 0x64, 0xE2, 0xB2, 0x02,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F907  LD V9, DT
+    v[0x9] = c.delay_timer;
+    // 202  120A  JP 0x20A
+    c.program_counter = 0x20A;
+    c.current_opcode = 0x120A;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_20A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20A  B202  JP V0, 0x202
+    c.program_counter = (v[0x0] + 0x202) & 0xFFF;
+    c.current_opcode = 0xB202;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x204, 2, 1},
+    {&block_20A, 0x20A, 0x20C, 1, 0},
+};
+
+} // namespace check_vip_00_blocks
+
+static const Chip8AotProgram check_vip_00 = {
+    QuirkProfile::CosmacVip, check_vip_00_blocks::blocks, sizeof(check_vip_00_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_00_blocks::image, 0x200, 0x20C, check_vip_00_blocks::code_pages
+};
@@ -0,0 +1,129 @@
+// Generated by recompile from build/check/vip_01.ch8 with vip quirks, don't edit.
+// 11 reached instructions, 8 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_01_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xFB, 0x18, 0xF4, 0x0A, 0x51, 0xA0, 0x3C, 0x01, 0xE9, 0xA1, 0xDF, 0x9F, 0xEC, 0x9E, 0xFE, 0x33,
+    0x73, 0x22, 0xF8, 0x07, 0xB2, 0x12,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  FB18  LD ST, VB
+    c.sound_timer = v[0xB];
+    c.program_counter = 0x202;
+    c.current_opcode = 0xFB18;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_204(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 204  51A0  SE V1, VA
+    c.program_counter = v[0x1] == v[0xA] ? 0x208 : 0x206;
+    c.current_opcode = 0x51A0;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_206(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 206  3C01  SE VC, 0x01
+    c.program_counter = v[0xC] == 0x01 ? 0x20A : 0x208;
+    c.current_opcode = 0x3C01;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_208(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 208  E9A1  SKNP V9
+    c.program_counter = c.keys[v[0x9] & 0xF] == 0 ? 0x20C : 0x20A;
+    c.current_opcode = 0xE9A1;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20A = {nullptr, 0xDF9F, 0xF9F, 0xF, 0x9, 0xF, 0x9F};
+
+static uint32_t block_20A(Chip8 &c)
+{
+    // 20A  DF9F  DRW VF, V9, 15
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_20A); else Chip8::op_DXYN<false, Q>(c, op_20A);
+    c.program_counter = 0x20C;
+    c.current_opcode = 0xDF9F;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20C  EC9E  SKP VC
+    c.program_counter = c.keys[v[0xC] & 0xF] != 0 ? 0x210 : 0x20E;
+    c.current_opcode = 0xEC9E;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20E = {nullptr, 0xFE33, 0xE33, 0xE, 0x3, 0x3, 0x33};
+
+static uint32_t block_20E(Chip8 &c)
+{
+    // 20E  FE33  LD B, VE
+    Chip8::op_FX33(c, op_20E);
+    c.program_counter = 0x210;
+    c.current_opcode = 0xFE33;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_210(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 210  7322  ADD V3, 0x22
+    v[0x3] += 0x22;
+    // 212  F807  LD V8, DT
+    v[0x8] = c.delay_timer;
+    // 214  B212  JP V0, 0x212
+    c.program_counter = (v[0x0] + 0x212) & 0xFFF;
+    c.current_opcode = 0xB212;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 1},
+    {&block_204, 0x204, 0x206, 1, 0},
+    {&block_206, 0x206, 0x208, 1, 0},
+    {&block_208, 0x208, 0x20A, 1, 0},
+    {&block_20A, 0x20A, 0x20C, 1, 0},
+    {&block_20C, 0x20C, 0x20E, 1, 0},
+    {&block_20E, 0x20E, 0x210, 1, 0},
+    {&block_210, 0x210, 0x216, 3, 2},
+};
+
+} // namespace check_vip_01_blocks
+
+static const Chip8AotProgram check_vip_01 = {
+    QuirkProfile::CosmacVip, check_vip_01_blocks::blocks, sizeof(check_vip_01_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_01_blocks::image, 0x200, 0x216, check_vip_01_blocks::code_pages
+};
@@ -0,0 +1,43 @@
+// Generated by recompile from build/check/vip_02.ch8 with vip quirks, don't edit.
+// 3 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_02_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x6E, 0xF3, 0x70, 0x07, 0x00, 0xEE,
+};
+
+static const Chip8::DecodedOp op_204 = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  6EF3  LD VE, 0xF3
+    v[0xE] = 0xF3;
+    // 202  7007  ADD V0, 0x07
+    v[0x0] += 0x07;
+    // 204  00EE  RET
+    c.program_counter = 0x204;
+    Chip8::op_00EE(c, op_204);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x206, 3, 0},
+};
+
+} // namespace check_vip_02_blocks
+
+static const Chip8AotProgram check_vip_02 = {
+    QuirkProfile::CosmacVip, check_vip_02_blocks::blocks, sizeof(check_vip_02_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_02_blocks::image, 0x200, 0x206, check_vip_02_blocks::code_pages
+};
@@ -0,0 +1,72 @@
+// Generated by recompile from build/check/vip_03.ch8 with vip quirks, don't edit.
+// 8 reached instructions, 3 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_03_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xA3, 0xFB, 0xA2, 0x6F, 0xFE, 0x07, 0xD2, 0xCE, 0x4E, 0x02, 0x6B, 0x05, 0xFD, 0x29,
+};
+
+static const Chip8::DecodedOp op_206 = {nullptr, 0xD2CE, 0x2CE, 0x2, 0xC, 0xE, 0xCE};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  A3FB  LD I, 0x3FB
+    c.index = 0x3FB;
+    // 202  A26F  LD I, 0x26F
+    c.index = 0x26F;
+    // 204  FE07  LD VE, DT
+    v[0xE] = c.delay_timer;
+    // 206  D2CE  DRW V2, VC, 14
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_206); else Chip8::op_DXYN<false, Q>(c, op_206);
+    // 208  4E02  SNE VE, 0x02
+    c.program_counter = v[0xE] != 0x02 ? 0x20C : 0x20A;
+    c.current_opcode = 0x4E02;
+    c.advance_cycles(5);
+    return 5;
+}
+
+
+static uint32_t block_20A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20A  6B05  LD VB, 0x05
+    v[0xB] = 0x05;
+    c.program_counter = 0x20C;
+    c.current_opcode = 0x6B05;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20C  FD29  LD F, VD
+    c.index = static_cast<uint16_t>(chip8_font_address + (v[0xD] & 0xF) * 5);
+    c.program_counter = 0x20E;
+    c.current_opcode = 0xFD29;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x20A, 5, 3},
+    {&block_20A, 0x20A, 0x20C, 1, 0},
+    {&block_20C, 0x20C, 0x20E, 1, 0},
+};
+
+} // namespace check_vip_03_blocks
+
+static const Chip8AotProgram check_vip_03 = {
+    QuirkProfile::CosmacVip, check_vip_03_blocks::blocks, sizeof(check_vip_03_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_03_blocks::image, 0x200, 0x20E, check_vip_03_blocks::code_pages
+};
@@ -0,0 +1,118 @@
+// Generated by recompile from build/check/vip_04.ch8 with vip quirks, don't edit.
+// 16 reached instructions, 5 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_04_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000300ull;
+
+static const uint8_t image[] = {
+    0xF4, 0x07, 0x22, 0x6A, 0x7E, 0x28, 0x62, 0xE9, 0x00, 0xFE, 0x81, 0xD1, 0x12, 0x0C, 0x6C, 0x8E,
+    0xFA, 0x75, 0x8B, 0x66, 0x6D, 0x89, 0x12, 0x88, 0xFC, 0x18, 0x8D, 0xA2, 0x12, 0x7A, 0x84, 0x92,
+    0x00, 0xFF, 0x95, 0x50, 0x53, 0x00, 0xF7, 0x07, 0x3B, 0x02, 0x65, 0x26, 0x22, 0x5C, 0xF7, 0x1E,
+    0xF5, 0x55, 0xFE, 0x1E, 0x7E, 0x7F, 0x8B, 0xDE, 0x00, 0xFB, 0x82, 0x32, 0x70, 0x33, 0xFC, 0x33,
+    0xFC, 0x55, 0x6D, 0xF6, 0xFA, 0x55, 0xD8, 0xB4, 0x69, 0x08, 0xF6, 0x18, 0x00, 0xFB, 0x84, 0x54,
+    0x00, 0xFB, 0x81, 0x1E, 0xF7, 0x1E, 0xFA, 0x15, 0xFB, 0x07, 0x12, 0x3A, 0xF6, 0x18, 0x00, 0xFB,
+    0xB2, 0x52, 0x8F, 0xD5, 0x9C, 0xE0, 0xB2, 0xB2, 0x00, 0xFB, 0x6F, 0x57, 0x47, 0x03, 0xFC, 0x15,
+    0x7C, 0xFC, 0x88, 0xF4, 0x64, 0x34, 0x8B, 0x34, 0x00, 0xE0, 0xB2, 0x46,
+};
+
+static const Chip8::DecodedOp op_202 = {nullptr, 0x226A, 0x26A, 0x2, 0x6, 0xA, 0x6A};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F407  LD V4, DT
+    v[0x4] = c.delay_timer;
+    // 202  226A  CALL 0x26A
+    c.program_counter = 0x202;
+    Chip8::op_2NNN(c, op_202);
+    c.current_opcode = 0x226A;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8::DecodedOp op_208 = {nullptr, 0x00FE, 0x0FE, 0x0, 0xF, 0xE, 0xFE};
+
+static uint32_t block_204(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 204  7E28  ADD VE, 0x28
+    v[0xE] += 0x28;
+    // 206  62E9  LD V2, 0xE9
+    v[0x2] = 0xE9;
+    // 208  00FE  LOW
+    Chip8::op_00FE(c, op_208);
+    // 20A  81D1  OR V1, VD
+    v[0x1] |= v[0xD];
+    c.program_counter = 0x20C;
+    c.current_opcode = 0x81D1;
+    c.advance_cycles(4);
+    return 4;
+}
+
+
+static uint32_t block_26A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 26A  6F57  LD VF, 0x57
+    v[0xF] = 0x57;
+    // 26C  4703  SNE V7, 0x03
+    c.program_counter = v[0x7] != 0x03 ? 0x270 : 0x26E;
+    c.current_opcode = 0x4703;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_26E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 26E  FC15  LD DT, VC
+    c.delay_timer = v[0xC];
+    c.program_counter = 0x270;
+    c.current_opcode = 0xFC15;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_278 = {nullptr, 0x00E0, 0x0E0, 0x0, 0xE, 0x0, 0xE0};
+
+static uint32_t block_270(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 270  7CFC  ADD VC, 0xFC
+    v[0xC] += 0xFC;
+    // 272  88F4  ADD V8, VF
+    { unsigned sum = v[0x8] + v[0xF]; v[0x8] = static_cast<uint8_t>(sum); v[0xF] = sum > 255u; }
+    // 274  6434  LD V4, 0x34
+    v[0x4] = 0x34;
+    // 276  8B34  ADD VB, V3
+    { unsigned sum = v[0xB] + v[0x3]; v[0xB] = static_cast<uint8_t>(sum); v[0xF] = sum > 255u; }
+    // 278  00E0  CLS
+    if (c.extendedScreenMode) Chip8::op_00E0<true>(c, op_278); else Chip8::op_00E0<false>(c, op_278);
+    // 27A  B246  JP V0, 0x246
+    c.program_counter = (v[0x0] + 0x246) & 0xFFF;
+    c.current_opcode = 0xB246;
+    c.advance_cycles(6);
+    return 6;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x204, 2, 1},
+    {&block_204, 0x204, 0x20C, 4, 0},
+    {&block_26A, 0x26A, 0x26E, 2, 0},
+    {&block_26E, 0x26E, 0x270, 1, 1},
+    {&block_270, 0x270, 0x27C, 6, 0},
+};
+
+} // namespace check_vip_04_blocks
+
+static const Chip8AotProgram check_vip_04 = {
+    QuirkProfile::CosmacVip, check_vip_04_blocks::blocks, sizeof(check_vip_04_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_04_blocks::image, 0x200, 0x27C, check_vip_04_blocks::code_pages
+};
@@ -0,0 +1,92 @@
+// Generated by recompile from build/check/vip_05.ch8 with vip quirks, don't edit.
+// 15 reached instructions, 3 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_05_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x7F, 0x73, 0x89, 0xE4, 0x90, 0xC0, 0xFB, 0x30, 0x83, 0x05, 0xD1, 0xA1, 0x00, 0xE0, 0x00, 0xFF,
+    0xD1, 0x5E, 0x60, 0x16, 0xFF, 0x65, 0xA2, 0x4A, 0x75, 0x47, 0xF7, 0x1E, 0xB2, 0x28,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  7F73  ADD VF, 0x73
+    v[0xF] += 0x73;
+    // 202  89E4  ADD V9, VE
+    { unsigned sum = v[0x9] + v[0xE]; v[0x9] = static_cast<uint8_t>(sum); v[0xF] = sum > 255u; }
+    // 204  90C0  SNE V0, VC
+    c.program_counter = v[0x0] != v[0xC] ? 0x208 : 0x206;
+    c.current_opcode = 0x90C0;
+    c.advance_cycles(3);
+    return 3;
+}
+
+
+static uint32_t block_206(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 206  FB30  LD HF, VB
+    c.index = static_cast<uint16_t>(chip48_font_address + (v[0xB] & 0xF) * 10);
+    c.program_counter = 0x208;
+    c.current_opcode = 0xFB30;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20A = {nullptr, 0xD1A1, 0x1A1, 0x1, 0xA, 0x1, 0xA1};
+static const Chip8::DecodedOp op_20C = {nullptr, 0x00E0, 0x0E0, 0x0, 0xE, 0x0, 0xE0};
+static const Chip8::DecodedOp op_20E = {nullptr, 0x00FF, 0x0FF, 0x0, 0xF, 0xF, 0xFF};
+static const Chip8::DecodedOp op_210 = {nullptr, 0xD15E, 0x15E, 0x1, 0x5, 0xE, 0x5E};
+static const Chip8::DecodedOp op_214 = {nullptr, 0xFF65, 0xF65, 0xF, 0x6, 0x5, 0x65};
+
+static uint32_t block_208(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 208  8305  SUB V3, V0
+    { uint8_t flag = v[0x3] >= v[0x0]; v[0x3] -= v[0x0]; v[0xF] = flag; }
+    // 20A  D1A1  DRW V1, VA, 1
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_20A); else Chip8::op_DXYN<false, Q>(c, op_20A);
+    // 20C  00E0  CLS
+    if (c.extendedScreenMode) Chip8::op_00E0<true>(c, op_20C); else Chip8::op_00E0<false>(c, op_20C);
+    // 20E  00FF  HIGH
+    Chip8::op_00FF(c, op_20E);
+    // 210  D15E  DRW V1, V5, 14
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_210); else Chip8::op_DXYN<false, Q>(c, op_210);
+    // 212  6016  LD V0, 0x16
+    v[0x0] = 0x16;
+    // 214  FF65  LD VF, [I]
+    Chip8::op_FX65<Q>(c, op_214);
+    // 216  A24A  LD I, 0x24A
+    c.index = 0x24A;
+    // 218  7547  ADD V5, 0x47
+    v[0x5] += 0x47;
+    // 21A  F71E  ADD I, V7
+    c.index = static_cast<uint16_t>((c.index + v[0x7]) & 0xFFF);
+    // 21C  B228  JP V0, 0x228
+    c.program_counter = (v[0x0] + 0x228) & 0xFFF;
+    c.current_opcode = 0xB228;
+    c.advance_cycles(11);
+    return 11;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x206, 3, 0},
+    {&block_206, 0x206, 0x208, 1, 0},
+    {&block_208, 0x208, 0x21E, 11, 0},
+};
+
+} // namespace check_vip_05_blocks
+
+static const Chip8AotProgram check_vip_05 = {
+    QuirkProfile::CosmacVip, check_vip_05_blocks::blocks, sizeof(check_vip_05_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_05_blocks::image, 0x200, 0x21E, check_vip_05_blocks::code_pages
+};
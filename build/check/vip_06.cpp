@@ -0,0 +1,41 @@
+// Generated by recompile from build/check/vip_06.ch8 with vip quirks, don't edit.
+// 3 reached instructions, 1 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_06_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x84, 0xB1, 0xF7, 0x07, 0xB2, 0x96,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  84B1  OR V4, VB
+    v[0x4] |= v[0xB];
+    // 202  F707  LD V7, DT
+    v[0x7] = c.delay_timer;
+    // 204  B296  JP V0, 0x296
+    c.program_counter = (v[0x0] + 0x296) & 0xFFF;
+    c.current_opcode = 0xB296;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x206, 3, 2},
+};
+
+} // namespace check_vip_06_blocks
+
+static const Chip8AotProgram check_vip_06 = {
+    QuirkProfile::CosmacVip, check_vip_06_blocks::blocks, sizeof(check_vip_06_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_06_blocks::image, 0x200, 0x206, check_vip_06_blocks::code_pages
+};
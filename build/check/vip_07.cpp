@@ -0,0 +1,38 @@
+// Generated by recompile from build/check/vip_07.ch8 with vip quirks, don't edit.
+// 1 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_07_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x00, 0xEE,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_200(Chip8 &c)
+{
+    // 200  00EE  RET
+    c.program_counter = 0x200;
+    Chip8::op_00EE(c, op_200);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+};
+
+} // namespace check_vip_07_blocks
+
+static const Chip8AotProgram check_vip_07 = {
+    QuirkProfile::CosmacVip, check_vip_07_blocks::blocks, sizeof(check_vip_07_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_07_blocks::image, 0x200, 0x202, check_vip_07_blocks::code_pages
+};
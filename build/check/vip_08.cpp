@@ -0,0 +1,443 @@
+// Generated by recompile from build/check/vip_08.ch8 with vip quirks, don't edit.
+// 56 reached instructions, 22 compiled blocks, 2 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_08_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000700ull;
+
+static const uint8_t image[] = {
+    0xF7, 0x07, 0xC4, 0x9E, 0xFC, 0x55, 0xFC, 0x33, 0x00, 0xC3, 0xA2, 0x44, 0x00, 0xC3, 0xF8, 0x18,
+    0x22, 0x4C, 0xDF, 0x03, 0x57, 0xF0, 0xD7, 0x03, 0x53, 0x80, 0xF4, 0x18, 0xF4, 0x33, 0x12, 0x68,
+    0x60, 0x5F, 0xF7, 0x18, 0x6C, 0xB2, 0x87, 0x16, 0x91, 0x20, 0x7A, 0x17, 0x75, 0xDF, 0xFD, 0x07,
+    0xA2, 0x56, 0x6C, 0xA0, 0x22, 0x58, 0xB2, 0x70, 0x5D, 0xD0, 0x92, 0xD0, 0xFD, 0x30, 0xF0, 0x65,
+    0xF9, 0x15, 0xF9, 0x15, 0x69, 0x0F, 0xDF, 0xC6, 0xF7, 0x15, 0x82, 0xB5, 0xF1, 0x07, 0xDD, 0x43,
+    0xF1, 0x1E, 0xF2, 0x15, 0xD5, 0x75, 0xF9, 0x33, 0x6A, 0x28, 0x00, 0x00, 0xF2, 0x55, 0x8B, 0x71,
+    0x9E, 0x00, 0x99, 0x10, 0x00, 0xFC, 0xF4, 0x15, 0xDE, 0xE2, 0x6F, 0xE1, 0x42, 0x00, 0x9C, 0x60,
+    0xFA, 0x07, 0x90, 0xF0, 0xB2, 0x38, 0xF7, 0x07, 0x98, 0x50, 0x42, 0x03, 0x7E, 0x17, 0x87, 0xAE,
+    0xF2, 0x33, 0xF6, 0x55, 0xF8, 0x1E, 0x8A, 0x94, 0x69, 0xAC, 0x6C, 0xC0, 0xFC, 0x07, 0xF5, 0x33,
+    0xEE, 0xA1, 0x99, 0xC0, 0xF5, 0x55, 0xF6, 0x33, 0x44, 0x03, 0xE9, 0x9E, 0xF6, 0x15, 0xF3, 0x07,
+    0x8E, 0x93, 0x71, 0x33, 0xFA, 0x29, 0xB2, 0xA0,
+};
+
+static const Chip8::DecodedOp op_204 = {nullptr, 0xFC55, 0xC55, 0xC, 0x5, 0x5, 0x55};
+static const Chip8::DecodedOp op_206 = {nullptr, 0xFC33, 0xC33, 0xC, 0x3, 0x3, 0x33};
+static const Chip8::DecodedOp op_208 = {nullptr, 0x00C3, 0x0C3, 0x0, 0xC, 0x3, 0xC3};
+static const Chip8::DecodedOp op_20C = {nullptr, 0x00C3, 0x0C3, 0x0, 0xC, 0x3, 0xC3};
+static const Chip8::DecodedOp op_210 = {nullptr, 0x224C, 0x24C, 0x2, 0x4, 0xC, 0x4C};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F707  LD V7, DT
+    v[0x7] = c.delay_timer;
+    // 202  C49E  RND V4, 0x9E
+    v[0x4] = static_cast<uint8_t>(c.next_random() & 0x9E);
+    // 204  FC55  LD [I], VC
+    Chip8::op_FX55<Q>(c, op_204);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x206;
+        c.current_opcode = 0xFC55;
+        c.advance_cycles(3);
+        return 3;
+    }
+    // 206  FC33  LD B, VC
+    Chip8::op_FX33(c, op_206);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x208;
+        c.current_opcode = 0xFC33;
+        c.advance_cycles(4);
+        return 4;
+    }
+    // 208  00C3  SCD 3
+    if (c.extendedScreenMode) Chip8::op_00CN<true>(c, op_208); else Chip8::op_00CN<false>(c, op_208);
+    // 20A  A244  LD I, 0x244
+    c.index = 0x244;
+    // 20C  00C3  SCD 3
+    if (c.extendedScreenMode) Chip8::op_00CN<true>(c, op_20C); else Chip8::op_00CN<false>(c, op_20C);
+    // 20E  F818  LD ST, V8
+    c.sound_timer = v[0x8];
+    // 210  224C  CALL 0x24C
+    c.program_counter = 0x210;
+    Chip8::op_2NNN(c, op_210);
+    c.current_opcode = 0x224C;
+    c.advance_cycles(9);
+    return 9;
+}
+
+static const Chip8::DecodedOp op_212 = {nullptr, 0xDF03, 0xF03, 0xF, 0x0, 0x3, 0x03};
+
+static uint32_t block_212(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 212  DF03  DRW VF, V0, 3
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_212); else Chip8::op_DXYN<false, Q>(c, op_212);
+    // 214  57F0  SE V7, VF
+    c.program_counter = v[0x7] == v[0xF] ? 0x218 : 0x216;
+    c.current_opcode = 0x57F0;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8::DecodedOp op_216 = {nullptr, 0xD703, 0x703, 0x7, 0x0, 0x3, 0x03};
+
+static uint32_t block_216(Chip8 &c)
+{
+    // 216  D703  DRW V7, V0, 3
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_216); else Chip8::op_DXYN<false, Q>(c, op_216);
+    c.program_counter = 0x218;
+    c.current_opcode = 0xD703;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_218(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 218  5380  SE V3, V8
+    c.program_counter = v[0x3] == v[0x8] ? 0x21C : 0x21A;
+    c.current_opcode = 0x5380;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_21A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 21A  F418  LD ST, V4
+    c.sound_timer = v[0x4];
+    c.program_counter = 0x21C;
+    c.current_opcode = 0xF418;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_21C = {nullptr, 0xF433, 0x433, 0x4, 0x3, 0x3, 0x33};
+
+static uint32_t block_21C(Chip8 &c)
+{
+    // 21C  F433  LD B, V4
+    Chip8::op_FX33(c, op_21C);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x21E;
+        c.current_opcode = 0xF433;
+        c.advance_cycles(1);
+        return 1;
+    }
+    // 21E  1268  JP 0x268
+    c.program_counter = 0x268;
+    c.current_opcode = 0x1268;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8::DecodedOp op_24E = {nullptr, 0xDD43, 0xD43, 0xD, 0x4, 0x3, 0x43};
+static const Chip8::DecodedOp op_254 = {nullptr, 0xD575, 0x575, 0x5, 0x7, 0x5, 0x75};
+static const Chip8::DecodedOp op_256 = {nullptr, 0xF933, 0x933, 0x9, 0x3, 0x3, 0x33};
+
+static uint32_t block_24C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 24C  F107  LD V1, DT
+    v[0x1] = c.delay_timer;
+    // 24E  DD43  DRW VD, V4, 3
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_24E); else Chip8::op_DXYN<false, Q>(c, op_24E);
+    // 250  F11E  ADD I, V1
+    c.index = static_cast<uint16_t>((c.index + v[0x1]) & 0xFFF);
+    // 252  F215  LD DT, V2
+    c.delay_timer = v[0x2];
+    // 254  D575  DRW V5, V7, 5
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_254); else Chip8::op_DXYN<false, Q>(c, op_254);
+    // 256  F933  LD B, V9
+    Chip8::op_FX33(c, op_256);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x258;
+        c.current_opcode = 0xF933;
+        c.advance_cycles(6);
+        return 6;
+    }
+    // 258  6A28  LD VA, 0x28
+    v[0xA] = 0x28;
+    c.program_counter = 0x25A;
+    c.current_opcode = 0x6A28;
+    c.advance_cycles(7);
+    return 7;
+}
+
+static const Chip8::DecodedOp op_268 = {nullptr, 0xDEE2, 0xEE2, 0xE, 0xE, 0x2, 0xE2};
+
+static uint32_t block_268(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 268  DEE2  DRW VE, VE, 2
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_268); else Chip8::op_DXYN<false, Q>(c, op_268);
+    // 26A  6FE1  LD VF, 0xE1
+    v[0xF] = 0xE1;
+    // 26C  4200  SNE V2, 0x00
+    c.program_counter = v[0x2] != 0x00 ? 0x270 : 0x26E;
+    c.current_opcode = 0x4200;
+    c.advance_cycles(3);
+    return 3;
+}
+
+
+static uint32_t block_26E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 26E  9C60  SNE VC, V6
+    c.program_counter = v[0xC] != v[0x6] ? 0x272 : 0x270;
+    c.current_opcode = 0x9C60;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_270(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 270  FA07  LD VA, DT
+    v[0xA] = c.delay_timer;
+    c.program_counter = 0x272;
+    c.current_opcode = 0xFA07;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_272(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 272  90F0  SNE V0, VF
+    c.program_counter = v[0x0] != v[0xF] ? 0x276 : 0x274;
+    c.current_opcode = 0x90F0;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_274(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 274  B238  JP V0, 0x238
+    c.program_counter = (v[0x0] + 0x238) & 0xFFF;
+    c.current_opcode = 0xB238;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_276(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 276  F707  LD V7, DT
+    v[0x7] = c.delay_timer;
+    // 278  9850  SNE V8, V5
+    c.program_counter = v[0x8] != v[0x5] ? 0x27C : 0x27A;
+    c.current_opcode = 0x9850;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_27A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 27A  4203  SNE V2, 0x03
+    c.program_counter = v[0x2] != 0x03 ? 0x27E : 0x27C;
+    c.current_opcode = 0x4203;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_27C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 27C  7E17  ADD VE, 0x17
+    v[0xE] += 0x17;
+    c.program_counter = 0x27E;
+    c.current_opcode = 0x7E17;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_280 = {nullptr, 0xF233, 0x233, 0x2, 0x3, 0x3, 0x33};
+static const Chip8::DecodedOp op_282 = {nullptr, 0xF655, 0x655, 0x6, 0x5, 0x5, 0x55};
+static const Chip8::DecodedOp op_28E = {nullptr, 0xF533, 0x533, 0x5, 0x3, 0x3, 0x33};
+
+static uint32_t block_27E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 27E  87AE  SHL V7, VA
+    { uint8_t s = v[0xA]; v[0x7] = static_cast<uint8_t>(s << 1); v[0xF] = s >> 7; }
+    // 280  F233  LD B, V2
+    Chip8::op_FX33(c, op_280);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x282;
+        c.current_opcode = 0xF233;
+        c.advance_cycles(2);
+        return 2;
+    }
+    // 282  F655  LD [I], V6
+    Chip8::op_FX55<Q>(c, op_282);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x284;
+        c.current_opcode = 0xF655;
+        c.advance_cycles(3);
+        return 3;
+    }
+    // 284  F81E  ADD I, V8
+    c.index = static_cast<uint16_t>((c.index + v[0x8]) & 0xFFF);
+    // 286  8A94  ADD VA, V9
+    { unsigned sum = v[0xA] + v[0x9]; v[0xA] = static_cast<uint8_t>(sum); v[0xF] = sum > 255u; }
+    // 288  69AC  LD V9, 0xAC
+    v[0x9] = 0xAC;
+    // 28A  6CC0  LD VC, 0xC0
+    v[0xC] = 0xC0;
+    // 28C  FC07  LD VC, DT
+    v[0xC] = c.delay_timer;
+    // 28E  F533  LD B, V5
+    Chip8::op_FX33(c, op_28E);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x290;
+        c.current_opcode = 0xF533;
+        c.advance_cycles(9);
+        return 9;
+    }
+    // 290  EEA1  SKNP VE
+    c.program_counter = c.keys[v[0xE] & 0xF] == 0 ? 0x294 : 0x292;
+    c.current_opcode = 0xEEA1;
+    c.advance_cycles(10);
+    return 10;
+}
+
+
+static uint32_t block_292(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 292  99C0  SNE V9, VC
+    c.program_counter = v[0x9] != v[0xC] ? 0x296 : 0x294;
+    c.current_opcode = 0x99C0;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_294 = {nullptr, 0xF555, 0x555, 0x5, 0x5, 0x5, 0x55};
+
+static uint32_t block_294(Chip8 &c)
+{
+    // 294  F555  LD [I], V5
+    Chip8::op_FX55<Q>(c, op_294);
+    c.program_counter = 0x296;
+    c.current_opcode = 0xF555;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_296 = {nullptr, 0xF633, 0x633, 0x6, 0x3, 0x3, 0x33};
+
+static uint32_t block_296(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 296  F633  LD B, V6
+    Chip8::op_FX33(c, op_296);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x298;
+        c.current_opcode = 0xF633;
+        c.advance_cycles(1);
+        return 1;
+    }
+    // 298  4403  SNE V4, 0x03
+    c.program_counter = v[0x4] != 0x03 ? 0x29C : 0x29A;
+    c.current_opcode = 0x4403;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_29A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 29A  E99E  SKP V9
+    c.program_counter = c.keys[v[0x9] & 0xF] != 0 ? 0x29E : 0x29C;
+    c.current_opcode = 0xE99E;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_29C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 29C  F615  LD DT, V6
+    c.delay_timer = v[0x6];
+    c.program_counter = 0x29E;
+    c.current_opcode = 0xF615;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_29E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 29E  F307  LD V3, DT
+    v[0x3] = c.delay_timer;
+    // 2A0  8E93  XOR VE, V9
+    v[0xE] ^= v[0x9];
+    // 2A2  7133  ADD V1, 0x33
+    v[0x1] += 0x33;
+    // 2A4  FA29  LD F, VA
+    c.index = static_cast<uint16_t>(chip8_font_address + (v[0xA] & 0xF) * 5);
+    // 2A6  B2A0  JP V0, 0x2A0
+    c.program_counter = (v[0x0] + 0x2A0) & 0xFFF;
+    c.current_opcode = 0xB2A0;
+    c.advance_cycles(5);
+    return 5;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x212, 9, 8},
+    {&block_212, 0x212, 0x216, 2, 0},
+    {&block_216, 0x216, 0x218, 1, 0},
+    {&block_218, 0x218, 0x21A, 1, 0},
+    {&block_21A, 0x21A, 0x21C, 1, 1},
+    {&block_21C, 0x21C, 0x220, 2, 0},
+    {&block_24C, 0x24C, 0x25A, 7, 4},
+    {&block_268, 0x268, 0x26E, 3, 0},
+    {&block_26E, 0x26E, 0x270, 1, 0},
+    {&block_270, 0x270, 0x272, 1, 1},
+    {&block_272, 0x272, 0x274, 1, 0},
+    {&block_274, 0x274, 0x276, 1, 0},
+    {&block_276, 0x276, 0x27A, 2, 1},
+    {&block_27A, 0x27A, 0x27C, 1, 0},
+    {&block_27C, 0x27C, 0x27E, 1, 0},
+    {&block_27E, 0x27E, 0x292, 10, 8},
+    {&block_292, 0x292, 0x294, 1, 0},
+    {&block_294, 0x294, 0x296, 1, 0},
+    {&block_296, 0x296, 0x29A, 2, 0},
+    {&block_29A, 0x29A, 0x29C, 1, 0},
+    {&block_29C, 0x29C, 0x29E, 1, 1},
+    {&block_29E, 0x29E, 0x2A8, 5, 1},
+};
+
+} // namespace check_vip_08_blocks
+
+static const Chip8AotProgram check_vip_08 = {
+    QuirkProfile::CosmacVip, check_vip_08_blocks::blocks, sizeof(check_vip_08_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_08_blocks::image, 0x200, 0x2A8, check_vip_08_blocks::code_pages
+};
@@ -0,0 +1,102 @@
+// Generated by recompile from build/check/vip_09.ch8 with vip quirks, don't edit.
+// 17 reached instructions, 4 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_09_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xF5, 0x18, 0xA2, 0x74, 0x46, 0x02, 0xF7, 0x33, 0xFB, 0x85, 0x87, 0x27, 0x8C, 0x57, 0xF1, 0x07,
+    0x69, 0x09, 0x74, 0x77, 0xFF, 0x65, 0xFF, 0x1E, 0x80, 0xFE, 0xFD, 0x15, 0x31, 0x00, 0x00, 0xEE,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F518  LD ST, V5
+    c.sound_timer = v[0x5];
+    // 202  A274  LD I, 0x274
+    c.index = 0x274;
+    // 204  4602  SNE V6, 0x02
+    c.program_counter = v[0x6] != 0x02 ? 0x208 : 0x206;
+    c.current_opcode = 0x4602;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8::DecodedOp op_206 = {nullptr, 0xF733, 0x733, 0x7, 0x3, 0x3, 0x33};
+
+static uint32_t block_206(Chip8 &c)
+{
+    // 206  F733  LD B, V7
+    Chip8::op_FX33(c, op_206);
+    c.program_counter = 0x208;
+    c.current_opcode = 0xF733;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_208 = {nullptr, 0xFB85, 0xB85, 0xB, 0x8, 0x5, 0x85};
+static const Chip8::DecodedOp op_214 = {nullptr, 0xFF65, 0xF65, 0xF, 0x6, 0x5, 0x65};
+
+static uint32_t block_208(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 208  FB85  LD VB, R
+    Chip8::op_FX85(c, op_208);
+    // 20A  8727  SUBN V7, V2
+    { uint8_t flag = v[0x2] >= v[0x7]; v[0x7] = v[0x2] - v[0x7]; v[0xF] = flag; }
+    // 20C  8C57  SUBN VC, V5
+    { uint8_t flag = v[0x5] >= v[0xC]; v[0xC] = v[0x5] - v[0xC]; v[0xF] = flag; }
+    // 20E  F107  LD V1, DT
+    v[0x1] = c.delay_timer;
+    // 210  6909  LD V9, 0x09
+    v[0x9] = 0x09;
+    // 212  7477  ADD V4, 0x77
+    v[0x4] += 0x77;
+    // 214  FF65  LD VF, [I]
+    Chip8::op_FX65<Q>(c, op_214);
+    // 216  FF1E  ADD I, VF
+    c.index = static_cast<uint16_t>((c.index + v[0xF]) & 0xFFF);
+    // 218  80FE  SHL V0, VF
+    { uint8_t s = v[0xF]; v[0x0] = static_cast<uint8_t>(s << 1); v[0xF] = s >> 7; }
+    // 21A  FD15  LD DT, VD
+    c.delay_timer = v[0xD];
+    // 21C  3100  SE V1, 0x00
+    c.program_counter = v[0x1] == 0x00 ? 0x220 : 0x21E;
+    c.current_opcode = 0x3100;
+    c.advance_cycles(11);
+    return 11;
+}
+
+static const Chip8::DecodedOp op_21E = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_21E(Chip8 &c)
+{
+    // 21E  00EE  RET
+    c.program_counter = 0x21E;
+    Chip8::op_00EE(c, op_21E);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x206, 3, 1},
+    {&block_206, 0x206, 0x208, 1, 0},
+    {&block_208, 0x208, 0x21E, 11, 10},
+    {&block_21E, 0x21E, 0x220, 1, 0},
+};
+
+} // namespace check_vip_09_blocks
+
+static const Chip8AotProgram check_vip_09 = {
+    QuirkProfile::CosmacVip, check_vip_09_blocks::blocks, sizeof(check_vip_09_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_09_blocks::image, 0x200, 0x220, check_vip_09_blocks::code_pages
+};
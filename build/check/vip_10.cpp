@@ -0,0 +1,135 @@
+// Generated by recompile from build/check/vip_10.ch8 with vip quirks, don't edit.
+// 13 reached instructions, 8 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_10_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x22, 0x12, 0x3F, 0x00, 0xF8, 0x1E, 0x62, 0xC8, 0xFE, 0x18, 0x00, 0xFB, 0x6E, 0xF9, 0x6D, 0xE9,
+    0x12, 0x16, 0x90, 0x90, 0xF5, 0x65, 0x12, 0x18, 0xB2, 0x02,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0x2212, 0x212, 0x2, 0x1, 0x2, 0x12};
+
+static uint32_t block_200(Chip8 &c)
+{
+    // 200  2212  CALL 0x212
+    c.program_counter = 0x200;
+    Chip8::op_2NNN(c, op_200);
+    c.current_opcode = 0x2212;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_202(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 202  3F00  SE VF, 0x00
+    c.program_counter = v[0xF] == 0x00 ? 0x206 : 0x204;
+    c.current_opcode = 0x3F00;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_204(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 204  F81E  ADD I, V8
+    c.index = static_cast<uint16_t>((c.index + v[0x8]) & 0xFFF);
+    c.program_counter = 0x206;
+    c.current_opcode = 0xF81E;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20A = {nullptr, 0x00FB, 0x0FB, 0x0, 0xF, 0xB, 0xFB};
+
+static uint32_t block_206(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 206  62C8  LD V2, 0xC8
+    v[0x2] = 0xC8;
+    // 208  FE18  LD ST, VE
+    c.sound_timer = v[0xE];
+    // 20A  00FB  SCR
+    if (c.extendedScreenMode) Chip8::op_00FB<true>(c, op_20A); else Chip8::op_00FB<false>(c, op_20A);
+    // 20C  6EF9  LD VE, 0xF9
+    v[0xE] = 0xF9;
+    // 20E  6DE9  LD VD, 0xE9
+    v[0xD] = 0xE9;
+    // 210  1216  JP 0x216
+    c.program_counter = 0x216;
+    c.current_opcode = 0x1216;
+    c.advance_cycles(6);
+    return 6;
+}
+
+
+static uint32_t block_212(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 212  9090  SNE V0, V9
+    c.program_counter = v[0x0] != v[0x9] ? 0x216 : 0x214;
+    c.current_opcode = 0x9090;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_214 = {nullptr, 0xF565, 0x565, 0x5, 0x6, 0x5, 0x65};
+
+static uint32_t block_214(Chip8 &c)
+{
+    // 214  F565  LD V5, [I]
+    Chip8::op_FX65<Q>(c, op_214);
+    c.program_counter = 0x216;
+    c.current_opcode = 0xF565;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_216(Chip8 &c)
+{
+    // 216  1218  JP 0x218
+    c.program_counter = 0x218;
+    c.current_opcode = 0x1218;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_218(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 218  B202  JP V0, 0x202
+    c.program_counter = (v[0x0] + 0x202) & 0xFFF;
+    c.current_opcode = 0xB202;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+    {&block_202, 0x202, 0x204, 1, 0},
+    {&block_204, 0x204, 0x206, 1, 0},
+    {&block_206, 0x206, 0x212, 6, 2},
+    {&block_212, 0x212, 0x214, 1, 0},
+    {&block_214, 0x214, 0x216, 1, 0},
+    {&block_216, 0x216, 0x218, 1, 0},
+    {&block_218, 0x218, 0x21A, 1, 0},
+};
+
+} // namespace check_vip_10_blocks
+
+static const Chip8AotProgram check_vip_10 = {
+    QuirkProfile::CosmacVip, check_vip_10_blocks::blocks, sizeof(check_vip_10_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_10_blocks::image, 0x200, 0x21A, check_vip_10_blocks::code_pages
+};
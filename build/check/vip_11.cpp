@@ -0,0 +1,55 @@
+// Generated by recompile from build/check/vip_11.ch8 with vip quirks, don't edit.
+// 9 reached instructions, 1 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_vip_11_blocks {
+
+typedef CosmacVipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xF4, 0x18, 0x8C, 0x13, 0x67, 0x77, 0x64, 0x8D, 0x00, 0xFC, 0xFF, 0x18, 0xCE, 0xBA, 0x85, 0x24,
+    0xB2, 0x12,
+};
+
+static const Chip8::DecodedOp op_208 = {nullptr, 0x00FC, 0x0FC, 0x0, 0xF, 0xC, 0xFC};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F418  LD ST, V4
+    c.sound_timer = v[0x4];
+    // 202  8C13  XOR VC, V1
+    v[0xC] ^= v[0x1];
+    // 204  6777  LD V7, 0x77
+    v[0x7] = 0x77;
+    // 206  648D  LD V4, 0x8D
+    v[0x4] = 0x8D;
+    // 208  00FC  SCL
+    if (c.extendedScreenMode) Chip8::op_00FC<true>(c, op_208); else Chip8::op_00FC<false>(c, op_208);
+    // 20A  FF18  LD ST, VF
+    c.sound_timer = v[0xF];
+    // 20C  CEBA  RND VE, 0xBA
+    v[0xE] = static_cast<uint8_t>(c.next_random() & 0xBA);
+    // 20E  8524  ADD V5, V2
+    { unsigned sum = v[0x5] + v[0x2]; v[0x5] = static_cast<uint8_t>(sum); v[0xF] = sum > 255u; }
+    // 210  B212  JP V0, 0x212
+    c.program_counter = (v[0x0] + 0x212) & 0xFFF;
+    c.current_opcode = 0xB212;
+    c.advance_cycles(9);
+    return 9;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x212, 9, 6},
+};
+
+} // namespace check_vip_11_blocks
+
+static const Chip8AotProgram check_vip_11 = {
+    QuirkProfile::CosmacVip, check_vip_11_blocks::blocks, sizeof(check_vip_11_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_vip_11_blocks::image, 0x200, 0x212, check_vip_11_blocks::code_pages
+};
@@ -0,0 +1,42 @@
+// Generated by recompile from build/check/xochip_00.ch8 with xochip quirks, don't edit.
+// 3 reached instructions, 1 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_00_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x00, 0xFB, 0x8F, 0xD7, 0xB2, 0x1A,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0x00FB, 0x0FB, 0x0, 0xF, 0xB, 0xFB};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  00FB  SCR
+    if (c.extendedScreenMode) Chip8::op_00FB<true>(c, op_200); else Chip8::op_00FB<false>(c, op_200);
+    // 202  8FD7  SUBN VF, VD
+    { uint8_t flag = v[0xD] >= v[0xF]; v[0xF] = v[0xD] - v[0xF]; v[0xF] = flag; }
+    // 204  B21A  JP V0, 0x21A
+    c.program_counter = (v[0x0] + 0x21A) & 0xFFF;
+    c.current_opcode = 0xB21A;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x206, 3, 0},
+};
+
+} // namespace check_xochip_00_blocks
+
+static const Chip8AotProgram check_xochip_00 = {
+    QuirkProfile::XoChip, check_xochip_00_blocks::blocks, sizeof(check_xochip_00_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_00_blocks::image, 0x200, 0x206, check_xochip_00_blocks::code_pages
+};
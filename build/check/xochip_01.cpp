@@ -0,0 +1,138 @@
+// Generated by recompile from build/check/xochip_01.ch8 with xochip quirks, don't edit.
+// 17 reached instructions, 6 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_01_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000300ull;
+
+static const uint8_t image[] = {
+    0x22, 0x36, 0x7C, 0xAE, 0xA3, 0x00, 0xFE, 0x1E, 0x8D, 0xB1, 0xCA, 0x9E, 0x4A, 0x00, 0x22, 0x40,
+    0xFF, 0x15, 0x12, 0x12, 0x00, 0xEE, 0x59, 0xB0, 0x81, 0x54, 0x12, 0x1A, 0xF8, 0x07, 0x83, 0x64,
+    0x30, 0x02, 0x00, 0xEE, 0x93, 0xA0, 0xCD, 0xCD, 0xA2, 0x0A, 0xF9, 0x30, 0x69, 0xB9, 0xFA, 0x65,
+    0x31, 0x03, 0xAD, 0x83, 0x7F, 0xC9, 0xF2, 0x33, 0xF9, 0x1E, 0x00, 0x00, 0xB2, 0x1A, 0xD4, 0xBF,
+    0x7F, 0xD6, 0xF3, 0x33, 0xF4, 0x07,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0x2236, 0x236, 0x2, 0x3, 0x6, 0x36};
+
+static uint32_t block_200(Chip8 &c)
+{
+    // 200  2236  CALL 0x236
+    c.program_counter = 0x200;
+    Chip8::op_2NNN(c, op_200);
+    c.current_opcode = 0x2236;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_202(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 202  7CAE  ADD VC, 0xAE
+    v[0xC] += 0xAE;
+    // 204  A300  LD I, 0x300
+    c.index = 0x300;
+    // 206  FE1E  ADD I, VE
+    c.index = static_cast<uint16_t>((c.index + v[0xE]) & 0xFFF);
+    // 208  8DB1  OR VD, VB
+    v[0xD] |= v[0xB];
+    // 20A  CA9E  RND VA, 0x9E
+    v[0xA] = static_cast<uint8_t>(c.next_random() & 0x9E);
+    // 20C  4A00  SNE VA, 0x00
+    c.program_counter = v[0xA] != 0x00 ? 0x210 : 0x20E;
+    c.current_opcode = 0x4A00;
+    c.advance_cycles(6);
+    return 6;
+}
+
+static const Chip8::DecodedOp op_20E = {nullptr, 0x2240, 0x240, 0x2, 0x4, 0x0, 0x40};
+
+static uint32_t block_20E(Chip8 &c)
+{
+    // 20E  2240  CALL 0x240
+    c.program_counter = 0x20E;
+    Chip8::op_2NNN(c, op_20E);
+    c.current_opcode = 0x2240;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_210(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 210  FF15  LD DT, VF
+    c.delay_timer = v[0xF];
+    c.program_counter = 0x212;
+    c.current_opcode = 0xFF15;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_236 = {nullptr, 0xF233, 0x233, 0x2, 0x3, 0x3, 0x33};
+
+static uint32_t block_236(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 236  F233  LD B, V2
+    Chip8::op_FX33(c, op_236);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x238;
+        c.current_opcode = 0xF233;
+        c.advance_cycles(1);
+        return 1;
+    }
+    // 238  F91E  ADD I, V9
+    c.index = static_cast<uint16_t>((c.index + v[0x9]) & 0xFFF);
+    c.program_counter = 0x23A;
+    c.current_opcode = 0xF91E;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8::DecodedOp op_242 = {nullptr, 0xF333, 0x333, 0x3, 0x3, 0x3, 0x33};
+
+static uint32_t block_240(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 240  7FD6  ADD VF, 0xD6
+    v[0xF] += 0xD6;
+    // 242  F333  LD B, V3
+    Chip8::op_FX33(c, op_242);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x244;
+        c.current_opcode = 0xF333;
+        c.advance_cycles(2);
+        return 2;
+    }
+    // 244  F407  LD V4, DT
+    v[0x4] = c.delay_timer;
+    c.program_counter = 0x246;
+    c.current_opcode = 0xF407;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+    {&block_202, 0x202, 0x20E, 6, 0},
+    {&block_20E, 0x20E, 0x210, 1, 0},
+    {&block_210, 0x210, 0x212, 1, 1},
+    {&block_236, 0x236, 0x23A, 2, 0},
+    {&block_240, 0x240, 0x246, 3, 3},
+};
+
+} // namespace check_xochip_01_blocks
+
+static const Chip8AotProgram check_xochip_01 = {
+    QuirkProfile::XoChip, check_xochip_01_blocks::blocks, sizeof(check_xochip_01_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_01_blocks::image, 0x200, 0x246, check_xochip_01_blocks::code_pages
+};
@@ -0,0 +1,81 @@
+// Generated by recompile from build/check/xochip_02.ch8 with xochip quirks, don't edit.
+// 10 reached instructions, 3 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_02_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0xFA, 0x65, 0xFD, 0x85, 0xF5, 0x07, 0x7F, 0xEE, 0x58, 0x40, 0xF9, 0x07, 0x85, 0x42, 0x8F, 0x57,
+    0x83, 0xB6, 0x00, 0xEE,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0xFA65, 0xA65, 0xA, 0x6, 0x5, 0x65};
+static const Chip8::DecodedOp op_202 = {nullptr, 0xFD85, 0xD85, 0xD, 0x8, 0x5, 0x85};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  FA65  LD VA, [I]
+    Chip8::op_FX65<Q>(c, op_200);
+    // 202  FD85  LD VD, R
+    Chip8::op_FX85(c, op_202);
+    // 204  F507  LD V5, DT
+    v[0x5] = c.delay_timer;
+    // 206  7FEE  ADD VF, 0xEE
+    v[0xF] += 0xEE;
+    // 208  5840  SE V8, V4
+    c.program_counter = v[0x8] == v[0x4] ? 0x20C : 0x20A;
+    c.current_opcode = 0x5840;
+    c.advance_cycles(5);
+    return 5;
+}
+
+
+static uint32_t block_20A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20A  F907  LD V9, DT
+    v[0x9] = c.delay_timer;
+    c.program_counter = 0x20C;
+    c.current_opcode = 0xF907;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_212 = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_20C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20C  8542  AND V5, V4
+    v[0x5] &= v[0x4];
+    // 20E  8F57  SUBN VF, V5
+    { uint8_t flag = v[0x5] >= v[0xF]; v[0xF] = v[0x5] - v[0xF]; v[0xF] = flag; }
+    // 210  83B6  SHR V3, VB
+    { uint8_t s = v[0xB]; v[0x3] = s >> 1; v[0xF] = s & 1; }
+    // 212  00EE  RET
+    c.program_counter = 0x212;
+    Chip8::op_00EE(c, op_212);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(4);
+    return 4;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x20A, 5, 3},
+    {&block_20A, 0x20A, 0x20C, 1, 1},
+    {&block_20C, 0x20C, 0x214, 4, 0},
+};
+
+} // namespace check_xochip_02_blocks
+
+static const Chip8AotProgram check_xochip_02 = {
+    QuirkProfile::XoChip, check_xochip_02_blocks::blocks, sizeof(check_xochip_02_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_02_blocks::image, 0x200, 0x214, check_xochip_02_blocks::code_pages
+};
@@ -0,0 +1,154 @@
+// Generated by recompile from build/check/xochip_03.ch8 with xochip quirks, don't edit.
+// 23 reached instructions, 7 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_03_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000300ull;
+
+static const uint8_t image[] = {
+    0xF9, 0x15, 0x80, 0x10, 0x7D, 0xBB, 0xFB, 0x55, 0xFD, 0x07, 0x3D, 0x00, 0x12, 0x08, 0x72, 0x99,
+    0x64, 0xC8, 0xF8, 0x07, 0x12, 0x3A, 0xFC, 0x55, 0x12, 0x08, 0xC0, 0x47, 0x12, 0x0E, 0x70, 0x0E,
+    0x12, 0x28, 0x47, 0x03, 0x85, 0x81, 0x80, 0xE7, 0x6D, 0x49, 0x12, 0x2A, 0x00, 0xC3, 0xF9, 0x1E,
+    0xCD, 0xB5, 0xB2, 0x2E, 0xFC, 0x33, 0xF9, 0x65, 0x6A, 0x4F, 0x41, 0x02, 0x65, 0xA4, 0x00, 0xFB,
+    0x68, 0xE2, 0xC0, 0x4C, 0x6E, 0x50, 0xF4, 0x15, 0xF6, 0x15, 0xF3, 0x55, 0x88, 0x20, 0x00, 0xFB,
+};
+
+static const Chip8::DecodedOp op_206 = {nullptr, 0xFB55, 0xB55, 0xB, 0x5, 0x5, 0x55};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F915  LD DT, V9
+    c.delay_timer = v[0x9];
+    // 202  8010  LD V0, V1
+    v[0x0] = v[0x1];
+    // 204  7DBB  ADD VD, 0xBB
+    v[0xD] += 0xBB;
+    // 206  FB55  LD [I], VB
+    Chip8::op_FX55<Q>(c, op_206);
+    c.program_counter = 0x208;
+    c.current_opcode = 0xFB55;
+    c.advance_cycles(4);
+    return 4;
+}
+
+
+static uint32_t block_20A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20A  3D00  SE VD, 0x00
+    c.program_counter = v[0xD] == 0x00 ? 0x20E : 0x20C;
+    c.current_opcode = 0x3D00;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20C(Chip8 &c)
+{
+    // 20C  1208  JP 0x208
+    c.program_counter = 0x208;
+    c.current_opcode = 0x1208;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20E  7299  ADD V2, 0x99
+    v[0x2] += 0x99;
+    // 210  64C8  LD V4, 0xC8
+    v[0x4] = 0xC8;
+    // 212  F807  LD V8, DT
+    v[0x8] = c.delay_timer;
+    // 214  123A  JP 0x23A
+    c.program_counter = 0x23A;
+    c.current_opcode = 0x123A;
+    c.advance_cycles(4);
+    return 4;
+}
+
+
+static uint32_t block_23A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 23A  4102  SNE V1, 0x02
+    c.program_counter = v[0x1] != 0x02 ? 0x23E : 0x23C;
+    c.current_opcode = 0x4102;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_23C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 23C  65A4  LD V5, 0xA4
+    v[0x5] = 0xA4;
+    c.program_counter = 0x23E;
+    c.current_opcode = 0x65A4;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_23E = {nullptr, 0x00FB, 0x0FB, 0x0, 0xF, 0xB, 0xFB};
+static const Chip8::DecodedOp op_24A = {nullptr, 0xF355, 0x355, 0x3, 0x5, 0x5, 0x55};
+static const Chip8::DecodedOp op_24E = {nullptr, 0x00FB, 0x0FB, 0x0, 0xF, 0xB, 0xFB};
+
+static uint32_t block_23E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 23E  00FB  SCR
+    if (c.extendedScreenMode) Chip8::op_00FB<true>(c, op_23E); else Chip8::op_00FB<false>(c, op_23E);
+    // 240  68E2  LD V8, 0xE2
+    v[0x8] = 0xE2;
+    // 242  C04C  RND V0, 0x4C
+    v[0x0] = static_cast<uint8_t>(c.next_random() & 0x4C);
+    // 244  6E50  LD VE, 0x50
+    v[0xE] = 0x50;
+    // 246  F415  LD DT, V4
+    c.delay_timer = v[0x4];
+    // 248  F615  LD DT, V6
+    c.delay_timer = v[0x6];
+    // 24A  F355  LD [I], V3
+    Chip8::op_FX55<Q>(c, op_24A);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x24C;
+        c.current_opcode = 0xF355;
+        c.advance_cycles(7);
+        return 7;
+    }
+    // 24C  8820  LD V8, V2
+    v[0x8] = v[0x2];
+    // 24E  00FB  SCR
+    if (c.extendedScreenMode) Chip8::op_00FB<true>(c, op_24E); else Chip8::op_00FB<false>(c, op_24E);
+    c.program_counter = 0x250;
+    c.current_opcode = 0x00FB;
+    c.advance_cycles(9);
+    return 9;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x208, 4, 1},
+    {&block_20A, 0x20A, 0x20C, 1, 0},
+    {&block_20C, 0x20C, 0x20E, 1, 0},
+    {&block_20E, 0x20E, 0x216, 4, 3},
+    {&block_23A, 0x23A, 0x23C, 1, 0},
+    {&block_23C, 0x23C, 0x23E, 1, 0},
+    {&block_23E, 0x23E, 0x250, 9, 6},
+};
+
+} // namespace check_xochip_03_blocks
+
+static const Chip8AotProgram check_xochip_03 = {
+    QuirkProfile::XoChip, check_xochip_03_blocks::blocks, sizeof(check_xochip_03_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_03_blocks::image, 0x200, 0x250, check_xochip_03_blocks::code_pages
+};
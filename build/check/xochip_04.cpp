@@ -0,0 +1,106 @@
+// Generated by recompile from build/check/xochip_04.ch8 with xochip quirks, don't edit.
+// 8 reached instructions, 6 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_04_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x99, 0xA0, 0x55, 0x80, 0x78, 0xBB, 0xF6, 0x65, 0xDD, 0x42, 0x97, 0x10, 0x64, 0xEE, 0x00, 0xEE,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  99A0  SNE V9, VA
+    c.program_counter = v[0x9] != v[0xA] ? 0x204 : 0x202;
+    c.current_opcode = 0x99A0;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_202(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 202  5580  SE V5, V8
+    c.program_counter = v[0x5] == v[0x8] ? 0x206 : 0x204;
+    c.current_opcode = 0x5580;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_204(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 204  78BB  ADD V8, 0xBB
+    v[0x8] += 0xBB;
+    c.program_counter = 0x206;
+    c.current_opcode = 0x78BB;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_206 = {nullptr, 0xF665, 0x665, 0x6, 0x6, 0x5, 0x65};
+static const Chip8::DecodedOp op_208 = {nullptr, 0xDD42, 0xD42, 0xD, 0x4, 0x2, 0x42};
+
+static uint32_t block_206(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 206  F665  LD V6, [I]
+    Chip8::op_FX65<Q>(c, op_206);
+    // 208  DD42  DRW VD, V4, 2
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_208); else Chip8::op_DXYN<false, Q>(c, op_208);
+    // 20A  9710  SNE V7, V1
+    c.program_counter = v[0x7] != v[0x1] ? 0x20E : 0x20C;
+    c.current_opcode = 0x9710;
+    c.advance_cycles(3);
+    return 3;
+}
+
+
+static uint32_t block_20C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20C  64EE  LD V4, 0xEE
+    v[0x4] = 0xEE;
+    c.program_counter = 0x20E;
+    c.current_opcode = 0x64EE;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20E = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_20E(Chip8 &c)
+{
+    // 20E  00EE  RET
+    c.program_counter = 0x20E;
+    Chip8::op_00EE(c, op_20E);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+    {&block_202, 0x202, 0x204, 1, 0},
+    {&block_204, 0x204, 0x206, 1, 0},
+    {&block_206, 0x206, 0x20C, 3, 0},
+    {&block_20C, 0x20C, 0x20E, 1, 0},
+    {&block_20E, 0x20E, 0x210, 1, 0},
+};
+
+} // namespace check_xochip_04_blocks
+
+static const Chip8AotProgram check_xochip_04 = {
+    QuirkProfile::XoChip, check_xochip_04_blocks::blocks, sizeof(check_xochip_04_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_04_blocks::image, 0x200, 0x210, check_xochip_04_blocks::code_pages
+};
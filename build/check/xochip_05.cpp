@@ -0,0 +1,236 @@
+// Generated by recompile from build/check/xochip_05.ch8 with xochip quirks, don't edit.
+// 38 reached instructions, 10 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_05_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000300ull;
+
+static const uint8_t image[] = {
+    0xF4, 0x33, 0xE4, 0xA1, 0x4C, 0x00, 0x3B, 0x02, 0xF6, 0x07, 0xF8, 0x55, 0xF0, 0x07, 0x00, 0xFC,
+    0xF7, 0x1E, 0x7F, 0x7E, 0xF9, 0x55, 0x66, 0xA3, 0xFA, 0x07, 0x8A, 0x87, 0x45, 0x01, 0x4D, 0x02,
+    0xCE, 0xAD, 0x71, 0x08, 0xF4, 0x07, 0x67, 0x60, 0xDB, 0x23, 0xF0, 0x15, 0xFD, 0x15, 0xDE, 0x52,
+    0x6F, 0x46, 0xF6, 0x18, 0x65, 0x53, 0x89, 0x40, 0x80, 0x2E, 0x00, 0xC3, 0xFB, 0x1E, 0xF3, 0x1E,
+    0xDB, 0x54, 0x66, 0xE0, 0x59, 0x30, 0xF3, 0x85, 0xD1, 0x11,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0xF433, 0x433, 0x4, 0x3, 0x3, 0x33};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  F433  LD B, V4
+    Chip8::op_FX33(c, op_200);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x202;
+        c.current_opcode = 0xF433;
+        c.advance_cycles(1);
+        return 1;
+    }
+    // 202  E4A1  SKNP V4
+    c.program_counter = c.keys[v[0x4] & 0xF] == 0 ? 0x206 : 0x204;
+    c.current_opcode = 0xE4A1;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_204(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 204  4C00  SNE VC, 0x00
+    c.program_counter = v[0xC] != 0x00 ? 0x208 : 0x206;
+    c.current_opcode = 0x4C00;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_206(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 206  3B02  SE VB, 0x02
+    c.program_counter = v[0xB] == 0x02 ? 0x20A : 0x208;
+    c.current_opcode = 0x3B02;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_208(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 208  F607  LD V6, DT
+    v[0x6] = c.delay_timer;
+    c.program_counter = 0x20A;
+    c.current_opcode = 0xF607;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20A = {nullptr, 0xF855, 0x855, 0x8, 0x5, 0x5, 0x55};
+static const Chip8::DecodedOp op_20E = {nullptr, 0x00FC, 0x0FC, 0x0, 0xF, 0xC, 0xFC};
+static const Chip8::DecodedOp op_214 = {nullptr, 0xF955, 0x955, 0x9, 0x5, 0x5, 0x55};
+
+static uint32_t block_20A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20A  F855  LD [I], V8
+    Chip8::op_FX55<Q>(c, op_20A);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x20C;
+        c.current_opcode = 0xF855;
+        c.advance_cycles(1);
+        return 1;
+    }
+    // 20C  F007  LD V0, DT
+    v[0x0] = c.delay_timer;
+    // 20E  00FC  SCL
+    if (c.extendedScreenMode) Chip8::op_00FC<true>(c, op_20E); else Chip8::op_00FC<false>(c, op_20E);
+    // 210  F71E  ADD I, V7
+    c.index = static_cast<uint16_t>((c.index + v[0x7]) & 0xFFF);
+    // 212  7F7E  ADD VF, 0x7E
+    v[0xF] += 0x7E;
+    // 214  F955  LD [I], V9
+    Chip8::op_FX55<Q>(c, op_214);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x216;
+        c.current_opcode = 0xF955;
+        c.advance_cycles(6);
+        return 6;
+    }
+    // 216  66A3  LD V6, 0xA3
+    v[0x6] = 0xA3;
+    // 218  FA07  LD VA, DT
+    v[0xA] = c.delay_timer;
+    // 21A  8A87  SUBN VA, V8
+    { uint8_t flag = v[0x8] >= v[0xA]; v[0xA] = v[0x8] - v[0xA]; v[0xF] = flag; }
+    // 21C  4501  SNE V5, 0x01
+    c.program_counter = v[0x5] != 0x01 ? 0x220 : 0x21E;
+    c.current_opcode = 0x4501;
+    c.advance_cycles(10);
+    return 10;
+}
+
+
+static uint32_t block_21E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 21E  4D02  SNE VD, 0x02
+    c.program_counter = v[0xD] != 0x02 ? 0x222 : 0x220;
+    c.current_opcode = 0x4D02;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_220(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 220  CEAD  RND VE, 0xAD
+    v[0xE] = static_cast<uint8_t>(c.next_random() & 0xAD);
+    c.program_counter = 0x222;
+    c.current_opcode = 0xCEAD;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_228 = {nullptr, 0xDB23, 0xB23, 0xB, 0x2, 0x3, 0x23};
+static const Chip8::DecodedOp op_22E = {nullptr, 0xDE52, 0xE52, 0xE, 0x5, 0x2, 0x52};
+static const Chip8::DecodedOp op_23A = {nullptr, 0x00C3, 0x0C3, 0x0, 0xC, 0x3, 0xC3};
+static const Chip8::DecodedOp op_240 = {nullptr, 0xDB54, 0xB54, 0xB, 0x5, 0x4, 0x54};
+
+static uint32_t block_222(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 222  7108  ADD V1, 0x08
+    v[0x1] += 0x08;
+    // 224  F407  LD V4, DT
+    v[0x4] = c.delay_timer;
+    // 226  6760  LD V7, 0x60
+    v[0x7] = 0x60;
+    // 228  DB23  DRW VB, V2, 3
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_228); else Chip8::op_DXYN<false, Q>(c, op_228);
+    // 22A  F015  LD DT, V0
+    c.delay_timer = v[0x0];
+    // 22C  FD15  LD DT, VD
+    c.delay_timer = v[0xD];
+    // 22E  DE52  DRW VE, V5, 2
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_22E); else Chip8::op_DXYN<false, Q>(c, op_22E);
+    // 230  6F46  LD VF, 0x46
+    v[0xF] = 0x46;
+    // 232  F618  LD ST, V6
+    c.sound_timer = v[0x6];
+    // 234  6553  LD V5, 0x53
+    v[0x5] = 0x53;
+    // 236  8940  LD V9, V4
+    v[0x9] = v[0x4];
+    // 238  802E  SHL V0, V2
+    { uint8_t s = v[0x2]; v[0x0] = static_cast<uint8_t>(s << 1); v[0xF] = s >> 7; }
+    // 23A  00C3  SCD 3
+    if (c.extendedScreenMode) Chip8::op_00CN<true>(c, op_23A); else Chip8::op_00CN<false>(c, op_23A);
+    // 23C  FB1E  ADD I, VB
+    c.index = static_cast<uint16_t>((c.index + v[0xB]) & 0xFFF);
+    // 23E  F31E  ADD I, V3
+    c.index = static_cast<uint16_t>((c.index + v[0x3]) & 0xFFF);
+    // 240  DB54  DRW VB, V5, 4
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_240); else Chip8::op_DXYN<false, Q>(c, op_240);
+    // 242  66E0  LD V6, 0xE0
+    v[0x6] = 0xE0;
+    // 244  5930  SE V9, V3
+    c.program_counter = v[0x9] == v[0x3] ? 0x248 : 0x246;
+    c.current_opcode = 0x5930;
+    c.advance_cycles(18);
+    return 18;
+}
+
+static const Chip8::DecodedOp op_246 = {nullptr, 0xF385, 0x385, 0x3, 0x8, 0x5, 0x85};
+
+static uint32_t block_246(Chip8 &c)
+{
+    // 246  F385  LD V3, R
+    Chip8::op_FX85(c, op_246);
+    c.program_counter = 0x248;
+    c.current_opcode = 0xF385;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_248 = {nullptr, 0xD111, 0x111, 0x1, 0x1, 0x1, 0x11};
+
+static uint32_t block_248(Chip8 &c)
+{
+    // 248  D111  DRW V1, V1, 1
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_248); else Chip8::op_DXYN<false, Q>(c, op_248);
+    c.program_counter = 0x24A;
+    c.current_opcode = 0xD111;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x204, 2, 0},
+    {&block_204, 0x204, 0x206, 1, 0},
+    {&block_206, 0x206, 0x208, 1, 0},
+    {&block_208, 0x208, 0x20A, 1, 1},
+    {&block_20A, 0x20A, 0x21E, 10, 8},
+    {&block_21E, 0x21E, 0x220, 1, 0},
+    {&block_220, 0x220, 0x222, 1, 0},
+    {&block_222, 0x222, 0x246, 18, 9},
+    {&block_246, 0x246, 0x248, 1, 0},
+    {&block_248, 0x248, 0x24A, 1, 0},
+};
+
+} // namespace check_xochip_05_blocks
+
+static const Chip8AotProgram check_xochip_05 = {
+    QuirkProfile::XoChip, check_xochip_05_blocks::blocks, sizeof(check_xochip_05_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_05_blocks::image, 0x200, 0x24A, check_xochip_05_blocks::code_pages
+};
@@ -0,0 +1,110 @@
+// Generated by recompile from build/check/xochip_06.ch8 with xochip quirks, don't edit.
+// 9 reached instructions, 6 compiled blocks, 1 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_06_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x4F, 0x00, 0xF9, 0x15, 0x12, 0x2C, 0x00, 0xFE, 0x6B, 0xDF, 0xFF, 0x85, 0xF2, 0x55, 0xFF, 0x07,
+    0x64, 0x06, 0x80, 0xA1, 0x9B, 0x20, 0xCF, 0x8C, 0xF4, 0x07, 0x75, 0x62, 0x6B, 0x23, 0x6A, 0x64,
+    0x22, 0x2E, 0x87, 0xE0, 0x00, 0x00, 0xF0, 0x07, 0x90, 0x20, 0x88, 0xFE, 0xF5, 0x07, 0xF8, 0x07,
+    0x22, 0x2E, 0x70, 0x74, 0xF9, 0x85, 0xB2, 0x10,
+};
+
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  4F00  SNE VF, 0x00
+    c.program_counter = v[0xF] != 0x00 ? 0x204 : 0x202;
+    c.current_opcode = 0x4F00;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_202(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 202  F915  LD DT, V9
+    c.delay_timer = v[0x9];
+    c.program_counter = 0x204;
+    c.current_opcode = 0xF915;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_204(Chip8 &c)
+{
+    // 204  122C  JP 0x22C
+    c.program_counter = 0x22C;
+    c.current_opcode = 0x122C;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_22C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 22C  F507  LD V5, DT
+    v[0x5] = c.delay_timer;
+    c.program_counter = 0x22E;
+    c.current_opcode = 0xF507;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_230 = {nullptr, 0x222E, 0x22E, 0x2, 0x2, 0xE, 0x2E};
+
+static uint32_t block_22E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 22E  F807  LD V8, DT
+    v[0x8] = c.delay_timer;
+    // 230  222E  CALL 0x22E
+    c.program_counter = 0x230;
+    Chip8::op_2NNN(c, op_230);
+    c.current_opcode = 0x222E;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8::DecodedOp op_234 = {nullptr, 0xF985, 0x985, 0x9, 0x8, 0x5, 0x85};
+
+static uint32_t block_232(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 232  7074  ADD V0, 0x74
+    v[0x0] += 0x74;
+    // 234  F985  LD V9, R
+    Chip8::op_FX85(c, op_234);
+    // 236  B210  JP V0, 0x210
+    c.program_counter = (v[0x0] + 0x210) & 0xFFF;
+    c.current_opcode = 0xB210;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x202, 1, 0},
+    {&block_202, 0x202, 0x204, 1, 1},
+    {&block_204, 0x204, 0x206, 1, 0},
+    {&block_22C, 0x22C, 0x22E, 1, 1},
+    {&block_22E, 0x22E, 0x232, 2, 1},
+    {&block_232, 0x232, 0x238, 3, 0},
+};
+
+} // namespace check_xochip_06_blocks
+
+static const Chip8AotProgram check_xochip_06 = {
+    QuirkProfile::XoChip, check_xochip_06_blocks::blocks, sizeof(check_xochip_06_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_06_blocks::image, 0x200, 0x238, check_xochip_06_blocks::code_pages
+};
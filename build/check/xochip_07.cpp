@@ -0,0 +1,81 @@
+// Generated by recompile from build/check/xochip_07.ch8 with xochip quirks, don't edit.
+// 10 reached instructions, 3 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_07_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x00, 0xFF, 0x8E, 0x50, 0xCF, 0x2C, 0x70, 0xB1, 0xFE, 0x18, 0x32, 0x02, 0x8C, 0x03, 0x00, 0xE0,
+    0xF2, 0x1E, 0x00, 0xFD,
+};
+
+static const Chip8::DecodedOp op_200 = {nullptr, 0x00FF, 0x0FF, 0x0, 0xF, 0xF, 0xFF};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  00FF  HIGH
+    Chip8::op_00FF(c, op_200);
+    // 202  8E50  LD VE, V5
+    v[0xE] = v[0x5];
+    // 204  CF2C  RND VF, 0x2C
+    v[0xF] = static_cast<uint8_t>(c.next_random() & 0x2C);
+    // 206  70B1  ADD V0, 0xB1
+    v[0x0] += 0xB1;
+    // 208  FE18  LD ST, VE
+    c.sound_timer = v[0xE];
+    // 20A  3202  SE V2, 0x02
+    c.program_counter = v[0x2] == 0x02 ? 0x20E : 0x20C;
+    c.current_opcode = 0x3202;
+    c.advance_cycles(6);
+    return 6;
+}
+
+
+static uint32_t block_20C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20C  8C03  XOR VC, V0
+    v[0xC] ^= v[0x0];
+    c.program_counter = 0x20E;
+    c.current_opcode = 0x8C03;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20E = {nullptr, 0x00E0, 0x0E0, 0x0, 0xE, 0x0, 0xE0};
+static const Chip8::DecodedOp op_212 = {nullptr, 0x00FD, 0x0FD, 0x0, 0xF, 0xD, 0xFD};
+
+static uint32_t block_20E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20E  00E0  CLS
+    if (c.extendedScreenMode) Chip8::op_00E0<true>(c, op_20E); else Chip8::op_00E0<false>(c, op_20E);
+    // 210  F21E  ADD I, V2
+    c.index = static_cast<uint16_t>((c.index + v[0x2]) & 0xFFF);
+    // 212  00FD  EXIT
+    c.program_counter = 0x212;
+    Chip8::op_00FD(c, op_212);
+    c.current_opcode = 0x00FD;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x20C, 6, 5},
+    {&block_20C, 0x20C, 0x20E, 1, 0},
+    {&block_20E, 0x20E, 0x214, 3, 0},
+};
+
+} // namespace check_xochip_07_blocks
+
+static const Chip8AotProgram check_xochip_07 = {
+    QuirkProfile::XoChip, check_xochip_07_blocks::blocks, sizeof(check_xochip_07_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_07_blocks::image, 0x200, 0x214, check_xochip_07_blocks::code_pages
+};
@@ -0,0 +1,41 @@
+// Generated by recompile from build/check/xochip_08.ch8 with xochip quirks, don't edit.
+// 3 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_08_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x88, 0xA1, 0xD7, 0xDE,
+};
+
+static const Chip8::DecodedOp op_202 = {nullptr, 0xD7DE, 0x7DE, 0x7, 0xD, 0xE, 0xDE};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  88A1  OR V8, VA
+    v[0x8] |= v[0xA];
+    // 202  D7DE  DRW V7, VD, 14
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_202); else Chip8::op_DXYN<false, Q>(c, op_202);
+    c.program_counter = 0x204;
+    c.current_opcode = 0xD7DE;
+    c.advance_cycles(2);
+    return 2;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x204, 2, 0},
+};
+
+} // namespace check_xochip_08_blocks
+
+static const Chip8AotProgram check_xochip_08 = {
+    QuirkProfile::XoChip, check_xochip_08_blocks::blocks, sizeof(check_xochip_08_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_08_blocks::image, 0x200, 0x204, check_xochip_08_blocks::code_pages
+};
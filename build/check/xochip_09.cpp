@@ -0,0 +1,43 @@
+// Generated by recompile from build/check/xochip_09.ch8 with xochip quirks, don't edit.
+// 3 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_09_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x6B, 0x0A, 0xFD, 0x18, 0x00, 0xEE,
+};
+
+static const Chip8::DecodedOp op_204 = {nullptr, 0x00EE, 0x0EE, 0x0, 0xE, 0xE, 0xEE};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  6B0A  LD VB, 0x0A
+    v[0xB] = 0x0A;
+    // 202  FD18  LD ST, VD
+    c.sound_timer = v[0xD];
+    // 204  00EE  RET
+    c.program_counter = 0x204;
+    Chip8::op_00EE(c, op_204);
+    c.current_opcode = 0x00EE;
+    c.advance_cycles(3);
+    return 3;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x206, 3, 2},
+};
+
+} // namespace check_xochip_09_blocks
+
+static const Chip8AotProgram check_xochip_09 = {
+    QuirkProfile::XoChip, check_xochip_09_blocks::blocks, sizeof(check_xochip_09_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_09_blocks::image, 0x200, 0x206, check_xochip_09_blocks::code_pages
+};
@@ -0,0 +1,44 @@
+// Generated by recompile from build/check/xochip_10.ch8 with xochip quirks, don't edit.
+// 4 reached instructions, 1 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_10_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000100ull;
+
+static const uint8_t image[] = {
+    0x6B, 0xAD, 0xD7, 0x0B, 0x63, 0x86, 0x12, 0x00,
+};
+
+static const Chip8::DecodedOp op_202 = {nullptr, 0xD70B, 0x70B, 0x7, 0x0, 0xB, 0x0B};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  6BAD  LD VB, 0xAD
+    v[0xB] = 0xAD;
+    // 202  D70B  DRW V7, V0, 11
+    if (c.extendedScreenMode) Chip8::op_DXYN<true, Q>(c, op_202); else Chip8::op_DXYN<false, Q>(c, op_202);
+    // 204  6386  LD V3, 0x86
+    v[0x3] = 0x86;
+    // 206  1200  JP 0x200
+    c.program_counter = 0x200;
+    c.current_opcode = 0x1200;
+    c.advance_cycles(4);
+    return 4;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x208, 4, 0},
+};
+
+} // namespace check_xochip_10_blocks
+
+static const Chip8AotProgram check_xochip_10 = {
+    QuirkProfile::XoChip, check_xochip_10_blocks::blocks, sizeof(check_xochip_10_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_10_blocks::image, 0x200, 0x208, check_xochip_10_blocks::code_pages
+};
@@ -0,0 +1,167 @@
+// Generated by recompile from build/check/xochip_11.ch8 with xochip quirks, don't edit.
+// 22 reached instructions, 8 compiled blocks, 0 indirect jumps.
+
+#pragma once
+
+#include "aot.cpp"
+
+namespace check_xochip_11_blocks {
+
+typedef XoChipQuirks Q;
+static const uint64_t code_pages = 0x0000000000000300ull;
+
+static const uint8_t image[] = {
+    0x87, 0x15, 0xFF, 0x1E, 0x79, 0x6F, 0x22, 0x38, 0x5B, 0x40, 0x8A, 0x23, 0xF3, 0x33, 0x70, 0xA4,
+    0x64, 0x57, 0xF7, 0x33, 0x69, 0x6E, 0xA2, 0x08, 0xFB, 0x0A, 0x78, 0x31, 0x12, 0x32, 0xFB, 0x33,
+    0x71, 0x20, 0x3E, 0x01, 0xB2, 0x4A, 0xA2, 0x27, 0xFF, 0x65, 0xB2, 0x18, 0xF3, 0x18, 0x3B, 0x03,
+    0xB2, 0x0E, 0xCF, 0x44, 0x7D, 0xD1, 0xF2, 0x07, 0x12, 0x4E, 0x12, 0x12, 0x3C, 0x02, 0xF2, 0x1E,
+    0xA2, 0x42, 0x8D, 0xBE, 0x64, 0xBC, 0x65, 0x61, 0x84, 0x25, 0x6E, 0x59, 0x40, 0x02, 0x45, 0x02,
+};
+
+static const Chip8::DecodedOp op_206 = {nullptr, 0x2238, 0x238, 0x2, 0x3, 0x8, 0x38};
+
+static uint32_t block_200(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 200  8715  SUB V7, V1
+    { uint8_t flag = v[0x7] >= v[0x1]; v[0x7] -= v[0x1]; v[0xF] = flag; }
+    // 202  FF1E  ADD I, VF
+    c.index = static_cast<uint16_t>((c.index + v[0xF]) & 0xFFF);
+    // 204  796F  ADD V9, 0x6F
+    v[0x9] += 0x6F;
+    // 206  2238  CALL 0x238
+    c.program_counter = 0x206;
+    Chip8::op_2NNN(c, op_206);
+    c.current_opcode = 0x2238;
+    c.advance_cycles(4);
+    return 4;
+}
+
+
+static uint32_t block_208(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 208  5B40  SE VB, V4
+    c.program_counter = v[0xB] == v[0x4] ? 0x20C : 0x20A;
+    c.current_opcode = 0x5B40;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_20A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20A  8A23  XOR VA, V2
+    v[0xA] ^= v[0x2];
+    c.program_counter = 0x20C;
+    c.current_opcode = 0x8A23;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8::DecodedOp op_20C = {nullptr, 0xF333, 0x333, 0x3, 0x3, 0x3, 0x33};
+static const Chip8::DecodedOp op_212 = {nullptr, 0xF733, 0x733, 0x7, 0x3, 0x3, 0x33};
+
+static uint32_t block_20C(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 20C  F333  LD B, V3
+    Chip8::op_FX33(c, op_20C);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x20E;
+        c.current_opcode = 0xF333;
+        c.advance_cycles(1);
+        return 1;
+    }
+    // 20E  70A4  ADD V0, 0xA4
+    v[0x0] += 0xA4;
+    // 210  6457  LD V4, 0x57
+    v[0x4] = 0x57;
+    // 212  F733  LD B, V7
+    Chip8::op_FX33(c, op_212);
+    if (c.code_dirty_pages & code_pages)
+    {
+        c.program_counter = 0x214;
+        c.current_opcode = 0xF733;
+        c.advance_cycles(4);
+        return 4;
+    }
+    // 214  696E  LD V9, 0x6E
+    v[0x9] = 0x6E;
+    // 216  A208  LD I, 0x208
+    c.index = 0x208;
+    c.program_counter = 0x218;
+    c.current_opcode = 0xA208;
+    c.advance_cycles(6);
+    return 6;
+}
+
+
+static uint32_t block_21A(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 21A  7831  ADD V8, 0x31
+    v[0x8] += 0x31;
+    // 21C  1232  JP 0x232
+    c.program_counter = 0x232;
+    c.current_opcode = 0x1232;
+    c.advance_cycles(2);
+    return 2;
+}
+
+
+static uint32_t block_232(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 232  CF44  RND VF, 0x44
+    v[0xF] = static_cast<uint8_t>(c.next_random() & 0x44);
+    // 234  7DD1  ADD VD, 0xD1
+    v[0xD] += 0xD1;
+    // 236  F207  LD V2, DT
+    v[0x2] = c.delay_timer;
+    c.program_counter = 0x238;
+    c.current_opcode = 0xF207;
+    c.advance_cycles(3);
+    return 3;
+}
+
+
+static uint32_t block_238(Chip8 &c)
+{
+    // 238  124E  JP 0x24E
+    c.program_counter = 0x24E;
+    c.current_opcode = 0x124E;
+    c.advance_cycles(1);
+    return 1;
+}
+
+
+static uint32_t block_24E(Chip8 &c)
+{
+    uint8_t* v = c.registers;
+    // 24E  4502  SNE V5, 0x02
+    c.program_counter = v[0x5] != 0x02 ? 0x252 : 0x250;
+    c.current_opcode = 0x4502;
+    c.advance_cycles(1);
+    return 1;
+}
+
+static const Chip8AotBlock blocks[] = {
+    {&block_200, 0x200, 0x208, 4, 0},
+    {&block_208, 0x208, 0x20A, 1, 0},
+    {&block_20A, 0x20A, 0x20C, 1, 0},
+    {&block_20C, 0x20C, 0x218, 6, 0},
+    {&block_21A, 0x21A, 0x21E, 2, 0},
+    {&block_232, 0x232, 0x238, 3, 3},
+    {&block_238, 0x238, 0x23A, 1, 0},
+    {&block_24E, 0x24E, 0x250, 1, 0},
+};
+
+} // namespace check_xochip_11_blocks
+
+static const Chip8AotProgram check_xochip_11 = {
+    QuirkProfile::XoChip, check_xochip_11_blocks::blocks, sizeof(check_xochip_11_blocks::blocks) / sizeof(Chip8AotBlock),
+    check_xochip_11_blocks::image, 0x200, 0x250, check_xochip_11_blocks::code_pages
+};
@@ -0,0 +1,588 @@
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "compact.cpp"
+#include "cpu.cpp"
+#include "jit.cpp"
+#include "lockstep.cpp"
+#include "movie.cpp"
+
+// Built in by make check, the ROMs written by --generate compiled with recompile
+#ifdef CHIP8_CHECK_PROGRAMS
+#include "aot.cpp"
+
+struct Chip8CheckProgram
+{
+    const char* rom;
+    const Chip8AotProgram* program;
+};
+
+#include CHIP8_CHECK_PROGRAMS
+#endif
+
+using namespace std;
+
+// Differential checks of the fast paths against plain Chip8 machines, run with make check.
+// Usage: check [--generate dir]
+// --generate writes random ROMs for every quirk profile into dir, plus dir/programs.cpp to
+// build them in once recompile has compiled each one. Without it every check built in runs:
+// both sides start from the same machine, run the same random slices with the same keys, and
+// have to agree on the stop reason and the whole save_state() after every slice.
+
+static const QuirkProfile check_profiles[] = {QuirkProfile::Original, QuirkProfile::CosmacVip,
+                                              QuirkProfile::SuperChip, QuirkProfile::XoChip};
+static const int roms_per_profile = 12;
+
+// xorshift32, so the ROMs and slices are the same on every host
+struct CheckRandom
+{
+    uint32_t state;
+
+    explicit CheckRandom(uint32_t seed) : state(seed * 0x9E3779B1u + 1) {}
+
+    uint32_t next(uint32_t range)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state % range;
+    }
+};
+
+// Mostly ALU, skips, jumps, calls and timer reads in loops, with a little of everything else
+// so blocks end on display, memory, key and mode opcodes too
+static vector<uint8_t> generate_rom(uint32_t seed)
+{
+    CheckRandom random(seed);
+    const int lengths[] = {16, 40, 90};
+    const int length = lengths[random.next(3)];
+    auto target = [&] { return 0x200 + 2 * static_cast<int>(random.next(length)); };
+
+    vector<uint16_t> ops;
+    for (int i = 0; i < length; ++i)
+    {
+        const int x = random.next(16) << 8, y = random.next(16) << 4, nn = random.next(256);
+        const uint32_t kind = random.next(30);
+        uint16_t op;
+        if (kind < 3)
+            op = 0x6000 | x | nn;
+        else if (kind < 5)
+            op = 0x7000 | x | nn;
+        else if (kind < 8)
+        {
+            const int alu[] = {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0xE};
+            op = 0x8000 | x | y | alu[random.next(9)];
+        }
+        else if (kind == 8)
+            op = 0x3000 | x | (nn & 3);
+        else if (kind == 9)
+            op = 0x4000 | x | (nn & 3);
+        else if (kind == 10)
+            op = 0x5000 | x | y;
+        else if (kind == 11)
+            op = 0x9000 | x | y;
+        else if (kind == 12)
+        {
+            const int choice = random.next(3);
+            op = 0xA000 | (choice == 0 ? target() : choice == 1 ? random.next(4096) : 0x300);
+        }
+        else if (kind == 13)
+            op = 0xF01E | x;
+        else if (kind == 14)
+            op = 0x1000 | target();
+        else if (kind == 15)
+            op = 0xF015 | x;
+        else if (kind == 16 || kind == 29)
+            op = 0xF007 | x;
+        else if (kind == 17)
+            op = 0x2000 | target();
+        else if (kind == 18)
+            op = 0x00EE;
+        else if (kind == 19)
+            op = 0xD000 | x | y | random.next(16);
+        else if (kind == 20)
+        {
+            const uint16_t screen[] = {0x00E0, 0x00FE, 0x00FF, 0x00FB, 0x00FC, 0x00C3};
+            op = screen[random.next(6)];
+        }
+        else if (kind == 21)
+            op = 0xF033 | x;
+        else if (kind == 22)
+            op = 0xF055 | x;
+        else if (kind == 23)
+            op = 0xF065 | x;
+        else if (kind == 24)
+            op = 0xC000 | x | nn;
+        else if (kind == 25)
+            op = 0xB000 | target();
+        else if (kind == 26)
+            op = 0xF018 | x;
+        else if (kind == 27)
+        {
+            const uint16_t misc[] = {0xF029, 0xF030, 0xF075, 0xF085, 0xE09E, 0xE0A1};
+            op = misc[random.next(6)] | x;
+        }
+        else
+        {
+            const uint16_t odd[] = {0x00FD, static_cast<uint16_t>(0xF00A | x), 0x0000, 0x8008,
+                                    static_cast<uint16_t>(0x1000 | (0x200 + 2 * i))};
+            op = odd[random.next(5)];
+        }
+        ops.push_back(op);
+    }
+
+    // Sometimes a delay timer poll, the loop the recompiler's timer reach is there for
+    if (random.next(10) < 3)
+    {
+        const int i = random.next(length - 3);
+        const int x = random.next(16) << 8;
+        ops[i] = 0xF007 | x;
+        ops[i + 1] = 0x3000 | x;
+        ops[i + 2] = 0x1000 | (0x200 + 2 * i);
+    }
+
+    vector<uint8_t> rom;
+    for (uint16_t op : ops)
+    {
+        rom.push_back(static_cast<uint8_t>(op >> 8));
+        rom.push_back(static_cast<uint8_t>(op & 0xFF));
+    }
+    return rom;
+}
+
+static string rom_name(QuirkProfile quirks, int i)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%s_%02d", quirk_profile_name(quirks), i);
+    return name;
+}
+
+static uint32_t rom_seed(QuirkProfile quirks, int i)
+{
+    return static_cast<uint32_t>(quirks) * 1000 + i;
+}
+
+static bool generate(const string &directory)
+{
+    FILE* programs = fopen((directory + "/programs.cpp").c_str(), "w");
+    if (programs == nullptr)
+        return false;
+    fprintf(programs, "// Generated by check --generate, don't edit.\n\n");
+
+    string table;
+    for (QuirkProfile quirks : check_profiles)
+    {
+        for (int i = 0; i < roms_per_profile; ++i)
+        {
+            const string name = rom_name(quirks, i);
+            const string path = directory + "/" + name + ".ch8";
+            const vector<uint8_t> rom = generate_rom(rom_seed(quirks, i));
+            FILE* out = fopen(path.c_str(), "wb");
+            if (out == nullptr || fwrite(rom.data(), 1, rom.size(), out) != rom.size() || fclose(out) != 0)
+            {
+                fclose(programs);
+                return false;
+            }
+            fprintf(programs, "#include \"%s.cpp\"\n", name.c_str());
+            table += "    {\"" + path + "\", &check_" + name + "},\n";
+        }
+    }
+    fprintf(programs, "\nstatic const Chip8CheckProgram check_programs[] = {\n%s};\n", table.c_str());
+    return fclose(programs) == 0;
+}
+
+// First field of Chip8State where two snapshots differ
+static const char* state_difference(const Chip8State &a, const Chip8State &b)
+{
+#define CHECK_FIELD(field) if (memcmp(&a.field, &b.field, sizeof(a.field)) != 0) return #field
+    CHECK_FIELD(cycle_count);
+    CHECK_FIELD(frame_count);
+    CHECK_FIELD(graphics);
+    CHECK_FIELD(graphics_extended);
+    CHECK_FIELD(cycles_into_frame);
+    CHECK_FIELD(rng_state);
+    CHECK_FIELD(index);
+    CHECK_FIELD(program_counter);
+    CHECK_FIELD(sp);
+    CHECK_FIELD(current_opcode);
+    CHECK_FIELD(stack);
+    CHECK_FIELD(memory);
+    CHECK_FIELD(registers);
+    CHECK_FIELD(rpl_user_flags);
+    CHECK_FIELD(delay_timer);
+    CHECK_FIELD(sound_timer);
+    CHECK_FIELD(extended_screen_mode);
+    CHECK_FIELD(status);
+#undef CHECK_FIELD
+    return nullptr;
+}
+
+// Same stop reason and snapshot, otherwise prints what differs
+static bool same_machine(const char* what, int slice, StopReason expected, StopReason actual,
+                         const Chip8 &reference, const Chip8 &other)
+{
+    Chip8State a, b;
+    reference.save_state(a);
+    other.save_state(b);
+    const char* field = state_difference(a, b);
+    if (expected == actual && field == nullptr)
+        return true;
+    printf("FAIL %s, slice %d at instruction %llu: ", what, slice, static_cast<unsigned long long>(a.cycle_count));
+    if (expected != actual)
+        printf("stopped with %s instead of %s\n", stop_reason_name(actual), stop_reason_name(expected));
+    else
+        printf("%s differs\n", field);
+    return false;
+}
+
+// A compact pool against a separate Chip8 per instance. The instances take turns on the
+// pool's workers in random order, so each one has to come back exactly as the last one left
+// it whatever the others wrote in between.
+static bool check_compact(QuirkProfile quirks, int rom_index)
+{
+    const vector<uint8_t> rom = generate_rom(rom_seed(quirks, rom_index));
+    const string name = "compact " + rom_name(quirks, rom_index);
+    const size_t instances = 8;
+    CheckRandom random(rom_seed(quirks, rom_index));
+
+    Chip8CompactPool pool(instances, quirks);
+    pool.cycles_per_frame = 5 + random.next(30);
+    if (!pool.load(rom.data(), rom.size()))
+    {
+        printf("FAIL %s: pool didn't load it\n", name.c_str());
+        return false;
+    }
+
+    // Fresh machines each time, init() alone keeps the display mode and RPL flags
+    vector<unique_ptr<Chip8>> reference(instances);
+    auto start = [&](size_t i, uint32_t seed) {
+        reference[i].reset(new Chip8(quirks));
+        reference[i]->init();
+        reference[i]->cycles_per_frame = pool.cycles_per_frame;
+        loadROM(rom.data(), rom.size(), *reference[i]);
+        reference[i]->seed_random(seed);
+        pool.open(i).seed_random(seed);
+        pool.close();
+    };
+    for (size_t i = 0; i < instances; ++i)
+        start(i, static_cast<uint32_t>(i));
+
+    for (int slice = 0; slice < 400; ++slice)
+    {
+        const size_t i = random.next(instances);
+        Chip8 &cpu = *reference[i];
+        if (random.next(50) == 0)
+        {
+            pool.reset(i);
+            start(i, 100 + slice);
+            continue;
+        }
+        if (random.next(4) == 0)
+        {
+            const uint16_t keys = static_cast<uint16_t>(random.next(0x10000));
+            chip8_set_key_mask(cpu, keys);
+            pool.set_keys(i, keys);
+        }
+
+        StopReason expected, actual;
+        if (random.next(3) == 0)
+        {
+            expected = cpu.run_frame();
+            actual = pool.run_frame(i);
+        }
+        else
+        {
+            const uint64_t n = 1 + random.next(200);
+            expected = cpu.run_cycles(n);
+            actual = pool.run_cycles(i, n);
+        }
+        const bool same = same_machine(name.c_str(), slice, expected, actual, cpu, pool.open(i));
+        pool.close();
+        if (!same)
+            return false;
+    }
+    return true;
+}
+
+// The JIT against the interpreter. Slices are long enough for blocks to get hot and be
+// compiled, and some run whole frames through run_frame_on().
+static bool check_jit(QuirkProfile quirks, int rom_index)
+{
+    const vector<uint8_t> rom = generate_rom(rom_seed(quirks, rom_index));
+    const string name = "jit " + rom_name(quirks, rom_index);
+    CheckRandom random(rom_seed(quirks, rom_index) ^ 0x4A17u);
+    Chip8 reference(quirks), jitted(quirks);
+    const uint32_t ipf = 5 + random.next(30);
+    for (Chip8* cpu : {&reference, &jitted})
+    {
+        cpu->init();
+        cpu->cycles_per_frame = ipf;
+        cpu->seed_random(rom_index);
+        loadROM(rom.data(), rom.size(), *cpu);
+    }
+    Chip8Jit jit(jitted);
+
+    for (int slice = 0; slice < 300; ++slice)
+    {
+        if (random.next(4) == 0)
+        {
+            const uint16_t keys = static_cast<uint16_t>(random.next(0x10000));
+            chip8_set_key_mask(reference, keys);
+            chip8_set_key_mask(jitted, keys);
+        }
+        StopReason expected, actual;
+        if (random.next(3) == 0)
+        {
+            expected = reference.run_frame();
+            actual = jitted.run_frame_on(jit);
+        }
+        else
+        {
+            const uint64_t n = 1 + random.next(300);
+            expected = reference.run_cycles(n);
+            actual = jit.run_cycles(n);
+        }
+        if (!same_machine(name.c_str(), slice, expected, actual, reference, jitted))
+            return false;
+        if (expected == StopReason::Halted || expected == StopReason::Fault)
+            break;
+    }
+    return true;
+}
+
+// Lockstep lanes against a separate Chip8 per lane. Every lane gets its own keys, so the
+// lanes branch apart on SKP/SKNP and FX0A and have to merge back where their paths meet.
+static bool check_lockstep(QuirkProfile quirks, int rom_index)
+{
+    vector<uint8_t> rom = generate_rom(rom_seed(quirks, rom_index));
+    const string name = "lockstep " + rom_name(quirks, rom_index);
+    const size_t lanes = 20;  // More than one vector's worth, so padding lanes are covered
+    CheckRandom random(rom_seed(quirks, rom_index) ^ 0x1A9Eu);
+
+    // The ROMs rarely read the keys, so swap in a lot more key skips and waits
+    for (size_t i = 0; i + 1 < rom.size(); i += 2)
+    {
+        if (random.next(6) != 0)
+            continue;
+        const uint16_t reads[] = {0xE09E, 0xE0A1, 0xF00A};
+        const uint16_t op = reads[random.next(3)] | static_cast<uint16_t>(random.next(16) << 8);
+        rom[i] = static_cast<uint8_t>(op >> 8);
+        rom[i + 1] = static_cast<uint8_t>(op & 0xFF);
+    }
+
+    Chip8 boot(quirks);
+    boot.init();
+    boot.cycles_per_frame = 5 + random.next(30);
+    boot.seed_random(rom_index);
+    loadROM(rom.data(), rom.size(), boot);
+    Chip8Lockstep lockstep(lanes);
+    lockstep.reset(boot);
+
+    // Each lane starts as its own machine, with the random state reset() gave it
+    vector<unique_ptr<Chip8>> reference(lanes);
+    for (size_t l = 0; l < lanes; ++l)
+    {
+        reference[l].reset(new Chip8(quirks));
+        lockstep.export_lane(l, *reference[l]);
+    }
+    unique_ptr<Chip8> lane(new Chip8(quirks));
+
+    for (int slice = 0; slice < 200; ++slice)
+    {
+        for (size_t l = 0; l < lanes; ++l)
+        {
+            if (random.next(3) == 0)
+            {
+                const uint16_t keys = static_cast<uint16_t>(random.next(0x10000));
+                chip8_set_key_mask(*reference[l], keys);
+                lockstep.set_keys(l, keys);
+            }
+        }
+        const uint64_t n = 1 + random.next(200);
+        lockstep.run_cycles(n);
+
+        bool running = false;
+        for (size_t l = 0; l < lanes; ++l)
+        {
+            const StopReason expected = reference[l]->run_cycles(n);
+            lockstep.export_lane(l, *lane);
+            const string what = name + " lane " + to_string(l);
+            if (!same_machine(what.c_str(), slice, expected, lockstep.lane_status(l), *reference[l], *lane))
+                return false;
+            running = running || (expected != StopReason::Halted && expected != StopReason::Fault);
+        }
+        if (!running)
+            break;
+    }
+    return true;
+}
+
+// run_frame() keeps to one frame when FX0A blocks, wherever in the frame it lands
+static bool check_frame_clock()
+{
+    struct Case
+    {
+        const char* name;
+        vector<uint16_t> ops;
+    };
+    const Case cases[] = {
+        {"FX0A in the last slot", {0x6005, 0xF015, 0xF00A}},
+        {"FX0A mid-frame", {0x6005, 0xF015, 0x6000, 0x6000, 0xF00A}},
+        {"FX0A in the first slot", {0x6005, 0xF015, 0x6000, 0xF00A}},
+    };
+
+    bool ok = true;
+    for (const Case &c : cases)
+    {
+        vector<uint8_t> rom;
+        for (uint16_t op : c.ops)
+        {
+            rom.push_back(static_cast<uint8_t>(op >> 8));
+            rom.push_back(static_cast<uint8_t>(op & 0xFF));
+        }
+        Chip8 cpu;
+        cpu.init();
+        cpu.cycles_per_frame = 3;
+        loadROM(rom.data(), rom.size(), cpu);
+
+        // DT is set to 5 in the first frame and ticks once at the end of each
+        for (uint64_t frame = 1; frame <= 4; ++frame)
+        {
+            cpu.run_frame();
+            if (cpu.frame_count != frame || cpu.cycle_count != 3 * frame || cpu.delay_timer != 5 - frame)
+            {
+                printf("FAIL frame clock, %s: after frame %llu, frames %llu, instructions %llu, DT %d\n", c.name,
+                       static_cast<unsigned long long>(frame), static_cast<unsigned long long>(cpu.frame_count),
+                       static_cast<unsigned long long>(cpu.cycle_count), cpu.delay_timer);
+                ok = false;
+                break;
+            }
+        }
+    }
+    return ok;
+}
+
+#ifdef CHIP8_CHECK_PROGRAMS
+// A compiled ROM against the interpreter on the same ROM
+static bool check_aot(const Chip8CheckProgram &check, uint32_t seed)
+{
+    ifstream file(check.rom, ios::binary);
+    vector<uint8_t> rom((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    const QuirkProfile quirks = check.program->quirks;
+    Chip8 reference(quirks), compiled(quirks);
+    CheckRandom random(seed);
+    const uint32_t ipf = 5 + random.next(30);
+    for (Chip8* cpu : {&reference, &compiled})
+    {
+        cpu->init();
+        cpu->cycles_per_frame = ipf;
+        cpu->seed_random(seed);
+        if (!loadROM(rom.data(), rom.size(), *cpu))
+        {
+            printf("FAIL %s: could not open it\n", check.rom);
+            return false;
+        }
+    }
+    Chip8Aot aot(compiled, *check.program);
+
+    for (int slice = 0; slice < 300; ++slice)
+    {
+        if (random.next(4) == 0)
+        {
+            const uint16_t keys = static_cast<uint16_t>(random.next(0x10000));
+            chip8_set_key_mask(reference, keys);
+            chip8_set_key_mask(compiled, keys);
+        }
+        const uint64_t n = 1 + random.next(300);
+        const StopReason expected = reference.run_cycles(n);
+        const StopReason actual = aot.run_cycles(n);
+        if (!same_machine(check.rom, slice, expected, actual, reference, compiled))
+            return false;
+        if (expected == StopReason::Halted || expected == StopReason::Fault)
+            break;
+    }
+    return true;
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+    if (argc == 3 && strcmp(argv[1], "--generate") == 0)
+    {
+        if (!generate(argv[2]))
+        {
+            fprintf(stderr, "Could not write ROMs to %s\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+    if (argc != 1)
+    {
+        fprintf(stderr, "Usage: check [--generate dir]\n");
+        return EXIT_FAILURE;
+    }
+
+    int failures = 0;
+
+    failures += check_frame_clock() ? 0 : 1;
+    printf("Frame clock: run_frame() around FX0A\n");
+
+#ifdef CHIP8_CHECK_PROGRAMS
+    int aot_runs = 0;
+    for (const Chip8CheckProgram &check : check_programs)
+    {
+        for (uint32_t seed = 0; seed < 4; ++seed)
+        {
+            ++aot_runs;
+            failures += check_aot(check, seed) ? 0 : 1;
+        }
+    }
+    printf("Compiled ROMs: %d runs of %zu ROMs against the interpreter\n", aot_runs,
+           sizeof(check_programs) / sizeof(check_programs[0]));
+#else
+    printf("Compiled ROMs: none built in, make check compiles them\n");
+#endif
+
+    // Neither needs anything compiled ahead, so they go through four times as many ROMs
+    int jit_runs = 0;
+    for (QuirkProfile quirks : check_profiles)
+    {
+        for (int i = 0; i < 4 * roms_per_profile; ++i)
+        {
+            ++jit_runs;
+            failures += check_jit(quirks, i) ? 0 : 1;
+        }
+    }
+    printf("JIT: %d ROMs against the interpreter\n", jit_runs);
+
+    int lockstep_runs = 0;
+    for (QuirkProfile quirks : check_profiles)
+    {
+        for (int i = 0; i < 4 * roms_per_profile; ++i)
+        {
+            ++lockstep_runs;
+            failures += check_lockstep(quirks, i) ? 0 : 1;
+        }
+    }
+    printf("Lockstep: %d ROMs of 20 lanes with their own keys against separate machines\n", lockstep_runs);
+
+    int compact_runs = 0;
+    for (QuirkProfile quirks : check_profiles)
+    {
+        for (int i = 0; i < roms_per_profile; ++i)
+        {
+            ++compact_runs;
+            failures += check_compact(quirks, i) ? 0 : 1;
+        }
+    }
+    printf("Compact pool: %d ROMs of 8 instances against separate machines\n", compact_runs);
+
+    printf("%s, %d failed\n", failures == 0 ? "OK" : "FAILED", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,381 @@
+#pragma once
+
+// Very many machines on one ROM in one process, stored compactly and run one at a time.
+//
+// A Chip8 is 38 KB, 32 KB of it the decoded cache, and a 100k pool of them won't fit in any
+// cache. Here an instance is a Chip8CompactState of 512 bytes:
+// - One cache line with registers, PC, I, SP, timers and the clock.
+// - The stack, the CHIP-8 display and a table of memory pages.
+// Memory is 16 pages of 256 bytes. Pages an instance never wrote are read from the boot
+// image, which holds the fonts and the ROM once for everyone. A page is copied out only
+// after a write makes it differ from the image, and is handed back when it matches again.
+// The 1 KB SUPER-CHIP display is only allocated once an instance switches to it with 00FF.
+//
+// Running an instance puts it on a worker, a full Chip8 kept close to the boot image. On the
+// way in only the pages the last instance changed and the ones this one owns are copied, and
+// the boot image's decoded slots come back with them. On the way out the pages written are
+// compared against the image. There is a worker per display mode, so SUPER-CHIP instances
+// start on a cache decoded for their mode too. A pool belongs to one thread, so give each
+// thread its own pool and its share of the instances.
+
+#include <memory>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#include "arena.cpp"
+
+struct alignas(64) Chip8CompactState
+{
+    // Hot, one cache line
+    uint64_t cycle_count;
+    uint64_t frame_count;
+    uint32_t cycles_into_frame;
+    uint32_t rng_state;
+    uint8_t registers[16];
+    uint16_t program_counter;
+    uint16_t index;
+    uint16_t current_opcode;
+    uint16_t keys;             // Bit i for key i
+    uint8_t delay_timer;
+    uint8_t sound_timer;
+    uint8_t sp;
+    uint8_t status;            // StopReason
+    bool extended;
+    uint32_t extended_display; // Slot in the pool's SUPER-CHIP displays, 0 before the first 00FF
+
+    // Cold
+    alignas(64) uint16_t stack[32];
+    uint32_t pages[16];        // Slot in the pool's pages per 256 bytes of memory, 0 for the boot image's
+    uint64_t graphics[32];
+    uint64_t display_generation;
+    const char* fault_message;
+    uint8_t rpl_user_flags[8];
+};
+
+class Chip8CompactPool {
+public:
+
+    explicit Chip8CompactPool(size_t instances, QuirkProfile quirks = QuirkProfile::Original)
+        : states(instances), page_store(1), extended_store(1)
+    {
+        workers[0].arena.reset(new Chip8Arena(1, quirks));
+        workers[1].arena.reset(new Chip8Arena(1, quirks));
+        start_over();
+    }
+
+    Chip8CompactPool(const Chip8CompactPool &) = delete;
+    Chip8CompactPool &operator=(const Chip8CompactPool &) = delete;
+
+    size_t size() const { return states.size(); }
+
+    // Every instance starts over on a fresh machine with this ROM
+    bool load(const uint8_t* rom, size_t size)
+    {
+        close();
+        for (auto &worker : workers)
+        {
+            worker.arena->boot().cycles_per_frame = cycles_per_frame;
+            if (!worker.arena->load(rom, size))
+                return false;
+        }
+        start_over();
+        return true;
+    }
+
+    // Instructions per frame for every instance, load() again to use it
+    uint32_t cycles_per_frame = 10;
+
+    // Back to the state right after load()
+    void reset(size_t i)
+    {
+        close();
+        release(states[i]);
+        states[i] = fresh;
+    }
+
+    // Puts instance i on a worker. Everything on Chip8 works on it until close(), which is
+    // when it's written back. Don't change cycles_per_frame, trace or profile on it.
+    Chip8 &open(size_t i)
+    {
+        close();
+        Chip8CompactState &state = states[i];
+        Worker &worker = workers[state.extended ? 1 : 0];
+        Chip8Arena &arena = *worker.arena;
+        Chip8 &cpu = arena[0];
+        const Chip8 &boot = arena.boot();
+
+        if (worker.full_reset)
+        {
+            cpu.decoded_changed_pages = ~0ull;
+            arena.reset(0);
+            worker.full_reset = false;
+            worker.foreign_pages = 0;
+            worker.extended_in_use = false;
+        }
+
+        // Back to the image where the last instance left its marks, then this one's own pages
+        cpu.decoded_changed_pages = 0;
+        uint32_t touched = worker.foreign_pages | owned_pages(state);
+        while (touched != 0)
+        {
+            int page = __builtin_ctz(touched);
+            touched &= touched - 1;
+            uint8_t* memory = cpu.memory + page * page_size;
+            if (state.pages[page] != 0)
+            {
+                memcpy(memory, page_store[state.pages[page]].bytes, page_size);
+                cpu.invalidate_decoded(static_cast<uint16_t>(page * page_size), page_size);
+            }
+            else
+            {
+                memcpy(memory, boot.memory + page * page_size, page_size);
+                memcpy(&cpu.decoded[page * slots_per_page], &boot.decoded[page * slots_per_page],
+                       slots_per_page * sizeof(Chip8::DecodedOp));
+            }
+        }
+        cpu.code_dirty_pages = ~0ull;
+
+        memcpy(cpu.registers, state.registers, sizeof(cpu.registers));
+        cpu.index = state.index;
+        cpu.program_counter = state.program_counter;
+        cpu.sp = state.sp;
+        cpu.current_opcode = state.current_opcode;
+        cpu.delay_timer = state.delay_timer;
+        cpu.sound_timer = state.sound_timer;
+        cpu.status = static_cast<StopReason>(state.status);
+        cpu.cycles_into_frame = state.cycles_into_frame;
+        cpu.rng_state = state.rng_state;
+        cpu.cycle_count = state.cycle_count;
+        cpu.frame_count = state.frame_count;
+        cpu.fault_message = state.fault_message;
+        memcpy(cpu.stack, state.stack, sizeof(cpu.stack));
+        memcpy(cpu.rpl_user_flags, state.rpl_user_flags, sizeof(cpu.rpl_user_flags));
+        for (int k = 0; k < 16; ++k)
+            cpu.keys[k] = (state.keys >> k) & 1;
+        memcpy(cpu.graphics, state.graphics, sizeof(cpu.graphics));
+        if (state.extended_display != 0)
+            memcpy(cpu.graphics_extended, extended_store[state.extended_display].rows, sizeof(cpu.graphics_extended));
+        else if (worker.extended_in_use)
+            memset(cpu.graphics_extended, 0, sizeof(cpu.graphics_extended));
+        worker.extended_in_use = state.extended_display != 0;
+        cpu.display_generation = state.display_generation;
+
+        open_index = i;
+        open_worker = &worker;
+        return cpu;
+    }
+
+    // Writes the open instance back, if there is one
+    void close()
+    {
+        if (open_worker == nullptr)
+            return;
+        Worker &worker = *open_worker;
+        Chip8Arena &arena = *worker.arena;
+        Chip8 &cpu = arena[0];
+        const Chip8 &boot = arena.boot();
+        Chip8CompactState &state = states[open_index];
+        open_worker = nullptr;
+
+        freeze_into(state, cpu);
+
+        // Pages written are the instance's own while they differ from the image
+        uint32_t written = pages_of(cpu.decoded_changed_pages);
+        worker.foreign_pages = written;
+        while (written != 0)
+        {
+            int page = __builtin_ctz(written);
+            written &= written - 1;
+            const uint8_t* memory = cpu.memory + page * page_size;
+            if (memcmp(memory, boot.memory + page * page_size, page_size) == 0)
+            {
+                free_page(state.pages[page]);
+                state.pages[page] = 0;
+                continue;
+            }
+            if (state.pages[page] == 0)
+                state.pages[page] = allocate_page();
+            memcpy(page_store[state.pages[page]].bytes, memory, page_size);
+        }
+
+        if (cpu.extendedScreenMode && state.extended_display == 0)
+            state.extended_display = allocate_extended();
+        if (state.extended_display != 0)
+            memcpy(extended_store[state.extended_display].rows, cpu.graphics_extended, sizeof(cpu.graphics_extended));
+
+        // The worker left its display mode, so its whole cache is off the image
+        if (cpu.extendedScreenMode != boot.extendedScreenMode)
+            worker.full_reset = true;
+    }
+
+    // A frame of instance i, same as Chip8::run_frame()
+    StopReason run_frame(size_t i)
+    {
+        StopReason reason = open(i).run_frame();
+        close();
+        return reason;
+    }
+
+    StopReason run_cycles(size_t i, uint64_t n)
+    {
+        StopReason reason = open(i).run_cycles(n);
+        close();
+        return reason;
+    }
+
+    void set_keys(size_t i, uint16_t mask)
+    {
+        if (open_worker != nullptr && open_index == i)
+            for (int k = 0; k < 16; ++k)
+                (*open_worker->arena)[0].keys[k] = (mask >> k) & 1;
+        states[i].keys = mask;
+    }
+
+    const Chip8CompactState &state(size_t i) const { return states[i]; }
+
+    // Per instance memory: the states, and the pages and SUPER-CHIP displays in use
+    size_t instance_bytes() const
+    {
+        return states.size() * sizeof(Chip8CompactState) + (page_store.size() - 1 - free_pages.size()) * page_size +
+               (extended_store.size() - 1 - free_extended.size()) * sizeof(ExtendedDisplay);
+    }
+
+    size_t pages_in_use() const { return page_store.size() - 1 - free_pages.size(); }
+
+private:
+
+    static const size_t page_size = 256;
+    static const size_t slots_per_page = page_size / 2;
+
+    struct Page
+    {
+        uint8_t bytes[page_size];
+    };
+
+    struct ExtendedDisplay
+    {
+        uint64_t rows[64][2];
+    };
+
+    struct Worker
+    {
+        std::unique_ptr<Chip8Arena> arena;  // Boot image for one display mode, and the machine instances run on
+        uint32_t foreign_pages = 0;         // Pages whose memory or decoded slots may be off the image
+        bool full_reset = false;            // Switched display mode, its whole cache is off the image
+        bool extended_in_use = false;       // graphics_extended may be non-zero
+    };
+
+    std::vector<Chip8CompactState> states;
+    Chip8CompactState fresh = {};
+    Worker workers[2];
+    Worker* open_worker = nullptr;
+    size_t open_index = 0;
+
+    // Slot 0 of both stores is never handed out
+    std::vector<Page> page_store;
+    std::vector<uint32_t> free_pages;
+    std::vector<ExtendedDisplay> extended_store;
+    std::vector<uint32_t> free_extended;
+
+    // The SUPER-CHIP worker's image decoded for its mode, and every instance back to the boot image
+    void start_over()
+    {
+        Chip8Arena &extended = *workers[1].arena;
+        extended.boot().set_display_mode(true);
+        extended.reset_all();
+        for (auto &worker : workers)
+        {
+            worker.foreign_pages = 0;
+            worker.full_reset = false;
+            worker.extended_in_use = false;
+        }
+        freeze_into(fresh, workers[0].arena->boot());
+        for (size_t i = 0; i < states.size(); ++i)
+            reset(i);
+    }
+
+    // Everything but memory and the SUPER-CHIP display
+    static void freeze_into(Chip8CompactState &state, const Chip8 &cpu)
+    {
+        memcpy(state.registers, cpu.registers, sizeof(state.registers));
+        state.index = cpu.index;
+        state.program_counter = cpu.program_counter;
+        state.sp = static_cast<uint8_t>(cpu.sp);
+        state.current_opcode = cpu.current_opcode;
+        state.delay_timer = cpu.delay_timer;
+        state.sound_timer = cpu.sound_timer;
+        state.status = static_cast<uint8_t>(cpu.status);
+        state.extended = cpu.extendedScreenMode;
+        state.cycles_into_frame = cpu.cycles_into_frame;
+        state.rng_state = cpu.rng_state;
+        state.cycle_count = cpu.cycle_count;
+        state.frame_count = cpu.frame_count;
+        state.fault_message = cpu.fault_message;
+        memcpy(state.stack, cpu.stack, sizeof(state.stack));
+        memcpy(state.rpl_user_flags, cpu.rpl_user_flags, sizeof(state.rpl_user_flags));
+        state.keys = 0;
+        for (int k = 0; k < 16; ++k)
+            state.keys |= cpu.keys[k] ? 1 << k : 0;
+        memcpy(state.graphics, cpu.graphics, sizeof(state.graphics));
+        state.display_generation = cpu.display_generation;
+    }
+
+    // 64-byte page bits to 256-byte page bits
+    static uint32_t pages_of(uint64_t small_pages)
+    {
+        uint32_t pages = 0;
+        for (int page = 0; page < 16; ++page)
+            pages |= (small_pages >> (page * 4)) & 0xF ? 1u << page : 0;
+        return pages;
+    }
+
+    static uint32_t owned_pages(const Chip8CompactState &state)
+    {
+        uint32_t pages = 0;
+        for (int page = 0; page < 16; ++page)
+            pages |= state.pages[page] != 0 ? 1u << page : 0;
+        return pages;
+    }
+
+    uint32_t allocate_page()
+    {
+        if (!free_pages.empty())
+        {
+            uint32_t slot = free_pages.back();
+            free_pages.pop_back();
+            return slot;
+        }
+        page_store.emplace_back();
+        return static_cast<uint32_t>(page_store.size() - 1);
+    }
+
+    void free_page(uint32_t slot)
+    {
+        if (slot != 0)
+            free_pages.push_back(slot);
+    }
+
+    uint32_t allocate_extended()
+    {
+        if (!free_extended.empty())
+        {
+            uint32_t slot = free_extended.back();
+            free_extended.pop_back();
+            return slot;
+        }
+        extended_store.emplace_back();
+        return static_cast<uint32_t>(extended_store.size() - 1);
+    }
+
+    void release(Chip8CompactState &state)
+    {
+        for (auto &page : state.pages)
+        {
+            free_page(page);
+            page = 0;
+        }
+        if (state.extended_display != 0)
+            free_extended.push_back(state.extended_display);
+        state.extended_display = 0;
+    }
+};
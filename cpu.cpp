@@ -1,55 +1,154 @@
-#ifdef DEBUG
-#define DEBUG_MSG(str) do { std::cout << str << std::endl; } while( false )
-#else
-#define DEBUG_MSG(str) do { } while ( false )
-#endif
-
-
-
+#pragma once
 
 #include <iostream>
+#include <fstream>
 #include <stdlib.h>
-#include <time.h>
-#include <random>
-
-
-class Chip8 {
-public:
-
-    
+#include <stdint.h>
+#include <string.h>
+#include "trace.cpp"
+#include "profile.cpp"
+
+
+// Why run_cycles()/run_frame()/cycle() handed control back to the caller
+enum class StopReason
+{
+    None,           // Instruction executed normally, keep going
+    CycleLimit,     // run_cycles() used up its budget
+    FrameBoundary,  // run_frame() finished a frame worth of instructions
+    WaitingForKey,  // FX0A is blocked until a key is pressed
+    Idle,           // step() ran into an idle loop that skip_idle() can fast-forward, run_cycles() never returns it
+    Halted,         // 00FD exited the program
+    Fault           // Bad opcode, PC out of range or stack over/underflow
+};
 
-    // Current Operation Code
-    uint16_t current_opcode;
+inline const char* stop_reason_name(StopReason reason)
+{
+    switch (reason)
+    {
+        case StopReason::None:          return "none";
+        case StopReason::CycleLimit:    return "cycle-limit";
+        case StopReason::FrameBoundary: return "frame-boundary";
+        case StopReason::WaitingForKey: return "waiting-for-key";
+        case StopReason::Idle:          return "idle";
+        case StopReason::Halted:        return "halted";
+        case StopReason::Fault:         return "fault";
+    }
+    return "unknown";
+}
+
+// Interpretations of the opcodes CHIP-8 variants disagree on, picked when a Chip8 is made
+enum class QuirkProfile
+{
+    Original,   // This emulator's own: shifts use Vx, FX55/FX65 stop before VX and leave I alone, BNNN adds V0, sprites wrap
+    CosmacVip,  // Shifts copy Vy into Vx first, FX55/FX65 leave I past the last register, sprites clip
+    SuperChip,  // Shifts use Vx, FX55/FX65 leave I alone, BXNN jumps to XNN + Vx, sprites clip
+    XoChip      // Shifts copy Vy into Vx first, FX55/FX65 leave I past the last register, sprites wrap
+};
 
-    // Memory Map
-    uint8_t memory[4096];
+inline const char* quirk_profile_name(QuirkProfile profile)
+{
+    switch (profile)
+    {
+        case QuirkProfile::Original:  return "original";
+        case QuirkProfile::CosmacVip: return "vip";
+        case QuirkProfile::SuperChip: return "schip";
+        case QuirkProfile::XoChip:    return "xochip";
+    }
+    return "unknown";
+}
+
+// Accepts the names quirk_profile_name() returns
+inline bool parse_quirk_profile(const char* name, QuirkProfile &profile)
+{
+    const QuirkProfile all[] = {QuirkProfile::Original, QuirkProfile::CosmacVip, QuirkProfile::SuperChip, QuirkProfile::XoChip};
+    for (QuirkProfile p : all)
+    {
+        if (strcmp(name, quirk_profile_name(p)) == 0)
+        {
+            profile = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+// The same choices as compile-time constants. Handlers that depend on them are instantiated
+// once per bundle and decode() picks the instantiation, so the hot path never tests a quirk.
+template <bool ShiftUsesVy, bool LoadStoreAdvancesI, bool JumpUsesVx, bool SpritesClip, bool LoadStoreSkipsVx>
+struct Quirks
+{
+    static const bool shift_uses_vy = ShiftUsesVy;                // 8XY6/8XYE shift Vy into Vx
+    static const bool load_store_advances_i = LoadStoreAdvancesI; // FX55/FX65 leave I = I + X + 1
+    static const bool jump_uses_vx = JumpUsesVx;                  // BXNN jumps to XNN + Vx
+    static const bool sprites_clip = SpritesClip;                 // DXYN drops pixels past the edges
+    static const bool load_store_skips_vx = LoadStoreSkipsVx;     // FX55/FX65 cover V0 to VX-1 only
+};
 
-    // Graphics
-    uint8_t graphics[64 * 32];
-    uint8_t graphics_extended[128 * 64];
+typedef Quirks<false, false, false, false, true>  OriginalQuirks;
+typedef Quirks<true,  true,  false, true,  false> CosmacVipQuirks;
+typedef Quirks<false, false, true,  true,  false> SuperChipQuirks;
+typedef Quirks<true,  true,  false, false, false> XoChipQuirks;
+
+// Runtime copy of a profile's bundle, for the engines that don't go through decode()
+struct QuirkFlags
+{
+    bool shift_uses_vy;
+    bool load_store_advances_i;
+    bool jump_uses_vx;
+    bool sprites_clip;
+    bool load_store_skips_vx;
+};
 
-    // 16 Registers V0-VF
-    uint8_t registers[16];
+template <class Q>
+inline QuirkFlags quirk_flags_of()
+{
+    return {Q::shift_uses_vy, Q::load_store_advances_i, Q::jump_uses_vx, Q::sprites_clip, Q::load_store_skips_vx};
+}
 
+inline QuirkFlags quirk_flags(QuirkProfile profile)
+{
+    switch (profile)
+    {
+        case QuirkProfile::CosmacVip: return quirk_flags_of<CosmacVipQuirks>();
+        case QuirkProfile::SuperChip: return quirk_flags_of<SuperChipQuirks>();
+        case QuirkProfile::XoChip:    return quirk_flags_of<XoChipQuirks>();
+        default:                      return quirk_flags_of<OriginalQuirks>();
+    }
+}
+
+// Everything needed to resume a machine, as one flat block of bytes so snapshots can be
+// copied, compared and XORed against each other. Wide fields come first so there is no
+// padding in the middle, and save_state() zeroes the struct before filling it.
+struct Chip8State
+{
+    uint64_t cycle_count;
+    uint64_t frame_count;
+    uint64_t graphics[32];
+    uint64_t graphics_extended[64][2];
+    uint32_t cycles_into_frame;
+    uint32_t rng_state;
     uint16_t index;
     uint16_t program_counter;
- 
-    // Timer registers
+    uint16_t sp;
+    uint16_t current_opcode;
+    uint16_t stack[32];
+    uint8_t memory[4096];
+    uint8_t registers[16];
+    uint8_t rpl_user_flags[8];
     uint8_t delay_timer;
     uint8_t sound_timer;
+    uint8_t extended_screen_mode;
+    uint8_t status;
+};
 
-    // Stack and Stack Pointer
-    uint16_t stack[32];
-    uint16_t sp;
 
-    // Register flags
-    uint8_t rpl_user_flags[8];
-
-    // Keys
-    uint8_t keys[16];
+// Fonts, shared by every instance and copied into memory by init(). The 4x5 CHIP-8
+// digits sit at 0x000 for FX29, the 8x10 SUPER-CHIP digits right after them for FX30.
+static const uint16_t chip8_font_address = 0x000;
+static const uint16_t chip48_font_address = 0x050;
 
-    uint8_t chip8_fontset[80] = 
-    {
+static constexpr uint8_t chip8_fontset[80] =
+{
     0x60, 0xA0, 0xA0, 0xA0, 0xC0, // 0
     0x40, 0xC0, 0x40, 0x40, 0xE0, // 1
     0xC0, 0x20, 0x40, 0x80, 0xE0, // 2
@@ -66,49 +165,178 @@ public:
     0xC0, 0xA0, 0xA0, 0xA0, 0xC0, // D
     0xE0, 0x80, 0xC0, 0x80, 0xE0, // E
     0xE0, 0x80, 0xC0, 0x80, 0x80  // F
-    };
+};
 
-    uint16_t chip48_fontset[80] = 
-    {
-    0xC67C, 0xDECE, 0xF6D6, 0xC6E6, 0x007C, // 0
-    0x3010, 0x30F0, 0x3030, 0x3030, 0x00FC, // 1
-    0xCC78, 0x0CCC, 0x3018, 0xCC60, 0x00FC, // 2
-    0xCC78, 0x0C0C, 0x0C38, 0xCC0C, 0x0078, // 3
-    0x1C0C, 0x6C3C, 0xFECC, 0x0C0C, 0x001E, // 4
-    0xC0FC, 0xC0C0, 0x0CF8, 0xCC0C, 0x0078, // 5
-    0x6038, 0xC0C0, 0xCCF8, 0xCCCC, 0x0078, // 6
-    0xC6FE, 0x06C6, 0x180C, 0x3030, 0x0030, // 7
-    0xCC78, 0xECCC, 0xDC78, 0xCCCC, 0x0078, // 8
-    0xC67C, 0xC6C6, 0x0C7E, 0x3018, 0x0070, // 9
-    0x7830, 0xCCCC, 0xFCCC, 0xCCCC, 0x00CC, // A
-    0x66FC, 0x6666, 0x667C, 0x6666, 0x00FC, // B
-    0x663C, 0xC0C6, 0xC0C0, 0x66C6, 0x003C, // C
-    0x6CF8, 0x6666, 0x6666, 0x6C66, 0x00F8, // D
-    0x62FE, 0x6460, 0x647C, 0x6260, 0x00FE, // E
-    0x66FE, 0x6462, 0x647C, 0x6060, 0x00F0  // F
-    };
+static constexpr uint8_t chip48_fontset[160] =
+{
+    0x7C, 0xC6, 0xCE, 0xDE, 0xD6, 0xF6, 0xE6, 0xC6, 0x7C, 0x00, // 0
+    0x10, 0x30, 0xF0, 0x30, 0x30, 0x30, 0x30, 0x30, 0xFC, 0x00, // 1
+    0x78, 0xCC, 0xCC, 0x0C, 0x18, 0x30, 0x60, 0xCC, 0xFC, 0x00, // 2
+    0x78, 0xCC, 0x0C, 0x0C, 0x38, 0x0C, 0x0C, 0xCC, 0x78, 0x00, // 3
+    0x0C, 0x1C, 0x3C, 0x6C, 0xCC, 0xFE, 0x0C, 0x0C, 0x1E, 0x00, // 4
+    0xFC, 0xC0, 0xC0, 0xC0, 0xF8, 0x0C, 0x0C, 0xCC, 0x78, 0x00, // 5
+    0x38, 0x60, 0xC0, 0xC0, 0xF8, 0xCC, 0xCC, 0xCC, 0x78, 0x00, // 6
+    0xFE, 0xC6, 0xC6, 0x06, 0x0C, 0x18, 0x30, 0x30, 0x30, 0x00, // 7
+    0x78, 0xCC, 0xCC, 0xEC, 0x78, 0xDC, 0xCC, 0xCC, 0x78, 0x00, // 8
+    0x7C, 0xC6, 0xC6, 0xC6, 0x7E, 0x0C, 0x18, 0x30, 0x70, 0x00, // 9
+    0x30, 0x78, 0xCC, 0xCC, 0xCC, 0xFC, 0xCC, 0xCC, 0xCC, 0x00, // A
+    0xFC, 0x66, 0x66, 0x66, 0x7C, 0x66, 0x66, 0x66, 0xFC, 0x00, // B
+    0x3C, 0x66, 0xC6, 0xC0, 0xC0, 0xC0, 0xC6, 0x66, 0x3C, 0x00, // C
+    0xF8, 0x6C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x6C, 0xF8, 0x00, // D
+    0xFE, 0x62, 0x60, 0x64, 0x7C, 0x64, 0x60, 0x62, 0xFE, 0x00, // E
+    0xFE, 0x66, 0x62, 0x64, 0x7C, 0x64, 0x60, 0x60, 0xF0, 0x00  // F
+};
+
+class alignas(64) Chip8 {
+public:
 
+    explicit Chip8(QuirkProfile quirks = QuirkProfile::Original) : quirks(quirks) {}
 
+    // What nearly every instruction reads or writes comes first, so it shares one cache line
+
+    // 16 Registers V0-VF
+    uint8_t registers[16];
+
+    uint16_t index;
+    uint16_t program_counter;
+
+    // Stack Pointer, the stack itself is further down
+    uint16_t sp;
+
+    // Current Operation Code
+    uint16_t current_opcode;
+
+    // Timer registers
+    uint8_t delay_timer;
+    uint8_t sound_timer;
+
+    // Decoded handlers are specialised for the display mode, change it through set_display_mode()
     bool extendedScreenMode = false;
 
+    // Fixed for the life of the instance, the decoded cache holds handlers built for it
+    const QuirkProfile quirks;
+
+    // Sticky machine state, Halted and Fault stay set until init()
+    StopReason status = StopReason::None;
+
+    // Virtual clock. Emulated time advances by one 60 Hz frame every cycles_per_frame
+    // instructions, which is when delay_timer and sound_timer tick. Instructions per
+    // second is cycles_per_frame * 60 no matter how fast the host runs the core.
+    uint32_t cycles_per_frame = 10;
+    uint32_t cycles_into_frame = 0;
+
+    // CXNN random numbers, xorshift32 so a seed and the same inputs always replay the same run
+    uint32_t rng_state = 1;
+
+    // Total instructions executed since init()
+    uint64_t cycle_count = 0;
+    uint64_t frame_count = 0;
+
+    const char* fault_message = nullptr;
+
+    // Memory Map
+    uint8_t memory[4096];
+
+    // Graphics, packed one bit per pixel. Bit 63 of a word is the leftmost pixel of its row,
+    // extended rows are two words with [0] covering x 0-63 and [1] covering x 64-127.
+    uint64_t graphics[32];
+    uint64_t graphics_extended[64][2];
+
+    uint16_t stack[32];
+
+    // Register flags, zero on a new machine. init() leaves them alone so FX75/FX85 data
+    // survives a reset, the way it survived power cycles on the HP-48.
+    uint8_t rpl_user_flags[8] = {};
+
+    // Keys
+    uint8_t keys[16];
+
+    // Display change tracking, goes up whenever an instruction may have changed the picture.
+    // Which rows changed is up to the front end, Chip8PixelBuffer compares against the last
+    // frame it drew so frames the renderer skipped can't lose any.
+    uint64_t display_generation = 0;
+
+    // Instruction trace, every step() is recorded while this is set
+    Chip8Trace* trace = nullptr;
+
+    // Opcode and address counts, every step() is counted while this is set
+    Chip8Profile* profile = nullptr;
+
+    void mark_display_changed() { ++display_generation; }
+
     void clear()
     {
         // Clear Graphics dependent on flag
         if(extendedScreenMode)
-        {
-            for (auto &g : graphics) 
-                g = 0x00;
-        }
+            clear_as<true>();
+        else
+            clear_as<false>();
+    }
+
+    template <bool extended>
+    void clear_as()
+    {
+        if (extended)
+            memset(graphics_extended, 0, sizeof(graphics_extended));
         else
+            memset(graphics, 0, sizeof(graphics));
+        mark_display_changed();
+    }
+
+    // Switches between CHIP-8 and SUPER-CHIP resolution. The decoded slots hold handlers
+    // compiled for one mode, so they are dropped and decoded again for the new one. Memory
+    // didn't change, so unlike invalidate_decoded() the JIT's blocks stay.
+    void set_display_mode(bool extended)
+    {
+        if (extended != extendedScreenMode)
         {
-            for (auto &g : graphics_extended) 
-                g = 0x00;
+            extendedScreenMode = extended;
+            for (auto &d : decoded)
+                d.handler = nullptr;
+            decoded_changed_pages = ~0ull;
         }
+        mark_display_changed();
     }
 
+    int screen_width() const  { return extendedScreenMode ? 128 : 64; }
+    int screen_height() const { return extendedScreenMode ? 64 : 32; }
+
+    // Pixel of the active display, for front ends that want one pixel at a time
+    bool pixel(int x, int y) const
+    {
+        if (extendedScreenMode)
+            return (graphics_extended[y][x >> 6] >> (63 - (x & 63))) & 1;
+        return (graphics[y] >> (63 - x)) & 1;
+    }
+
+    // Zero isn't a valid xorshift state, so seeds go through a multiply first
+    void seed_random(uint32_t seed)
+    {
+        rng_state = (seed ^ 0x6D2B79F5u) * 0x9E3779B1u;
+        if (rng_state == 0)
+            rng_state = 1;
+    }
+
+    uint32_t next_random()
+    {
+        uint32_t x = rng_state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        rng_state = x;
+        return x;
+    }
+
+    // Resets the machine, the random generator goes back to seed 0 so runs are reproducible
     void init() 
     {
-        srand(time(NULL));
+        seed_random(0);
+
+        status = StopReason::None;
+        fault_message = nullptr;
+        cycle_count = 0;
+        cycles_into_frame = 0;
+        frame_count = 0;
 
         program_counter = 0x200;
         current_opcode = 0x00;
@@ -116,44 +344,80 @@ public:
         sp = 0x00;
 
         // Clear display
-        clear();
-
-        // Clear stack
-        for (auto &s : stack) {
-            s = 0x00;
-        }
-
-        // Clear registers
-        for (auto &r : registers) {
-            r = 0x00;
-        }
+        memset(graphics, 0, sizeof(graphics));
+        memset(graphics_extended, 0, sizeof(graphics_extended));
+        mark_display_changed();
 
-        // Clear memory
-        for (auto &v : memory) {
-            v = 0x00;
-        }
+        // Clear stack, registers and keys
+        memset(stack, 0, sizeof(stack));
+        memset(registers, 0, sizeof(registers));
+        memset(keys, 0, sizeof(keys));
 
-        // Clear key
-        for (auto &k : keys) {
-            k = 0x00;
-        }
-
-        // Set fonts
-        for (int i = 0; i < 80; i++) 
-        {
-            if(extendedScreenMode)
-                memory[i] = chip48_fontset[i];
-            else
-                memory[i] = chip8_fontset[i];
-        }
+        // Clear memory and set fonts
+        memset(memory, 0, sizeof(memory));
+        memcpy(&memory[chip8_font_address], chip8_fontset, sizeof(chip8_fontset));
+        memcpy(&memory[chip48_font_address], chip48_fontset, sizeof(chip48_fontset));
+        invalidate_decoded();
 
         delay_timer = 0;
         sound_timer = 0;
     }
 
+    // Snapshot of the machine. Keys and cycles_per_frame belong to the front end and are left out.
+    void save_state(Chip8State &state) const
+    {
+        memset(&state, 0, sizeof(state));
+        state.cycle_count = cycle_count;
+        state.frame_count = frame_count;
+        memcpy(state.graphics, graphics, sizeof(graphics));
+        memcpy(state.graphics_extended, graphics_extended, sizeof(graphics_extended));
+        state.cycles_into_frame = cycles_into_frame;
+        state.rng_state = rng_state;
+        state.index = index;
+        state.program_counter = program_counter;
+        state.sp = sp;
+        state.current_opcode = current_opcode;
+        memcpy(state.stack, stack, sizeof(stack));
+        memcpy(state.memory, memory, sizeof(memory));
+        memcpy(state.registers, registers, sizeof(registers));
+        memcpy(state.rpl_user_flags, rpl_user_flags, sizeof(rpl_user_flags));
+        state.delay_timer = delay_timer;
+        state.sound_timer = sound_timer;
+        state.extended_screen_mode = extendedScreenMode;
+        state.status = static_cast<uint8_t>(status);
+    }
+
+    void load_state(const Chip8State &state)
+    {
+        cycle_count = state.cycle_count;
+        frame_count = state.frame_count;
+        memcpy(graphics, state.graphics, sizeof(graphics));
+        memcpy(graphics_extended, state.graphics_extended, sizeof(graphics_extended));
+        cycles_into_frame = cycles_per_frame ? state.cycles_into_frame % cycles_per_frame : 0;
+        rng_state = state.rng_state ? state.rng_state : 1;
+        index = state.index;
+        program_counter = state.program_counter;
+        sp = state.sp;
+        current_opcode = state.current_opcode;
+        memcpy(stack, state.stack, sizeof(stack));
+        memcpy(memory, state.memory, sizeof(memory));
+        memcpy(registers, state.registers, sizeof(registers));
+        memcpy(rpl_user_flags, state.rpl_user_flags, sizeof(rpl_user_flags));
+        delay_timer = state.delay_timer;
+        sound_timer = state.sound_timer;
+        extendedScreenMode = state.extended_screen_mode != 0;
+        status = static_cast<StopReason>(state.status);
+        fault_message = status == StopReason::Fault ? "Fault restored from a save state" : nullptr;
+
+        // Memory and the display changed behind the decoded cache and the front end's back
+        invalidate_decoded();
+        mark_display_changed();
+    }
+
     void increment_pc()  { program_counter += 2; }
 
-    void executeFX_0A(uint16_t &current_opcode)
+    // Returns false while no key is held so the caller can report WaitingForKey
+    bool executeFX_0A(uint16_t &current_opcode)
     {
         bool key_pressed = false;
         for (int i = 0; i < 16; ++i)
@@ -167,480 +431,977 @@ public:
         }
         if (!key_pressed)
             program_counter -= 2;
+        return key_pressed;
+    }
+
+    StopReason fault(const char* message)
+    {
+        status = StopReason::Fault;
+        fault_message = message;
+        return status;
+    }
+
+    // Runs up to n instructions, stops early on halt, fault or FX0A waiting for a key
+    StopReason run_cycles(uint64_t n)
+    {
+        if (status == StopReason::Halted || status == StopReason::Fault)
+            return status;
+
+        // Instrumented runs get their own loops so the plain one has no per-instruction tests
+        switch (step_mode())
+        {
+            case step_traced:                 return run_steps<step_traced>(n);
+            case step_profiled:               return run_steps<step_profiled>(n);
+            case step_traced | step_profiled: return run_steps<step_traced | step_profiled>(n);
+            default:                          return run_steps<0>(n);
         }
+    }
 
-    void cycle() 
+    template <int mode>
+    StopReason run_steps(uint64_t n)
     {
-        if (program_counter > 0xFFF) {
-            std::cout << "OPcode out of range! Your program has an error!";
-            exit(0);
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            StopReason reason = step_as<mode>();
+            if (reason != StopReason::None)
+            {
+                if (reason != StopReason::Idle)
+                    return reason;
+                // Traced and profiled runs want to see every pass through the loop
+                if (mode == 0)
+                    i += skip_idle(n - i - 1);
+            }
         }
+        return StopReason::CycleLimit;
+    }
 
-        current_opcode = static_cast<uint16_t>(memory[program_counter]) << 8 | memory[program_counter + 1];
-        // X000
-        uint16_t first = current_opcode >> 12;
-        switch (first)
+    // Idle loops. A 1NNN jumping to itself spins until the end of time, and the delay timer
+    // poll
+    //     A:   FX07    Vx = DT
+    //     A+2: 3X00    skip if Vx == 0
+    //     A+4: 1A      back to A
+    // spins until DT runs out. Their handlers return Idle after running normally, and then
+    // this retires up to budget instructions of the loop at once, leaving the machine in
+    // exactly the state running them one by one would have. Returns how many it retired.
+    uint64_t skip_idle(uint64_t budget)
+    {
+        uint16_t pc = program_counter;
+        if (pc > 0xFFE)
+            return 0;
+
+        if (read_opcode(pc) == (0x1000 | pc))
         {
-            case 0x0:
-                //DEBUG_MSG("SYS INSTR!\n" << first);
-                switch(current_opcode)
-                {
-                    case 0x0:
-                        program_counter -= 2;
-                        break;
-                    
-                    case 0x00C:
-                    {
-                        // 00CN: Scroll display N lines down
-                        uint8_t N = current_opcode & 0x000F;
-                        if(extendedScreenMode)
-                        {
-                            for (int y = 31; y >= N; --y)
-                                for (int x = 0; x < 128; ++x)  // Adjusted for extended display mode
-                                    graphics_extended[y * 128 + x] = graphics_extended[(y - N) * 128 + x];
-                            for (int y = 0; y < N; ++y)
-                                for (int x = 0; x < 128; ++x)  // Adjusted for extended display mode
-                                    graphics_extended[y * 128 + x] = 0;
-                        }
-                        else
-                        {
-                            for (int y = 31; y >= N; --y)
-                                for (int x = 0; x < 64; ++x)
-                                    graphics[y * 64 + x] = graphics[(y - N) * 64 + x];
-                            for (int y = 0; y < N; ++y)
-                                for (int x = 0; x < 64; ++x)
-                                    graphics[y * 64 + x] = 0;
-                        }
-                        break;
-                    }
-
-                    case 0x00E0:
-                        //Clear the display.
-                        clear();                        
-                        break;
-
-                    case 0x00EE:
-                    {
-                        // 000E: Return from a subroutine
-                        if (sp > 0) 
-                        {
-                            --sp;
-                            program_counter = stack[sp];
-                        } else 
-                        {
-                            std::cout << "Stack underflow! Your program has an error!" << std::endl;
-                            exit(0);
-                        }
-                        break;
-                    }
-
-                    case 0x00FB:
-                    {
-                        // 00FB: Scroll display 4 pixels right
-                        const int scroll = 4;
-                        if(extendedScreenMode)
-                        {
-                            for (int y = 0; y < 64; ++y)  
-                            {
-                                for (int x = 127; x >= scroll; --x)  
-                                    graphics_extended[y * 128 + x] = graphics_extended[y * 128 + x - scroll];
-                                for (int x = 0; x < scroll; ++x)  
-                                    graphics_extended[y * 128 + x] = 0;
-                            }
-                        }
-                        else{
-                            for (int y = 0; y < 32; ++y) 
-                            {
-                                for (int x = 63; x >= scroll; --x) 
-                                    graphics[y * 64 + x] = graphics[y * 64 + x - scroll];
-                                for (int x = 0; x < scroll; ++x) 
-                                    graphics[y * 64 + x] = 0;
-                            }
-                        }
-                        break;
-                    }
-
-                    case 0x00FC:
-                    {
-                        // 00FC: Scroll display 4 pixels left
-                        const int scroll = 4;
-                        if(extendedScreenMode)
-                        {
-                            for (int y = 0; y < 64; ++y)  
-                            {
-                                for (int x = 0; x <= 127 - scroll; ++x)  
-                                    graphics_extended[y * 128 + x] = graphics_extended[y * 128 + x + scroll];
-
-                                for (int x = 128 - scroll; x < 128; ++x)  
-                                    graphics_extended[y * 128 + x] = 0;
-                            }
-                        }
-                        else{
-                            for (int y = 0; y < 32; ++y) 
-                            {
-                                for (int x = 0; x < 64 - scroll; ++x) 
-                                    graphics[y * 64 + x] = graphics[y * 64 + x + scroll];
-                                
-                                for (int x = 64 - scroll; x < 64; ++x) 
-                                    graphics[y * 64 + x] = 0;
-                            }
-                        }
-                        break;
-                    }
-
-                    case 0x00FD:
-                    {
-                        // 00FD: Exit the emulator
-                        exit(0);
-                        break;
-                    }
-
-                    case 0x00FE:
-                    {
-                        // 00FE: Disable extended screen mode
-                        extendedScreenMode = false;
-                        break;
-                    }
-
-                    case 0x00FF:
-                    {
-                        // 00FF: Enable extended screen mode
-                        extendedScreenMode = true;
-                        break;
-                    }
-
-                    default:
-                    {
-                        std::cout << "OPcode, 0x" << current_opcode << " is unknown, Your program has an error!" << std::endl;
-                        exit(0);
-                        break;
-                    }
-                    
-                }
-                increment_pc();
-                break;
+            advance_cycles(budget);
+            return budget;
+        }
 
-            case 0x1:
-                // Jump to location nnn.
-                std::cout << "Debug: Before JP addr - PC: " << program_counter << std::endl;
-                program_counter = (current_opcode & 0x0FFF);
-                
+        // Just ran FX07 at A, pc is A + 2. Each further pass is 3X00, 1A, FX07 and the
+        // 3X00 only falls through while the Vx it tests is non-zero.
+        if (!at_delay_poll(pc))
+            return 0;
+        uint8_t x = (read_opcode(pc) >> 8) & 0xF;
+        if (registers[x] == 0)
+            return 0;
+
+        // Ticks after the first k instructions from now, and the k at which DT has run out
+        uint64_t to_tick = cycles_per_frame - cycles_into_frame;
+        auto ticks = [&](uint64_t k) { return k < to_tick ? 0 : 1 + (k - to_tick) / cycles_per_frame; };
+        uint64_t runs_out = delay_timer == 0 ? 0 : to_tick + (delay_timer - 1ull) * cycles_per_frame;
+
+        // Pass j reads DT after 3j - 1 instructions and is only taken while pass j - 1 read non-zero
+        uint64_t passes = (runs_out + 3) / 3;
+        if (passes > budget / 3)
+            passes = budget / 3;
+        if (passes == 0)
+            return 0;
+
+        uint64_t last_tick_count = ticks(3 * passes - 1);
+        registers[x] = delay_timer > last_tick_count ? static_cast<uint8_t>(delay_timer - last_tick_count) : 0;
+        current_opcode = read_opcode(pc - 2);
+        advance_cycles(3 * passes);
+        return 3 * passes;
+    }
 
-                // Debug: Print the opcode in hex
-                char hex_string[20];
-                sprintf(hex_string, "%X", current_opcode);
-                std::cout << "Debug: Jumps to " << hex_string << std::endl;
-                std::cout << "Debug: After JP addr - PC: " << program_counter << std::endl;
+    // pc is just past an FX07 that starts a delay timer poll loop
+    bool at_delay_poll(uint16_t pc) const
+    {
+        if (pc < 2 || pc > 0xFFC)
+            return false;
+        uint16_t load = read_opcode(pc - 2);
+        uint16_t x = load & 0x0F00;
+        return (load & 0xF0FF) == 0xF007 && read_opcode(pc) == (0x3000 | x) && read_opcode(pc + 2) == (0x1000 | (pc - 2));
+    }
 
-                increment_pc();
-                break;
+    // Runs the rest of the current frame. When FX0A blocks, the remaining instruction slots
+    // of the frame are spent waiting so timers keep ticking at 60 Hz, and WaitingForKey is
+    // returned with the frame finished.
+    StopReason run_frame() { return run_frame_on(*this); }
+
+    // run_frame() with the instructions retired by engine, anything with the run_cycles()
+    // contract such as Chip8Jit or Chip8Aot. The end of the frame is fixed before running,
+    // FX0A in its last slot has already ticked the timers and leaves nothing to wait out.
+    // waited, when given, has the slots spent waiting added to it.
+    template <typename Engine>
+    StopReason run_frame_on(Engine &engine, uint64_t* waited = nullptr)
+    {
+        uint64_t frame_end = cycle_count + (cycles_per_frame - cycles_into_frame);
+        StopReason reason = engine.run_cycles(frame_end - cycle_count);
+        if (reason == StopReason::WaitingForKey && cycle_count < frame_end)
+        {
+            if (waited)
+                *waited += frame_end - cycle_count;
+            advance_cycles(frame_end - cycle_count);
+        }
+        return reason == StopReason::CycleLimit ? StopReason::FrameBoundary : reason;
+    }
 
-            case 0x2:
-                // Call subroutine at nnn.
-                stack[sp] = program_counter;
-                sp++;
-                program_counter = current_opcode & 0x0FFF;
-                break;
+    // One 60 Hz tick of the delay and sound timers
+    void tick_timers()
+    {
+        if (delay_timer > 0) 
+            delay_timer -= 1;
 
-            case 0x3:
-                // Skip next instruction if Vx = kk.
-                if (registers[(current_opcode & 0x0F00) >> 8] == (current_opcode & 0x00FF))
-                    increment_pc();  
-                increment_pc();
-                break;
+        if (sound_timer > 0) 
+            sound_timer -= 1;
 
-            case 0x4:
-                // Skip next instruction if Vx != kk.
-                if((registers[(current_opcode & 0x0F00) >> 8] != (current_opcode & 0x00FF)))
-                    increment_pc();  
-                increment_pc();
-                break;
+        ++frame_count;
+    }
 
-            case 0x5:
-                // Skip next instruction if Vx = Vy.
-                if(registers[(current_opcode & 0x0F00) >> 8] == registers[(current_opcode & 0x00FF) >> 4])
-                    increment_pc();  
-                increment_pc();
-                break;
-            
-            case 0x6:
-                // Set Vx = kk.
-                registers[(current_opcode& 0x0F00) >> 8] = static_cast<uint8_t>(current_opcode & 0x00FF);
-                increment_pc();
-                break;
-            
-            case 0x7:
-                // Set Vx = Vx + kk.
-                registers[(current_opcode& 0x0F00) >> 8] += static_cast<uint8_t>(current_opcode & 0x00FF);
-                increment_pc();
-                break;
+    // Moves the virtual clock forward n instructions, for engines that retire instructions in bulk
+    void advance_cycles(uint64_t n)
+    {
+        cycle_count += n;
+        uint64_t total = cycles_into_frame + n;
+        if (total < cycles_per_frame)
+        {
+            cycles_into_frame = static_cast<uint32_t>(total);
+            return;
+        }
+        uint64_t frames = total / cycles_per_frame;
+        delay_timer = delay_timer > frames ? static_cast<uint8_t>(delay_timer - frames) : 0;
+        sound_timer = sound_timer > frames ? static_cast<uint8_t>(sound_timer - frames) : 0;
+        frame_count += frames;
+        cycles_into_frame = static_cast<uint32_t>(total % cycles_per_frame);
+    }
 
-            case 0x8:
-            {
-                uint8_t x = (current_opcode & 0x0F00) >> 8;
-                uint8_t y = (current_opcode & 0x00F0) >> 4;
+    // Decoded form of one instruction, operands are extracted once when the slot is decoded
+    struct DecodedOp;
+    typedef StopReason (*OpHandler)(Chip8 &cpu, const DecodedOp &op);
 
-                switch (current_opcode & 0x000F)
-                {
-                    case 0x0:
-                        // 8XY0: Set Vx = Vy
-                        registers[x] = registers[y];
-                        break;
-
-                    case 0x1:
-                        // 8XY1: Set Vx = Vx OR Vy
-                        registers[x] |= registers[y];
-                        break;
-
-                    case 0x2:
-                        // 8XY2: Set Vx = Vx AND Vy
-                        registers[x] &= registers[y];
-                        break;
-
-                    case 0x3:
-                        // 8XY3: Set Vx = Vx XOR Vy
-                        registers[x] ^= registers[y];
-                        break;
-
-                    case 0x4:
-                        // 8XY4: Set Vx = Vx + Vy, set VF = carry
-                        if (static_cast<uint8_t>(registers[x]) + static_cast<uint8_t>(registers[y]) > 255U)
-                            registers[0xF] = 1;
-                        else
-                            registers[0xF] = 0;
-                        registers[x] += registers[y];
-                        break;
-
-                    case 0x5:
-                        // 8XY5: Set Vx = Vx - Vy, set VF = NOT borrow
-                        if (registers[x] > registers[y])
-                            registers[0xF] = 1;
-                        else
-                            registers[0xF] = 0;
-                        registers[x] -= registers[y];
-                        break;
-
-                    case 0x6:
-                        // 8XY6: Set Vx = Vx >> 1, set VF = LSB of Vx
-                        registers[0xF] = registers[x] & 0x1;
-                        registers[x] >>= 1;
-                        break;
-
-                    case 0x7:
-                        // 8XY7: Set Vx = Vy - Vx, set VF = NOT borrow
-                        if (registers[y] > registers[x])
-                            registers[0xF] = 0x1;
-                        else
-                            registers[0xF] = 0x0;
-                        registers[x] = registers[y] - registers[x];
-                        break;
-
-                    case 0xE:
-                        // 8XYE: Set Vx = Vx << 1, set VF = MSB of Vx
-                        registers[0xF] = (registers[x] >> 7) & 0x1; // Set VF = MSB of Vx
-                        registers[x] <<= 1; // multiplied by 2
-                        break;
-
-                    default:
-                    {
-                        std::cout << "Unknown opcode within 0x8 cases in ALU!" << std::endl;
-                        exit(0);
-                        break;
-                    }
-                }
+    struct DecodedOp
+    {
+        OpHandler handler = nullptr;  // nullptr marks the slot as not decoded yet
+        uint16_t opcode;
+        uint16_t nnn;
+        uint8_t x;
+        uint8_t y;
+        uint8_t n;
+        uint8_t nn;
+    };
 
-                increment_pc();
-                break;
-            }
+    // Decoded instruction cache, one entry per 2-byte slot of memory. Instructions at odd
+    // addresses are rare and get decoded on every visit through odd_slot instead.
+    DecodedOp decoded[4096 / 2];
+    DecodedOp odd_slot;
 
-            case 0x9:
-                // Skip next instruction if Vx != Vy.
-                if((registers[(current_opcode & 0x0F00) >> 8] != registers[(current_opcode & 0x00FF) >> 4]))
-                    increment_pc();  
-                increment_pc();
-                break;
+    // One bit per 64-byte page of memory written since the JIT last looked, so it can drop stale blocks
+    uint64_t code_dirty_pages = ~0ull;
 
-            case 0xA:
-                // Set I = nnn.
-                index = current_opcode & 0x0FFF;
-                increment_pc();
-                break;
+    // Same for the decoded slots, kept until Chip8Arena resets the machine to a boot image
+    uint64_t decoded_changed_pages = ~0ull;
 
-            case 0xB:
-                // Jump to location nnn + V0.
-                program_counter = registers[0] + static_cast<uint16_t>(current_opcode & 0x0FFF);
-                increment_pc();
-                break;
-            
-            case 0xC:
-                // Set Vx = random byte AND kk.
-	            registers[(current_opcode & 0x0F00) >> 8] = static_cast<uint8_t>(rand() & (current_opcode & 0x00FF));
-                increment_pc();
-                break;
-            
-            case 0xD:
-            {
-                // Display n-byte sprite starting at memory location I at (Vx, Vy), set VF = collision.
-                registers[0xF] = 0; // Reset VF for collision
+    // Every write into memory goes through here so the decoded slot covering the byte is dropped
+    void write_memory(uint16_t address, uint8_t value)
+    {
+        address &= 0xFFF;
+        memory[address] = value;
+        decoded[address >> 1].handler = nullptr;
+        code_dirty_pages |= 1ull << (address >> 6);
+        decoded_changed_pages |= 1ull << (address >> 6);
+    }
+
+    // Drops the decoded slots covering [start, start + length), call after writing memory directly
+    void invalidate_decoded(uint16_t start = 0, uint32_t length = 4096)
+    {
+        uint32_t end = start + length > 4096 ? 4096 : start + length;
+        for (uint32_t slot = start >> 1; slot < (end + 1) >> 1; ++slot)
+            decoded[slot].handler = nullptr;
+        for (uint32_t page = start >> 6; page < (end + 63) >> 6; ++page)
+        {
+            code_dirty_pages |= 1ull << page;
+            decoded_changed_pages |= 1ull << page;
+        }
+    }
+
+    uint16_t read_opcode(uint16_t pc) const
+    {
+        return static_cast<uint16_t>(memory[pc]) << 8 | memory[pc + 1];
+    }
+
+    const DecodedOp &fetch(uint16_t pc)
+    {
+        if (pc & 1)
+        {
+            odd_slot = decode(read_opcode(pc), extendedScreenMode, quirks);
+            return odd_slot;
+        }
+
+        DecodedOp &op = decoded[pc >> 1];
+        if (op.handler == nullptr)
+            op = decode(read_opcode(pc), extendedScreenMode, quirks);
+        return op;
+    }
+
+    StopReason cycle() 
+    {
+        if (status == StopReason::Halted || status == StopReason::Fault)
+            return status;
+        return step();
+    }
+
+    // One instruction through the decoded cache, callers check for a halted machine first
+    StopReason step()
+    {
+        switch (step_mode())
+        {
+            case step_traced:                 return step_as<step_traced>();
+            case step_profiled:               return step_as<step_profiled>();
+            case step_traced | step_profiled: return step_as<step_traced | step_profiled>();
+            default:                          return step_as<0>();
+        }
+    }
+
+    // Instrumentation a step runs with, each combination is its own instantiation of step_as()
+    enum { step_traced = 1, step_profiled = 2 };
+
+    int step_mode() const
+    {
+        int mode = 0;
+#ifndef CHIP8_NO_TRACE
+        if (trace != nullptr)
+            mode |= step_traced;
+#endif
+#ifndef CHIP8_NO_PROFILE
+        if (profile != nullptr)
+            mode |= step_profiled;
+#endif
+        return mode;
+    }
+
+    template <int mode>
+    StopReason step_as()
+    {
+        if (program_counter > 0xFFE)
+            return fault("OPcode out of range! Your program has an error!");
+
+        uint16_t pc = program_counter;
+        const DecodedOp &op = fetch(pc);
+        current_opcode = op.opcode;
+        ++cycle_count;
+
+        StopReason reason = (mode & step_traced) ? execute_traced(op) : op.handler(*this, op);
+        if (mode & step_profiled)
+            profile->record(pc, current_opcode, program_counter);
+
+        if (++cycles_into_frame == cycles_per_frame)
+        {
+            cycles_into_frame = 0;
+            tick_timers();
+        }
+
+        return reason;
+    }
+
+    // Runs one handler and records what it did
+    StopReason execute_traced(const DecodedOp &op)
+    {
+        Chip8TraceRecord record;
+        record.cycle = cycle_count - 1;
+        record.pc = program_counter;
+        record.opcode = op.opcode;
+        uint8_t before[16];
+        memcpy(before, registers, sizeof(before));
+
+        StopReason reason = op.handler(*this, op);
+
+        record.index = index;
+        record.changed = 0;
+        for (int r = 0; r < 16; ++r)
+            if (registers[r] != before[r])
+                record.changed |= 1 << r;
+        memcpy(record.registers, registers, sizeof(registers));
+        trace->push(record);
+        return reason;
+    }
+
+    // Picks the handler for an opcode and pre-extracts X, Y, N, NN and NNN. Display and quirk
+    // dependent opcodes get the handler compiled for the given mode and profile.
+    static DecodedOp decode(uint16_t opcode, bool extended = false, QuirkProfile quirks = QuirkProfile::Original)
+    {
+        switch (quirks)
+        {
+            case QuirkProfile::CosmacVip: return decode_for<CosmacVipQuirks>(opcode, extended);
+            case QuirkProfile::SuperChip: return decode_for<SuperChipQuirks>(opcode, extended);
+            case QuirkProfile::XoChip:    return decode_for<XoChipQuirks>(opcode, extended);
+            default:                      return decode_for<OriginalQuirks>(opcode, extended);
+        }
+    }
+
+    template <class Q>
+    static DecodedOp decode_for(uint16_t opcode, bool extended)
+    {
+        DecodedOp op;
+        op.opcode = opcode;
+        op.nnn = opcode & 0x0FFF;
+        op.x = (opcode & 0x0F00) >> 8;
+        op.y = (opcode & 0x00F0) >> 4;
+        op.n = opcode & 0x000F;
+        op.nn = opcode & 0x00FF;
+        op.handler = &op_unknown;
 
-                uint8_t x = registers[(current_opcode & 0x0F00) >> 8];
-                uint8_t y = registers[(current_opcode & 0x00F0) >> 4];
-                uint8_t height = current_opcode & 0x000F;
+        // X000
+        switch (opcode >> 12)
+        {
+            case 0x0:
+                if (opcode == 0x0000)                 op.handler = &op_0000;
+                else if ((opcode & 0xFFF0) == 0x00C0) op.handler = extended ? &op_00CN<true> : &op_00CN<false>;
+                else if (opcode == 0x00E0)            op.handler = extended ? &op_00E0<true> : &op_00E0<false>;
+                else if (opcode == 0x00EE)            op.handler = &op_00EE;
+                else if (opcode == 0x00FB)            op.handler = extended ? &op_00FB<true> : &op_00FB<false>;
+                else if (opcode == 0x00FC)            op.handler = extended ? &op_00FC<true> : &op_00FC<false>;
+                else if (opcode == 0x00FD)            op.handler = &op_00FD;
+                else if (opcode == 0x00FE)            op.handler = &op_00FE;
+                else if (opcode == 0x00FF)            op.handler = &op_00FF;
+                break;
 
+            case 0x1: op.handler = &op_1NNN; break;
+            case 0x2: op.handler = &op_2NNN; break;
+            case 0x3: op.handler = &op_3XNN; break;
+            case 0x4: op.handler = &op_4XNN; break;
+            case 0x5: op.handler = &op_5XY0; break;
+            case 0x6: op.handler = &op_6XNN; break;
+            case 0x7: op.handler = &op_7XNN; break;
 
-                for (int row = 0; row < height; ++row) 
+            case 0x8:
+                switch (op.n)
                 {
-                    uint8_t spriteByte = memory[index + row];
-
-                    for (int col = 0; col < 8; ++col) {
-                        uint8_t pixelValue = (spriteByte >> (7 - col)) & 0x1;
-
-                        // Wrap if going beyond screen boundaries for extended and standard screen modes
-                        int dispX = (x + col) % (extendedScreenMode ? 128 : 64); 
-                        int dispY = (y + row) % (extendedScreenMode ? 64 : 32);
-
-                        // Handles Dxyn & Dxy0 cases for collision
-                        if (pixelValue == 1) 
-                        {
-                            if (extendedScreenMode) 
-                            {
-                                // Handle extended screen mode
-                                // Update graphics_extended array
-                                int index = dispY * 128 + dispX;
-                                graphics_extended[index] ^= 1; 
-                                if (graphics_extended[index] == 0 && pixelValue == 1) 
-                                    registers[0xF] = 1; // Collision occurred
-
-                            } 
-                            else 
-                            {
-                                // Handle standard screen mode
-                                // Update graphics array
-                                int index = dispY * 64 + dispX;
-                                graphics[index] ^= 1;
-                                if (graphics[index] == 0 && pixelValue == 1) 
-                                    registers[0xF] = 1; // Collision occurred
-
-                            }
-                        }
-                    }
+                    case 0x0: op.handler = &op_8XY0; break;
+                    case 0x1: op.handler = &op_8XY1; break;
+                    case 0x2: op.handler = &op_8XY2; break;
+                    case 0x3: op.handler = &op_8XY3; break;
+                    case 0x4: op.handler = &op_8XY4; break;
+                    case 0x5: op.handler = &op_8XY5; break;
+                    case 0x6: op.handler = &op_8XY6<Q>; break;
+                    case 0x7: op.handler = &op_8XY7; break;
+                    case 0xE: op.handler = &op_8XYE<Q>; break;
                 }
-                increment_pc();
                 break;
-            }
+
+            case 0x9: op.handler = &op_9XY0; break;
+            case 0xA: op.handler = &op_ANNN; break;
+            case 0xB: op.handler = &op_BNNN<Q>; break;
+            case 0xC: op.handler = &op_CXNN; break;
+            case 0xD:
+                if (op.n == 0) op.handler = extended ? &op_DXY0<true, Q> : &op_DXY0<false, Q>;
+                else           op.handler = extended ? &op_DXYN<true, Q> : &op_DXYN<false, Q>;
+                break;
 
             case 0xE:
-            {
-                // Handle key input
-                if (current_opcode == 0x9E) 
-                {
-                    uint8_t key = registers[(current_opcode & 0x0F00) >> 8];
-                    if (keys[key] == 1) 
-                        increment_pc();
-                } 
-                else if (current_opcode == 0xA1) 
+                if (op.nn == 0x9E)      op.handler = &op_EX9E;
+                else if (op.nn == 0xA1) op.handler = &op_EXA1;
+                break;
+
+            case 0xF:
+                // cases of FX
+                switch (op.nn)
                 {
-                    uint8_t key = registers[(current_opcode & 0x0F00) >> 8];
-                    if (keys[key] != 1) 
-                        increment_pc();
+                    case 0x07: op.handler = &op_FX07; break;
+                    case 0x0A: op.handler = &op_FX0A; break;
+                    case 0x15: op.handler = &op_FX15; break;
+                    case 0x18: op.handler = &op_FX18; break;
+                    case 0x1E: op.handler = &op_FX1E; break;
+                    case 0x29: op.handler = &op_FX29; break;
+                    case 0x30: op.handler = &op_FX30; break;
+                    case 0x33: op.handler = &op_FX33; break;
+                    case 0x55: op.handler = &op_FX55<Q>; break;
+                    case 0x65: op.handler = &op_FX65<Q>; break;
+                    case 0x75: op.handler = &op_FX75; break;
+                    case 0x85: op.handler = &op_FX85; break;
                 }
-                
                 break;
+        }
+        return op;
+    }
+
+    // Opcode handlers, each one is responsible for moving the program counter
+
+    static StopReason op_unknown(Chip8 &c, const DecodedOp &op)
+    {
+        switch (op.opcode >> 12)
+        {
+            case 0x0: return c.fault("Unknown 0x0 opcode, Your program has an error!");
+            case 0x8: return c.fault("Unknown opcode within 0x8 cases in ALU!");
+            case 0xE: return c.fault("Unknown opcode within 0xE cases in ALU!");
+            default:  return c.fault("Unknown opcode within 0xF cases in ALU!");
+        }
+    }
+
+    static StopReason op_0000(Chip8 &, const DecodedOp &)
+    {
+        // Spin in place on empty memory
+        return StopReason::None;
+    }
+
+    template <bool extended>
+    static StopReason op_00CN(Chip8 &c, const DecodedOp &op)
+    {
+        // 00CN: Scroll display N lines down
+        uint8_t N = op.n;
+        if(extended)
+        {
+            memmove(c.graphics_extended[N], c.graphics_extended[0], sizeof(c.graphics_extended[0]) * (64 - N));
+            memset(c.graphics_extended[0], 0, sizeof(c.graphics_extended[0]) * N);
+        }
+        else
+        {
+            memmove(&c.graphics[N], &c.graphics[0], sizeof(c.graphics[0]) * (32 - N));
+            memset(&c.graphics[0], 0, sizeof(c.graphics[0]) * N);
+        }
+        c.mark_display_changed();
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    template <bool extended>
+    static StopReason op_00E0(Chip8 &c, const DecodedOp &)
+    {
+        //Clear the display.
+        c.clear_as<extended>();
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_00EE(Chip8 &c, const DecodedOp &)
+    {
+        // 00EE: Return from a subroutine
+        if (c.sp == 0)
+            return c.fault("Stack underflow! Your program has an error!");
+        --c.sp;
+        c.program_counter = c.stack[c.sp];
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    template <bool extended>
+    static StopReason op_00FB(Chip8 &c, const DecodedOp &)
+    {
+        // 00FB: Scroll display 4 pixels right, pixels move towards the low bits
+        const int scroll = 4;
+        if(extended)
+        {
+            for (auto &row : c.graphics_extended)
+            {
+                row[1] = (row[1] >> scroll) | (row[0] << (64 - scroll));
+                row[0] >>= scroll;
             }
+        }
+        else{
+            for (auto &row : c.graphics)
+                row >>= scroll;
+        }
+        c.mark_display_changed();
+        c.increment_pc();
+        return StopReason::None;
+    }
 
-            case 0xF:
+    template <bool extended>
+    static StopReason op_00FC(Chip8 &c, const DecodedOp &)
+    {
+        // 00FC: Scroll display 4 pixels left
+        const int scroll = 4;
+        if(extended)
+        {
+            for (auto &row : c.graphics_extended)
             {
-                // cases of FX
+                row[0] = (row[0] << scroll) | (row[1] >> (64 - scroll));
+                row[1] <<= scroll;
+            }
+        }
+        else{
+            for (auto &row : c.graphics)
+                row <<= scroll;
+        }
+        c.mark_display_changed();
+        c.increment_pc();
+        return StopReason::None;
+    }
 
-                switch(current_opcode & 0x00FF)
-                {
-                    case 0x07:
-                        registers[((current_opcode & 0x0F00) >> 8)] = delay_timer;
-                        break;
-                    
-                    case 0x0A:
-                        executeFX_0A(current_opcode);
-                        break;
-
-                    case 0x15:
-                        delay_timer = registers[((current_opcode & 0x0F00) >> 8)];
-                        break;
-                    
-                    case 0x18:
-                        sound_timer = registers[((current_opcode & 0x0F00) >> 8)];
-                        break;
-                    
-                    case 0x1E:
-                        index += registers[((current_opcode & 0x0F00) >> 8)];
-                        index &= 0xFFF;  // Mask to prevent overflow
-                        break;
-                    
-                    case 0x29:
-                        index += registers[((current_opcode & 0x0F00) >> 8)] * 0x5;
-                        break;
-                    
-                    case 0x30:
-                        index = registers[(current_opcode & 0x0F00) >> 8] * 5;
-                        break;
-
-                    case 0x33:
-                    {
-                        uint8_t value = registers[((current_opcode & 0x0F00) >> 8)];
-                        memory[index]     = value / 100;          // Hundreds digit
-                        memory[index + 1] = (value / 10) % 10;    // Tens digit
-                        memory[index + 2] = value % 10;           // Ones digit
-                        break;
-                    }
-                    
-                    case 0x55:
-                        for(int i = 0; i < ((current_opcode & 0x0F00) >> 8); ++i)
-                            memory[index + i] = registers[i];
-                        break;
-
-                    case 0x65:
-                        for(int i = 0; i < ((current_opcode & 0x0F00) >> 8); ++i)
-                            registers[i] = memory[index + i];
-                        break;
-
-                    case 0x75:
-                        for (int i = 0; i <= ((current_opcode & 0x0F00) >> 8); ++i)
-                        {
-                            // Save registers V0 to VX in RPL user flags
-                            rpl_user_flags[i] = registers[i];
-                        }
-                        break;
-
-                    case 0x85:
-                        for (int i = 0; i <= ((current_opcode & 0x0F00) >> 8); ++i)
-                        {
-                            // Read from RPL user flags and store in registers V0 to VX
-                            registers[i] = rpl_user_flags[i];
-                        }
-                        break;   
-
-                    default:
-                    {   
-                        std::cout<< "Unknown opcode within 0xF cases in ALU!" << std::endl;
-                        exit(0);
-                        break;
-                    }
+    static StopReason op_00FD(Chip8 &c, const DecodedOp &)
+    {
+        // 00FD: Exit the emulator
+        c.status = StopReason::Halted;
+        return c.status;
+    }
 
+    static StopReason op_00FE(Chip8 &c, const DecodedOp &)
+    {
+        // 00FE: Disable extended screen mode
+        c.set_display_mode(false);
+        c.increment_pc();
+        return StopReason::None;
+    }
 
-                }
-                increment_pc();
-                break;
-            
-            }
+    static StopReason op_00FF(Chip8 &c, const DecodedOp &)
+    {
+        // 00FF: Enable extended screen mode
+        c.set_display_mode(true);
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_1NNN(Chip8 &c, const DecodedOp &op)
+    {
+        // Jump to location nnn, to itself is an idle loop
+        bool idle = op.nnn == c.program_counter;
+        c.program_counter = op.nnn;
+        return idle ? StopReason::Idle : StopReason::None;
+    }
+
+    static StopReason op_2NNN(Chip8 &c, const DecodedOp &op)
+    {
+        // Call subroutine at nnn.
+        if (c.sp >= 32)
+            return c.fault("Stack overflow! Your program has an error!");
+        c.stack[c.sp] = c.program_counter;
+        c.sp++;
+        c.program_counter = op.nnn;
+        return StopReason::None;
+    }
+
+    static StopReason op_3XNN(Chip8 &c, const DecodedOp &op)
+    {
+        // Skip next instruction if Vx = kk.
+        c.program_counter += c.registers[op.x] == op.nn ? 4 : 2;
+        return StopReason::None;
+    }
+
+    static StopReason op_4XNN(Chip8 &c, const DecodedOp &op)
+    {
+        // Skip next instruction if Vx != kk.
+        c.program_counter += c.registers[op.x] != op.nn ? 4 : 2;
+        return StopReason::None;
+    }
+
+    static StopReason op_5XY0(Chip8 &c, const DecodedOp &op)
+    {
+        // Skip next instruction if Vx = Vy.
+        c.program_counter += c.registers[op.x] == c.registers[op.y] ? 4 : 2;
+        return StopReason::None;
+    }
+
+    static StopReason op_6XNN(Chip8 &c, const DecodedOp &op)
+    {
+        // Set Vx = kk.
+        c.registers[op.x] = op.nn;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_7XNN(Chip8 &c, const DecodedOp &op)
+    {
+        // Set Vx = Vx + kk.
+        c.registers[op.x] += op.nn;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_8XY0(Chip8 &c, const DecodedOp &op)
+    {
+        // 8XY0: Set Vx = Vy
+        c.registers[op.x] = c.registers[op.y];
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_8XY1(Chip8 &c, const DecodedOp &op)
+    {
+        // 8XY1: Set Vx = Vx OR Vy
+        c.registers[op.x] |= c.registers[op.y];
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_8XY2(Chip8 &c, const DecodedOp &op)
+    {
+        // 8XY2: Set Vx = Vx AND Vy
+        c.registers[op.x] &= c.registers[op.y];
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_8XY3(Chip8 &c, const DecodedOp &op)
+    {
+        // 8XY3: Set Vx = Vx XOR Vy
+        c.registers[op.x] ^= c.registers[op.y];
+        c.increment_pc();
+        return StopReason::None;
+    }
 
+    static StopReason op_8XY4(Chip8 &c, const DecodedOp &op)
+    {
+        // 8XY4: Set Vx = Vx + Vy, set VF = carry
+        uint16_t sum = c.registers[op.x] + c.registers[op.y];
+        c.registers[op.x] = static_cast<uint8_t>(sum);
+        c.registers[0xF] = sum > 255U ? 1 : 0;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_8XY5(Chip8 &c, const DecodedOp &op)
+    {
+        // 8XY5: Set Vx = Vx - Vy, set VF = NOT borrow
+        uint8_t not_borrow = c.registers[op.x] >= c.registers[op.y] ? 1 : 0;
+        c.registers[op.x] -= c.registers[op.y];
+        c.registers[0xF] = not_borrow;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    template <class Q>
+    static StopReason op_8XY6(Chip8 &c, const DecodedOp &op)
+    {
+        // 8XY6: Set Vx = Vx >> 1 (Vy >> 1 on the VIP), set VF = the bit shifted out
+        uint8_t source = c.registers[Q::shift_uses_vy ? op.y : op.x];
+        c.registers[op.x] = source >> 1;
+        c.registers[0xF] = source & 0x1;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_8XY7(Chip8 &c, const DecodedOp &op)
+    {
+        // 8XY7: Set Vx = Vy - Vx, set VF = NOT borrow
+        uint8_t not_borrow = c.registers[op.y] >= c.registers[op.x] ? 1 : 0;
+        c.registers[op.x] = c.registers[op.y] - c.registers[op.x];
+        c.registers[0xF] = not_borrow;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    template <class Q>
+    static StopReason op_8XYE(Chip8 &c, const DecodedOp &op)
+    {
+        // 8XYE: Set Vx = Vx << 1 (Vy << 1 on the VIP), set VF = the bit shifted out
+        uint8_t source = c.registers[Q::shift_uses_vy ? op.y : op.x];
+        c.registers[op.x] = static_cast<uint8_t>(source << 1); // multiplied by 2
+        c.registers[0xF] = source >> 7;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_9XY0(Chip8 &c, const DecodedOp &op)
+    {
+        // Skip next instruction if Vx != Vy.
+        c.program_counter += c.registers[op.x] != c.registers[op.y] ? 4 : 2;
+        return StopReason::None;
+    }
+
+    static StopReason op_ANNN(Chip8 &c, const DecodedOp &op)
+    {
+        // Set I = nnn.
+        c.index = op.nnn;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    template <class Q>
+    static StopReason op_BNNN(Chip8 &c, const DecodedOp &op)
+    {
+        // Jump to location nnn + V0, or xnn + Vx on the SUPER-CHIP
+        c.program_counter = (c.registers[Q::jump_uses_vx ? op.x : 0] + op.nnn) & 0xFFF;
+        return StopReason::None;
+    }
+
+    static StopReason op_CXNN(Chip8 &c, const DecodedOp &op)
+    {
+        // Set Vx = random byte AND kk.
+        c.registers[op.x] = static_cast<uint8_t>(c.next_random() & op.nn);
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static uint64_t rotate_right(uint64_t bits, unsigned shift)
+    {
+        shift &= 63;
+        return shift ? (bits >> shift) | (bits << (64 - shift)) : bits;
+    }
+
+    // Rotates a 128-pixel row held as {left word, right word}
+    // 128-bit shift right across left:right, bits falling off the right end are lost
+    static void shift_right(uint64_t &left, uint64_t &right, unsigned shift)
+    {
+        if (shift >= 64)
+        {
+            right = left >> (shift - 64);
+            left = 0;
         }
+        else if (shift)
+        {
+            right = (right >> shift) | (left << (64 - shift));
+            left >>= shift;
+        }
+    }
 
-        if (delay_timer > 0) 
-            delay_timer -= 1;
+    static void rotate_right(uint64_t &left, uint64_t &right, unsigned shift)
+    {
+        shift &= 127;
+        if (shift >= 64)
+        {
+            uint64_t t = left;
+            left = right;
+            right = t;
+            shift -= 64;
+        }
+        if (shift)
+        {
+            uint64_t l = (left >> shift) | (right << (64 - shift));
+            uint64_t r = (right >> shift) | (left << (64 - shift));
+            left = l;
+            right = r;
+        }
+    }
 
-        if (sound_timer > 0) 
-            sound_timer -= 1;
+    // Display n-byte sprite starting at memory location I at (Vx, Vy), set VF = collision.
+    // Each sprite row is shifted into place as a whole word, XORed in, and collides if it
+    // overlapped any pixel that was already set. Sprites wrap around both screen edges.
+    template <bool extended, class Q>
+    static StopReason op_DXYN(Chip8 &c, const DecodedOp &op)
+    {
+        draw_sprite<extended, false, Q::sprites_clip>(c, op, op.n);
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    // DXY0 is the SUPER-CHIP big sprite, 16x16 in extended mode and 8x16 otherwise
+    template <bool extended, class Q>
+    static StopReason op_DXY0(Chip8 &c, const DecodedOp &op)
+    {
+        draw_sprite<extended, extended, Q::sprites_clip>(c, op, 16);
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    // Mode, sprite width and clipping are template parameters so the row loop has no branches
+    // on them. Clipped sprites still wrap their starting position onto the screen.
+    template <bool extended, bool wide, bool clip>
+    static void draw_sprite(Chip8 &c, const DecodedOp &op, int height)
+    {
+        const int row_mask = extended ? 63 : 31;
+        const int column_mask = extended ? 127 : 63;
+        uint8_t x = c.registers[op.x];
+        uint8_t y = c.registers[op.y];
+        uint64_t collision = 0;
+
+        if (clip)
+        {
+            x &= column_mask;
+            y &= row_mask;
+            if (height > row_mask + 1 - y)
+                height = row_mask + 1 - y;
+        }
+
+        for (int row = 0; row < height; ++row) 
+        {
+            uint16_t spriteRow;
+            if (wide)
+                spriteRow = static_cast<uint16_t>(c.memory[(c.index + row * 2) & 0xFFF]) << 8 | c.memory[(c.index + row * 2 + 1) & 0xFFF];
+            else
+                spriteRow = static_cast<uint16_t>(c.memory[(c.index + row) & 0xFFF]) << 8;
+
+            int line_y = (y + row) & row_mask;
+            if (extended) 
+            {
+                uint64_t left = static_cast<uint64_t>(spriteRow) << 48;
+                uint64_t right = 0;
+                if (clip)
+                    shift_right(left, right, x);
+                else
+                    rotate_right(left, right, x);
+                uint64_t* line = c.graphics_extended[line_y];
+                collision |= (line[0] & left) | (line[1] & right);
+                line[0] ^= left;
+                line[1] ^= right;
+            } 
+            else 
+            {
+                uint64_t sprite_bits = static_cast<uint64_t>(spriteRow) << 48;
+                uint64_t bits = clip ? sprite_bits >> x : rotate_right(sprite_bits, x);
+                uint64_t &line = c.graphics[line_y];
+                collision |= line & bits;
+                line ^= bits;
+            }
+        }
+        c.registers[0xF] = collision != 0 ? 1 : 0;
+        c.mark_display_changed();
+    }
+
+    static StopReason op_EX9E(Chip8 &c, const DecodedOp &op)
+    {
+        // Skip next instruction if key Vx is pressed
+        c.program_counter += c.keys[c.registers[op.x] & 0xF] != 0 ? 4 : 2;
+        return StopReason::None;
+    }
+
+    static StopReason op_EXA1(Chip8 &c, const DecodedOp &op)
+    {
+        // Skip next instruction if key Vx is not pressed
+        c.program_counter += c.keys[c.registers[op.x] & 0xF] == 0 ? 4 : 2;
+        return StopReason::None;
+    }
+
+    static StopReason op_FX07(Chip8 &c, const DecodedOp &op)
+    {
+        c.registers[op.x] = c.delay_timer;
+        c.increment_pc();
+        return c.registers[op.x] != 0 && c.at_delay_poll(c.program_counter) ? StopReason::Idle : StopReason::None;
+    }
+
+    static StopReason op_FX0A(Chip8 &c, const DecodedOp &op)
+    {
+        uint16_t opcode = op.opcode;
+        bool key_pressed = c.executeFX_0A(opcode);
+        c.increment_pc();
+        return key_pressed ? StopReason::None : StopReason::WaitingForKey;
+    }
+
+    static StopReason op_FX15(Chip8 &c, const DecodedOp &op)
+    {
+        c.delay_timer = c.registers[op.x];
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_FX18(Chip8 &c, const DecodedOp &op)
+    {
+        c.sound_timer = c.registers[op.x];
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_FX1E(Chip8 &c, const DecodedOp &op)
+    {
+        c.index += c.registers[op.x];
+        c.index &= 0xFFF;  // Mask to prevent overflow
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_FX29(Chip8 &c, const DecodedOp &op)
+    {
+        // Point I at the 5-byte font sprite for digit Vx
+        c.index = chip8_font_address + (c.registers[op.x] & 0xF) * 5;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_FX30(Chip8 &c, const DecodedOp &op)
+    {
+        // Point I at the 10-byte SUPER-CHIP font sprite for digit Vx
+        c.index = chip48_font_address + (c.registers[op.x] & 0xF) * 10;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_FX33(Chip8 &c, const DecodedOp &op)
+    {
+        uint8_t value = c.registers[op.x];
+        c.write_memory(c.index,     value / 100);          // Hundreds digit
+        c.write_memory(c.index + 1, (value / 10) % 10);    // Tens digit
+        c.write_memory(c.index + 2, value % 10);           // Ones digit
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    template <class Q>
+    static StopReason op_FX55(Chip8 &c, const DecodedOp &op)
+    {
+        // Store V0 to VX at I
+        const int last = Q::load_store_skips_vx ? op.x - 1 : op.x;
+        for (int i = 0; i <= last; ++i)
+            c.write_memory(c.index + i, c.registers[i]);
+        if (Q::load_store_advances_i)
+            c.index = (c.index + op.x + 1) & 0xFFF;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    template <class Q>
+    static StopReason op_FX65(Chip8 &c, const DecodedOp &op)
+    {
+        // Load V0 to VX from I
+        const int last = Q::load_store_skips_vx ? op.x - 1 : op.x;
+        for (int i = 0; i <= last; ++i)
+            c.registers[i] = c.memory[(c.index + i) & 0xFFF];
+        if (Q::load_store_advances_i)
+            c.index = (c.index + op.x + 1) & 0xFFF;
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_FX75(Chip8 &c, const DecodedOp &op)
+    {
+        // Save registers V0 to VX in RPL user flags
+        for (int i = 0; i <= op.x && i < 8; ++i)
+            c.rpl_user_flags[i] = c.registers[i];
+        c.increment_pc();
+        return StopReason::None;
+    }
+
+    static StopReason op_FX85(Chip8 &c, const DecodedOp &op)
+    {
+        // Read from RPL user flags and store in registers V0 to VX
+        for (int i = 0; i <= op.x && i < 8; ++i)
+            c.registers[i] = c.rpl_user_flags[i];
+        c.increment_pc();
+        return StopReason::None;
     }
 };
 
+// Room between 0x200 and the end of memory
+static const size_t chip8_max_rom_size = 4096 - 0x200;
+
+// Copies a program image to 0x200, refusing anything that doesn't fit
+bool loadROM(const uint8_t* data, size_t size, Chip8 &cpu)
+{
+    if (size == 0 || size > chip8_max_rom_size)
+        return false;
+    memcpy(&cpu.memory[0x200], data, size);
+    cpu.invalidate_decoded(0x200, static_cast<uint32_t>(size));
+    return true;
+}
+
+bool loadROM(const char* filename, Chip8 &cpu)  // Implement file opener
+{
+    std::ifstream rom(filename, std::ios::binary);
+
+    if (rom.is_open()) {
+        rom.seekg(0, std::ios::end);
+        std::streampos size = rom.tellg();
+        rom.seekg(0, std::ios::beg);
+
+        std::cout << "Loading ROM: " << filename << std::endl;
+        if (size <= 0 || static_cast<size_t>(size) > chip8_max_rom_size) {
+            std::cerr << "ROM is " << size << " bytes, it has to fit in " << chip8_max_rom_size << std::endl;
+            return false;
+        }
+
+        // Read the ROM directly into Chip-8 memory starting from 0x200
+        rom.read(reinterpret_cast<char*>(&cpu.memory[0x200]), size);
+        cpu.invalidate_decoded(0x200, static_cast<uint32_t>(size));
+        return static_cast<bool>(rom);
+    }
+    return false;
+}
+
 
 
@@ -0,0 +1,149 @@
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "regress.cpp"
+
+using namespace std;
+
+// The manifest again with hash= set from this run on every entry that ran
+static bool write_goldens(const char* manifest_path, const char* golden_path, const vector<Chip8RegressionEntry> &entries,
+                          const vector<Chip8RegressionResult> &results)
+{
+    ifstream manifest(manifest_path);
+    FILE* out = fopen(golden_path, "w");
+    if (!manifest.is_open() || out == nullptr)
+    {
+        if (out)
+            fclose(out);
+        return false;
+    }
+
+    string line;
+    size_t next = 0;
+    for (int number = 1; getline(manifest, line); ++number)
+    {
+        if (next == entries.size() || entries[next].line_number != number)
+        {
+            fprintf(out, "%s\n", line.c_str());
+            continue;
+        }
+        const Chip8RegressionResult &result = results[next++];
+        if (result.verdict == Chip8Verdict::Unreadable)
+        {
+            fprintf(out, "%s\n", line.c_str());
+            continue;
+        }
+
+        istringstream words(line);
+        string word, rewritten;
+        while (words >> word)
+            if (word.compare(0, 5, "hash=") != 0)
+                rewritten += (rewritten.empty() ? "" : " ") + word;
+        fprintf(out, "%s hash=%016llx\n", rewritten.c_str(), static_cast<unsigned long long>(result.hash));
+    }
+    return fclose(out) == 0;
+}
+
+// Runs every entry of a regression manifest (see regress.cpp) across all cores and checks the
+// display at the end of each against its golden hash.
+// Usage: farm [--threads N] [--jit] [--golden out] <manifest>
+// --golden writes the manifest again with every run's hash, to accept new or changed goldens.
+// Exits non-zero on any mismatch, fault or missing ROM.
+int main(int argc, char* argv[])
+{
+    size_t threads = 0;
+    bool use_jit = false;
+    const char* golden_path = nullptr;
+    const char* manifest_path = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--jit") == 0)
+            use_jit = true;
+        else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc)
+            golden_path = argv[++i];
+        else
+            manifest_path = argv[i];
+    }
+
+    if (manifest_path == nullptr)
+    {
+        fprintf(stderr, "Usage: farm [--threads N] [--jit] [--golden out] <manifest>\n");
+        return EXIT_FAILURE;
+    }
+
+    vector<Chip8RegressionEntry> entries;
+    string error;
+    if (!parse_chip8_manifest(manifest_path, entries, error))
+    {
+        fprintf(stderr, "%s\n", error.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // Longest first, by instructions to run
+    vector<size_t> order(entries.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    auto cost = [&](size_t i) { return entries[i].by_frames ? entries[i].length * entries[i].ipf : entries[i].length; };
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return cost(a) > cost(b); });
+
+    vector<Chip8RegressionResult> results(entries.size());
+    Chip8WorkPool pool(threads);
+    auto start = chrono::steady_clock::now();
+    pool.run(order, [&](size_t i) { results[i] = run_chip8_regression(entries[i], use_jit); });
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    size_t counts[5] = {};
+    uint64_t instructions = 0;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const Chip8RegressionEntry &entry = entries[i];
+        const Chip8RegressionResult &result = results[i];
+        ++counts[static_cast<int>(result.verdict)];
+        instructions += result.instructions;
+        if (result.verdict == Chip8Verdict::Unreadable)
+        {
+            printf("%-5s %s (line %d)\n", chip8_verdict_name(result.verdict), entry.rom.c_str(), entry.line_number);
+            continue;
+        }
+
+        printf("%-5s %-32s %8llu frames %12llu instr %8.1f MIPS  %016llx", chip8_verdict_name(result.verdict),
+               entry.rom.c_str(), static_cast<unsigned long long>(result.frames),
+               static_cast<unsigned long long>(result.instructions),
+               result.seconds > 0 ? result.instructions / result.seconds / 1e6 : 0.0,
+               static_cast<unsigned long long>(result.hash));
+        if (result.verdict == Chip8Verdict::Mismatch)
+            printf(", expected %016llx", static_cast<unsigned long long>(entry.hash));
+        if (result.verdict == Chip8Verdict::Fault)
+            printf(", %s (PC 0x%03X)", result.fault_message ? result.fault_message : "fault", result.program_counter);
+        else if (result.stop == StopReason::Halted)
+            printf(", halted");
+        printf("\n");
+    }
+
+    printf("\nRuns: %zu, passed %zu, failed %zu, faulted %zu, new %zu, missing ROMs %zu\n", entries.size(),
+           counts[static_cast<int>(Chip8Verdict::Pass)], counts[static_cast<int>(Chip8Verdict::Mismatch)],
+           counts[static_cast<int>(Chip8Verdict::Fault)], counts[static_cast<int>(Chip8Verdict::NoGolden)],
+           counts[static_cast<int>(Chip8Verdict::Unreadable)]);
+    printf("Threads: %zu, wall ms: %.1f, instructions: %llu", pool.threads(), seconds * 1e3,
+           static_cast<unsigned long long>(instructions));
+    if (seconds > 0)
+        printf(", MIPS: %.1f", instructions / seconds / 1e6);
+    printf("\n");
+
+    if (golden_path)
+    {
+        if (!write_goldens(manifest_path, golden_path, entries, results))
+        {
+            fprintf(stderr, "Could not write goldens: %s\n", golden_path);
+            return EXIT_FAILURE;
+        }
+    }
+
+    bool failed = counts[static_cast<int>(Chip8Verdict::Mismatch)] || counts[static_cast<int>(Chip8Verdict::Fault)] ||
+                  counts[static_cast<int>(Chip8Verdict::Unreadable)];
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
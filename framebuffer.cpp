@@ -0,0 +1,67 @@
+#pragma once
+
+// Hand-off of finished frames from the emulation thread to the render thread.
+//
+// Chip8TripleBuffer keeps three copies of a T. The writer fills its back buffer and
+// publish() swaps it with the middle one, the reader's acquire() swaps the middle one
+// with its front buffer if something new was published. Both swaps are a single atomic
+// exchange, so neither thread ever waits for the other. The reader always gets the newest
+// complete frame and frames it was too slow for are skipped.
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include "cpu.cpp"
+
+template <typename T>
+class Chip8TripleBuffer {
+public:
+
+    // Writer side
+    T &back() { return buffers[back_index]; }
+
+    void publish()
+    {
+        uint8_t previous = middle.exchange(back_index | fresh, std::memory_order_acq_rel);
+        back_index = previous & index_mask;
+    }
+
+    // Reader side, true when front() changed since the last call
+    bool acquire()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & fresh))
+            return false;
+        uint8_t previous = middle.exchange(front_index, std::memory_order_acq_rel);
+        front_index = previous & index_mask;
+        return true;
+    }
+
+    const T &front() const { return buffers[front_index]; }
+
+private:
+
+    static const uint8_t fresh = 4;
+    static const uint8_t index_mask = 3;
+
+    T buffers[3] = {};
+    uint8_t back_index = 0;                 // Writer only
+    alignas(64) std::atomic<uint8_t> middle{1};
+    alignas(64) uint8_t front_index = 2;    // Reader only
+};
+
+// What the renderer needs of a machine, copied out once per published frame
+struct Chip8Frame
+{
+    uint64_t graphics[32];
+    uint64_t graphics_extended[64][2];
+    uint64_t frame_count;
+    bool extended;
+};
+
+inline void chip8_capture_frame(const Chip8 &cpu, Chip8Frame &frame)
+{
+    memcpy(frame.graphics, cpu.graphics, sizeof(frame.graphics));
+    memcpy(frame.graphics_extended, cpu.graphics_extended, sizeof(frame.graphics_extended));
+    frame.frame_count = cpu.frame_count;
+    frame.extended = cpu.extendedScreenMode;
+}
@@ -0,0 +1,342 @@
+#include <chrono>
+#include <memory>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include "cpu.cpp"
+#include "jit.cpp"
+#include "lockstep.cpp"
+#include "movie.cpp"
+#include "rompack.cpp"
+#include "audio.cpp"
+#include "video.cpp"
+
+// make headless AOT=rom.cpp builds in a ROM compiled by recompile, for --aot
+#ifdef CHIP8_AOT_FILE
+#include "aot.cpp"
+#include CHIP8_AOT_FILE
+#endif
+
+using namespace std;
+
+static void dump_profile(const Chip8Profile* profile, const char* heatmap_path)
+{
+    if (profile == nullptr)
+        return;
+    cout << endl;
+    profile->report(cout);
+    if (!profile->write_heatmap(heatmap_path))
+        cerr << "Could not write heatmap: " << heatmap_path << endl;
+}
+
+// Headless front end, drives the core with run_cycles() and no SDL at all.
+// Usage: headless [--jit | --aot | --lanes N | --replay | --pack] [--quirks profile] [--trace file] [--profile heatmap] [--wav file] [--dump file] <rom, movie or pack> [cycles]
+// With --wav or --dump the ROM runs a frame at a time, the beeper output goes to a WAV file
+// and the display to a video file (Y4M when it ends in .y4m, raw otherwise).
+// With --replay the cycles argument is where to seek to, the end of the movie by default.
+// With --pack every ROM in the pack runs on a fresh machine for the given cycles.
+// With --aot the compiled ROM built in runs the blocks it has, and the interpreter the rest.
+int main(int argc, char* argv[])
+{
+    const char* usage = "Usage: headless [--jit | --aot | --lanes N | --replay | --pack] [--quirks profile] [--trace file] [--profile heatmap] [--wav file] [--dump file] <rom, movie or pack> [cycles]";
+    bool use_jit = false;
+    bool use_aot = false;
+    bool replay = false;
+    bool pack_run = false;
+    const char* trace_path = nullptr;
+    const char* profile_path = nullptr;
+    const char* wav_path = nullptr;
+    const char* dump_path = nullptr;
+    size_t lanes = 0;
+    QuirkProfile quirks = QuirkProfile::Original;
+    while (argc > 1 && strncmp(argv[1], "--", 2) == 0)
+    {
+        if (strcmp(argv[1], "--jit") == 0)
+            use_jit = true;
+        else if (strcmp(argv[1], "--aot") == 0)
+            use_aot = true;
+        else if (strcmp(argv[1], "--replay") == 0)
+            replay = true;
+        else if (strcmp(argv[1], "--pack") == 0)
+            pack_run = true;
+        else if (strcmp(argv[1], "--quirks") == 0 && argc > 2)
+        {
+            if (!parse_quirk_profile(argv[2], quirks))
+            {
+                cerr << "Unknown quirk profile: " << argv[2] << " (original, vip, schip or xochip)" << endl;
+                return EXIT_FAILURE;
+            }
+            --argc;
+            ++argv;
+        }
+        else if (strcmp(argv[1], "--trace") == 0 && argc > 2)
+        {
+            trace_path = argv[2];
+            --argc;
+            ++argv;
+        }
+        else if (strcmp(argv[1], "--profile") == 0 && argc > 2)
+        {
+            profile_path = argv[2];
+            --argc;
+            ++argv;
+        }
+        else if (strcmp(argv[1], "--wav") == 0 && argc > 2)
+        {
+            wav_path = argv[2];
+            --argc;
+            ++argv;
+        }
+        else if (strcmp(argv[1], "--dump") == 0 && argc > 2)
+        {
+            dump_path = argv[2];
+            --argc;
+            ++argv;
+        }
+        else if (strcmp(argv[1], "--lanes") == 0 && argc > 2)
+        {
+            lanes = strtoul(argv[2], nullptr, 10);
+            --argc;
+            ++argv;
+        }
+        else
+        {
+            // Unknown, or missing its value
+            cerr << usage << endl;
+            return EXIT_FAILURE;
+        }
+        --argc;
+        ++argv;
+    }
+
+    // Flags go first, then the file and an optional cycle count
+    char* cycles_end = nullptr;
+    uint64_t budget = argc > 2 ? strtoull(argv[2], &cycles_end, 10) : 10000000;
+    if (argc < 2 || argc > 3 || (cycles_end && (cycles_end == argv[2] || *cycles_end != '\0')))
+    {
+        cerr << usage << endl;
+        return EXIT_FAILURE;
+    }
+
+    // A movie replays under the profile it was recorded with, whatever --quirks says
+    Chip8MoviePlayer player;
+    if (replay)
+    {
+        if (!player.open(argv[1]))
+        {
+            cerr << "Could not open movie: " << argv[1] << endl;
+            return EXIT_FAILURE;
+        }
+        quirks = player.quirks();
+    }
+
+    Chip8 cpu(quirks);
+    cpu.init();
+
+    // The ring is too big for the stack, and the writer has to stop before it goes away
+    unique_ptr<Chip8Trace> trace;
+    Chip8TraceWriter trace_writer;
+    if (trace_path)
+    {
+        trace.reset(new Chip8Trace);
+        if (!trace_writer.start(trace_path, *trace))
+        {
+            cerr << "Could not write trace: " << trace_path << endl;
+            return EXIT_FAILURE;
+        }
+        cpu.trace = trace.get();
+    }
+
+    unique_ptr<Chip8Profile> profile;
+    if (profile_path)
+    {
+        profile.reset(new Chip8Profile);
+        cpu.profile = profile.get();
+    }
+
+    if (replay)
+    {
+        uint64_t target = argc > 2 ? budget : player.end_cycle();
+
+        auto start = chrono::steady_clock::now();
+        player.seek(cpu, target);
+        auto end = chrono::steady_clock::now();
+
+        cout << "Keyframes: " << player.keyframe_count() << endl;
+        cout << "Movie end: " << player.end_cycle() << endl;
+        cout << "Stop reason: " << stop_reason_name(cpu.status) << endl;
+        cout << "Instructions: " << cpu.cycle_count << endl;
+        cout << "Seek ms: " << chrono::duration<double, milli>(end - start).count() << endl;
+        dump_profile(profile.get(), profile_path);
+        return cpu.status == StopReason::Fault ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    // One line per ROM, the profile adds up across all of them
+    if (pack_run)
+    {
+        auto start = chrono::steady_clock::now();
+        Chip8RomPack pack;
+        if (!pack.open(argv[1]))
+        {
+            cerr << "Could not open ROM pack: " << argv[1] << endl;
+            return EXIT_FAILURE;
+        }
+        auto opened = chrono::steady_clock::now();
+
+        uint64_t total = 0;
+        size_t faults = 0;
+        for (size_t i = 0; i < pack.size(); ++i)
+        {
+            Chip8 rom_cpu(quirks);
+            rom_cpu.init();
+            rom_cpu.trace = trace.get();
+            rom_cpu.profile = profile.get();
+            pack.load(i, rom_cpu);
+
+            // The JIT maps its code buffer when it's built, so only pay for that with --jit
+            unique_ptr<Chip8Jit> jit;
+            if (use_jit)
+                jit.reset(new Chip8Jit(rom_cpu));
+            StopReason reason = jit ? jit->run_cycles(budget) : rom_cpu.run_cycles(budget);
+            cout << pack.name(i) << ": " << stop_reason_name(reason) << ", " << rom_cpu.cycle_count << " instructions" << endl;
+            total += rom_cpu.cycle_count;
+            faults += reason == StopReason::Fault ? 1 : 0;
+        }
+        auto end = chrono::steady_clock::now();
+
+        double seconds = chrono::duration<double>(end - opened).count();
+        cout << "ROMs: " << pack.size() << ", faulted: " << faults << endl;
+        cout << "Pack open ms: " << chrono::duration<double, milli>(opened - start).count() << endl;
+        cout << "Instructions: " << total << endl;
+        if (seconds > 0)
+            cout << "MIPS: " << total / seconds / 1e6 << endl;
+        dump_profile(profile.get(), profile_path);
+        return faults ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    if (!loadROM(argv[1], cpu))
+    {
+        cerr << "Could not open ROM: " << argv[1] << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Many machines on the same ROM, reports lane 0 plus the aggregate rate
+    if (lanes > 0)
+    {
+        Chip8Lockstep lockstep(lanes);
+        lockstep.reset(cpu);
+
+        auto start = chrono::steady_clock::now();
+        lockstep.run_cycles(budget);
+        auto end = chrono::steady_clock::now();
+
+        uint64_t total = 0;
+        for (size_t l = 0; l < lanes; ++l)
+            total += lockstep.lane_cycle_count(l);
+
+        double seconds = chrono::duration<double>(end - start).count();
+        cout << "Lanes: " << lanes << endl;
+        cout << "Lane 0 stop reason: " << stop_reason_name(lockstep.lane_status(0)) << endl;
+        cout << "Instructions: " << total << endl;
+        if (seconds > 0)
+            cout << "MIPS: " << total / seconds / 1e6 << endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Same beeper as play, drained here a frame at a time instead of by an audio device,
+    // and the display handed to the video writer's thread at the end of every frame
+    if (wav_path || dump_path)
+    {
+        const int sample_rate = 44100;
+        Chip8Beeper beeper(sample_rate);
+        Chip8WavWriter wav;
+        if (wav_path && !wav.open(wav_path, sample_rate))
+        {
+            cerr << "Could not write WAV: " << wav_path << endl;
+            return EXIT_FAILURE;
+        }
+        Chip8VideoWriter video;
+        if (dump_path && !video.start(dump_path, Chip8VideoWriter::format_for(dump_path)))
+        {
+            cerr << "Could not write video: " << dump_path << endl;
+            return EXIT_FAILURE;
+        }
+
+        vector<int16_t> samples(sample_rate / 60);
+        uint64_t tone_frames = 0;
+        StopReason reason = StopReason::FrameBoundary;
+        auto start = chrono::steady_clock::now();
+        while (cpu.cycle_count < budget && reason != StopReason::Halted && reason != StopReason::Fault)
+        {
+            reason = cpu.run_frame();
+            if (dump_path)
+                video.frame(cpu);
+            if (wav_path)
+            {
+                beeper.frame(cpu.sound_timer > 0);
+                tone_frames += cpu.sound_timer > 0 ? 1 : 0;
+                beeper.fill(samples.data(), samples.size());
+                wav.write(samples.data(), samples.size());
+            }
+        }
+        auto end = chrono::steady_clock::now();
+        video.stop();
+
+        cout << "Stop reason: " << stop_reason_name(reason) << endl;
+        cout << "Frames: " << cpu.frame_count;
+        if (wav_path)
+            cout << ", with tone: " << tone_frames;
+        cout << endl;
+        if (dump_path)
+            cout << "Video: " << video.frames_captured() << " changed, " << video.frames_repeated()
+                 << " repeated, " << video.frames_dropped() << " dropped" << endl;
+        cout << "Emulation ms: " << chrono::duration<double, milli>(end - start).count() << endl;
+        return reason == StopReason::Fault ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    // Same as the pack loop, the code buffer is only mapped with --jit
+    unique_ptr<Chip8Jit> jit;
+    if (use_jit)
+    {
+        jit.reset(new Chip8Jit(cpu));
+        if (!jit->available())
+            cerr << "JIT not available on this host, interpreting" << endl;
+    }
+
+#ifdef CHIP8_AOT_FILE
+    Chip8Aot aot(cpu, chip8_aot_program);
+    if (use_aot)
+    {
+        if (!aot.compatible())
+            cerr << "Compiled for other quirks, interpreting" << endl;
+        cout << "Compiled blocks: " << aot.valid_blocks() << " of " << chip8_aot_program.block_count << " match the ROM" << endl;
+    }
+#else
+    if (use_aot)
+    {
+        cerr << "No compiled ROM built in, see recompile and make headless AOT=rom.cpp" << endl;
+        return EXIT_FAILURE;
+    }
+#endif
+
+    auto start = chrono::steady_clock::now();
+#ifdef CHIP8_AOT_FILE
+    StopReason reason = use_aot ? aot.run_cycles(budget) : jit ? jit->run_cycles(budget) : cpu.run_cycles(budget);
+#else
+    StopReason reason = jit ? jit->run_cycles(budget) : cpu.run_cycles(budget);
+#endif
+    auto end = chrono::steady_clock::now();
+
+    double seconds = chrono::duration<double>(end - start).count();
+    cout << "Stop reason: " << stop_reason_name(reason) << endl;
+    if (reason == StopReason::Fault)
+        cout << "Fault: " << cpu.fault_message << " (PC 0x" << hex << cpu.program_counter << dec << ")" << endl;
+    cout << "Instructions: " << cpu.cycle_count << endl;
+    if (jit)
+        cout << "JIT blocks: " << jit->block_count() << endl;
+    if (seconds > 0)
+        cout << "MIPS: " << cpu.cycle_count / seconds / 1e6 << endl;
+    dump_profile(profile.get(), profile_path);
+
+    return reason == StopReason::Fault ? EXIT_FAILURE : EXIT_SUCCESS;
+}
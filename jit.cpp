@@ -0,0 +1,608 @@
+#pragma once
+
+// x86-64 dynamic recompiler for hot CHIP-8 basic blocks.
+//
+// Chip8Jit sits next to the interpreter and runs the same machine. Every time the
+// interpreter lands on a program counter it bumps a heat counter for that slot, once a
+// slot gets hot the straight-line run of ALU ops starting there is translated to native
+// code. Blocks keep the V registers and I they touch in host registers and write them
+// back on exit. A block ends after a jump or skip (1NNN, 3XNN, 4XNN, 5XY0, 9XY0) or just
+// before anything it can't translate (DXYN, FX0A, memory writes, calls, timers, keys),
+// which the interpreter then runs.
+
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#include "cpu.cpp"
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#define CHIP8_JIT_X64 1
+#include <sys/mman.h>
+#endif
+
+class Chip8Jit {
+public:
+
+    // Interpreter visits to a slot before its block gets compiled
+    static const uint16_t hot_threshold = 8;
+    static const uint32_t max_block_length = 64;
+    static const size_t code_buffer_size = 1 << 20;
+
+    explicit Chip8Jit(Chip8 &cpu) : cpu(cpu)
+    {
+        for (auto &b : block_at)
+            b = no_block;
+        for (auto &h : heat)
+            h = 0;
+
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(&cpu);
+        registers_offset = reinterpret_cast<const uint8_t*>(&cpu.registers) - base;
+        index_offset = reinterpret_cast<const uint8_t*>(&cpu.index) - base;
+        pc_offset = reinterpret_cast<const uint8_t*>(&cpu.program_counter) - base;
+
+#ifdef CHIP8_JIT_X64
+        void* buffer = mmap(nullptr, code_buffer_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (buffer != MAP_FAILED)
+            code = static_cast<uint8_t*>(buffer);
+#endif
+    }
+
+    ~Chip8Jit()
+    {
+#ifdef CHIP8_JIT_X64
+        if (code != nullptr)
+            munmap(code, code_buffer_size);
+#endif
+    }
+
+    Chip8Jit(const Chip8Jit &) = delete;
+    Chip8Jit &operator=(const Chip8Jit &) = delete;
+
+    // False when there is no native backend, run_cycles() then only interprets
+    bool available() const { return code != nullptr; }
+
+    // Same contract as Chip8::run_cycles()
+    StopReason run_cycles(uint64_t n)
+    {
+        if (cpu.status == StopReason::Halted || cpu.status == StopReason::Fault)
+            return cpu.status;
+
+        // Compiled blocks don't report single instructions, traced or profiled runs are interpreted
+        if (cpu.trace != nullptr || cpu.profile != nullptr)
+            return cpu.run_cycles(n);
+
+        uint64_t executed = 0;
+        while (executed < n)
+        {
+            if (cpu.code_dirty_pages != 0)
+                drop_dirty_blocks();
+
+            uint16_t pc = cpu.program_counter;
+            if (code != nullptr && !(pc & 1) && pc <= 0xFFE)
+            {
+                uint32_t slot = pc >> 1;
+                int32_t id = block_at[slot];
+                if (id >= 0 && blocks[id].length <= n - executed)
+                {
+                    const JitBlock &block = blocks[id];
+                    block.entry(&cpu);
+                    cpu.current_opcode = block.last_opcode;
+                    cpu.advance_cycles(block.length);
+                    executed += block.length;
+                    at_block_entry = true;
+                    continue;
+                }
+                if (id == no_block && at_block_entry && ++heat[slot] >= hot_threshold)
+                {
+                    compile(pc);
+                    if (block_at[slot] >= 0)
+                        continue;
+                }
+            }
+
+            StopReason reason = cpu.step();
+            ++executed;
+            if (reason == StopReason::Idle)
+                executed += cpu.skip_idle(n - executed);
+            else if (reason != StopReason::None)
+                return reason;
+
+            // Only branch targets and instructions after untranslatable ones start blocks,
+            // otherwise every slot of a hot loop would become its own overlapping block
+            bool ends_block = false;
+            at_block_entry = cpu.program_counter != pc + 2 || !translatable(cpu.fetch(pc), ends_block) || ends_block;
+        }
+        return StopReason::CycleLimit;
+    }
+
+    // Drops every compiled block, e.g. after loading a new ROM without a fresh Chip8Jit
+    void flush()
+    {
+        blocks.clear();
+        code_used = 0;
+        for (auto &b : block_at)
+            b = no_block;
+        for (auto &h : heat)
+            h = 0;
+        watched_pages = 0;
+    }
+
+    size_t block_count() const { return blocks.size(); }
+
+private:
+
+    typedef void (*BlockEntry)(Chip8* cpu);
+
+    struct JitBlock
+    {
+        BlockEntry entry;
+        uint16_t start;
+        uint16_t end;       // One past the last byte the block was translated from
+        uint32_t length;    // Instructions retired per run
+        uint16_t last_opcode;
+    };
+
+    static const int32_t no_block = -1;
+    static const int32_t not_compilable = -2;
+
+    // Host registers, rdi holds the Chip8* for the whole block and rax is scratch
+    enum HostReg { RAX = 0, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+    Chip8 &cpu;
+    uint8_t* code = nullptr;
+    size_t code_used = 0;
+
+    std::vector<JitBlock> blocks;
+    int32_t block_at[4096 / 2];
+    uint16_t heat[4096 / 2];
+
+    // 64-byte pages holding a live block or a slot marked not_compilable, writes anywhere
+    // else are data and don't need the block scan
+    uint64_t watched_pages = 0;
+    bool at_block_entry = true;
+
+    ptrdiff_t registers_offset;
+    ptrdiff_t index_offset;
+    ptrdiff_t pc_offset;
+
+    // Emission state for the block being compiled
+    std::vector<uint8_t> out;
+    int8_t host_for_v[16];
+    int8_t host_for_index;
+
+    void drop_dirty_blocks()
+    {
+        uint64_t dirty = cpu.code_dirty_pages & watched_pages;
+        cpu.code_dirty_pages = 0;
+        if (dirty == 0)
+            return;
+
+        watched_pages = 0;
+        for (size_t id = 0; id < blocks.size(); ++id)
+        {
+            const JitBlock &block = blocks[id];
+            if (block_at[block.start >> 1] != static_cast<int32_t>(id))
+                continue;
+            uint64_t pages = block_pages(block.start, block.end);
+            if (dirty & pages)
+            {
+                block_at[block.start >> 1] = no_block;
+                heat[block.start >> 1] = 0;
+            }
+            else
+                watched_pages |= pages;
+        }
+        // Slots given up on may hold different code now
+        for (uint32_t slot = 0; slot < 4096 / 2; ++slot)
+        {
+            if (block_at[slot] != not_compilable)
+                continue;
+            if (dirty & (1ull << (slot >> 5)))
+            {
+                block_at[slot] = no_block;
+                heat[slot] = 0;
+            }
+            else
+                watched_pages |= 1ull << (slot >> 5);
+        }
+    }
+
+    // Pages covered by [start, end)
+    static uint64_t block_pages(uint16_t start, uint16_t end)
+    {
+        uint64_t pages = 0;
+        for (uint32_t page = start >> 6; page <= static_cast<uint32_t>(end - 1) >> 6; ++page)
+            pages |= 1ull << page;
+        return pages;
+    }
+
+    // Which instructions a block can contain, and whether they end it
+    static bool translatable(const Chip8::DecodedOp &op, bool &ends_block)
+    {
+        ends_block = false;
+        switch (op.opcode >> 12)
+        {
+            case 0x1:
+            case 0x3:
+            case 0x4:
+                ends_block = true;
+                return true;
+            case 0x5:
+            case 0x9:
+                ends_block = true;
+                return op.n == 0;
+            case 0x6:
+            case 0x7:
+            case 0xA:
+                return true;
+            case 0x8:
+                return op.n <= 0x7 || op.n == 0xE;
+            case 0xF:
+                return op.nn == 0x1E;
+            default:
+                return false;
+        }
+    }
+
+    // Registers an instruction reads or writes, flag-setting ALU ops also touch VF
+    static void collect_uses(const Chip8::DecodedOp &op, bool uses_v[16], bool &uses_index)
+    {
+        switch (op.opcode >> 12)
+        {
+            case 0x3: case 0x4: case 0x6: case 0x7:
+                uses_v[op.x] = true;
+                break;
+            case 0x5: case 0x9:
+                uses_v[op.x] = uses_v[op.y] = true;
+                break;
+            case 0x8:
+                uses_v[op.x] = uses_v[op.y] = true;
+                if (op.n >= 0x4)
+                    uses_v[0xF] = true;
+                break;
+            case 0xA:
+                uses_index = true;
+                break;
+            case 0xF:
+                uses_v[op.x] = true;
+                uses_index = true;
+                break;
+        }
+    }
+
+    void compile(uint16_t start)
+    {
+        uint32_t slot = start >> 1;
+        block_at[slot] = not_compilable;
+        watched_pages |= 1ull << (start >> 6);
+
+        static const HostReg allocatable[] = { RCX, RDX, RBX, RBP, RSI, R8, R9, R10, R11, R12, R13, R14, R15 };
+        const int host_count = sizeof(allocatable) / sizeof(allocatable[0]);
+
+        // Scan forward for the block, stopping before anything that would need more host registers
+        std::vector<Chip8::DecodedOp> ops;
+        bool uses_v[16] = {};
+        bool uses_index = false;
+        uint16_t pc = start;
+        while (pc <= 0xFFE && ops.size() < max_block_length)
+        {
+            Chip8::DecodedOp op = Chip8::decode(cpu.read_opcode(pc), false, cpu.quirks);
+            bool ends_block = false;
+            if (!translatable(op, ends_block))
+                break;
+            // A jump to itself is left to the interpreter, which skips over it as an idle loop
+            if (ops.empty() && (op.opcode >> 12) == 0x1 && op.nnn == pc)
+                break;
+
+            bool next_v[16];
+            memcpy(next_v, uses_v, sizeof(next_v));
+            bool next_index = uses_index;
+            collect_uses(op, next_v, next_index);
+            int needed = next_index ? 1 : 0;
+            for (bool used : next_v)
+                needed += used ? 1 : 0;
+            if (needed > host_count)
+                break;
+
+            memcpy(uses_v, next_v, sizeof(uses_v));
+            uses_index = next_index;
+            ops.push_back(op);
+            pc += 2;
+            if (ends_block)
+                break;
+        }
+
+        if (ops.empty() || code == nullptr)
+            return;
+
+        int next_host = 0;
+        for (int v = 0; v < 16; ++v)
+            host_for_v[v] = uses_v[v] ? allocatable[next_host++] : -1;
+        host_for_index = uses_index ? allocatable[next_host++] : -1;
+
+        out.clear();
+        emit_prologue();
+        uint16_t op_pc = start;
+        bool wrote_pc = false;
+        for (const auto &op : ops)
+        {
+            wrote_pc = emit_op(op, op_pc);
+            op_pc += 2;
+        }
+        if (!wrote_pc)
+            store_word_imm(pc_offset, op_pc);
+        emit_epilogue();
+
+        if (code_used + out.size() > code_buffer_size)
+            flush();
+
+#ifdef CHIP8_JIT_X64
+        // Keep the buffer W^X, writable only while a block is copied in
+        mprotect(code, code_buffer_size, PROT_READ | PROT_WRITE);
+        memcpy(code + code_used, out.data(), out.size());
+        mprotect(code, code_buffer_size, PROT_READ | PROT_EXEC);
+#endif
+
+        JitBlock block;
+        block.entry = reinterpret_cast<BlockEntry>(code + code_used);
+        block.start = start;
+        block.end = op_pc;
+        block.length = static_cast<uint32_t>(ops.size());
+        block.last_opcode = ops.back().opcode;
+        code_used += (out.size() + 15) & ~static_cast<size_t>(15);
+
+        block_at[slot] = static_cast<int32_t>(blocks.size());
+        blocks.push_back(block);
+        watched_pages |= block_pages(block.start, block.end);
+    }
+
+    // Returns true when the instruction set the program counter itself
+    bool emit_op(const Chip8::DecodedOp &op, uint16_t pc)
+    {
+        int vx = host_for_v[op.x];
+        int vy = host_for_v[op.y];
+        int vf = host_for_v[0xF];
+
+        switch (op.opcode >> 12)
+        {
+            case 0x1:
+                store_word_imm(pc_offset, op.nnn);
+                return true;
+
+            case 0x3:
+                alu_imm(7, vx, op.nn);      // cmp Vx, kk
+                emit_skip(0x75, pc);         // skip when equal
+                return true;
+
+            case 0x4:
+                alu_imm(7, vx, op.nn);
+                emit_skip(0x74, pc);         // skip when not equal
+                return true;
+
+            case 0x5:
+                alu(0x39, vx, vy);          // cmp Vx, Vy
+                emit_skip(0x75, pc);
+                return true;
+
+            case 0x9:
+                alu(0x39, vx, vy);
+                emit_skip(0x74, pc);
+                return true;
+
+            case 0x6:
+                mov_imm(vx, op.nn);
+                return false;
+
+            case 0x7:
+                alu_imm(0, vx, op.nn);      // add Vx, kk
+                alu_imm(4, vx, 0xFF);       // and Vx, 0xFF
+                return false;
+
+            case 0xA:
+                mov_imm(host_for_index, op.nnn);
+                return false;
+
+            case 0xF:
+                // FX1E: I = (I + Vx) & 0xFFF
+                alu(0x01, host_for_index, vx);
+                alu_imm(4, host_for_index, 0xFFF);
+                return false;
+
+            case 0x8:
+            {
+                // 8XY6/8XYE shift Vy into Vx under the VIP style quirk profiles
+                int shift_source = quirk_flags(cpu.quirks).shift_uses_vy ? vy : vx;
+                switch (op.n)
+                {
+                    case 0x0: alu(0x89, vx, vy); break;  // mov
+                    case 0x1: alu(0x09, vx, vy); break;  // or
+                    case 0x2: alu(0x21, vx, vy); break;  // and
+                    case 0x3: alu(0x31, vx, vy); break;  // xor
+
+                    case 0x4:
+                        // Operands are zero-extended so the carry lands in bit 8
+                        alu(0x01, vx, vy);
+                        alu(0x89, RAX, vx);
+                        shift_imm(5, RAX, 8);
+                        alu_imm(4, vx, 0xFF);
+                        alu(0x89, vf, RAX);
+                        break;
+
+                    case 0x5:
+                    case 0x7:
+                    {
+                        // A borrow leaves bit 31 set, VF is its inverse
+                        int minuend = op.n == 0x5 ? vx : vy;
+                        int subtrahend = op.n == 0x5 ? vy : vx;
+                        alu(0x89, RAX, minuend);
+                        alu(0x29, RAX, subtrahend);
+                        alu(0x89, vx, RAX);
+                        alu_imm(4, vx, 0xFF);
+                        shift_imm(5, RAX, 31);
+                        alu_imm(6, RAX, 1);          // xor eax, 1
+                        alu(0x89, vf, RAX);
+                        break;
+                    }
+
+                    case 0x6:
+                        alu(0x89, RAX, shift_source);
+                        alu(0x89, vx, RAX);
+                        alu_imm(4, RAX, 1);
+                        shift_imm(5, vx, 1);
+                        alu(0x89, vf, RAX);
+                        break;
+
+                    case 0xE:
+                        alu(0x89, RAX, shift_source);
+                        alu(0x89, vx, RAX);
+                        shift_imm(5, RAX, 7);
+                        shift_imm(4, vx, 1);
+                        alu_imm(4, vx, 0xFF);
+                        alu(0x89, vf, RAX);
+                        break;
+                }
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // Stores pc + 2 or pc + 4 depending on the flags of the preceding cmp, jcc is the no-skip condition
+    void emit_skip(uint8_t jcc, uint16_t pc)
+    {
+        mov_imm(RAX, pc + 2);
+        emit(jcc);
+        emit(5);                        // over the next mov
+        mov_imm(RAX, pc + 4);
+        store_word(pc_offset, RAX);
+    }
+
+    void emit_prologue()
+    {
+        static const HostReg saved[] = { RBX, RBP, R12, R13, R14, R15 };
+        for (HostReg r : saved)
+        {
+            if (r >= R8)
+                emit(0x41);
+            emit(0x50 + (r & 7));
+        }
+        for (int v = 0; v < 16; ++v)
+            if (host_for_v[v] >= 0)
+                load_byte(host_for_v[v], registers_offset + v);
+        if (host_for_index >= 0)
+            load_word(host_for_index, index_offset);
+    }
+
+    void emit_epilogue()
+    {
+        for (int v = 0; v < 16; ++v)
+            if (host_for_v[v] >= 0)
+                store_byte(registers_offset + v, host_for_v[v]);
+        if (host_for_index >= 0)
+            store_word(index_offset, host_for_index);
+
+        static const HostReg saved[] = { R15, R14, R13, R12, RBP, RBX };
+        for (HostReg r : saved)
+        {
+            if (r >= R8)
+                emit(0x41);
+            emit(0x58 + (r & 7));
+        }
+        emit(0xC3);
+    }
+
+    // Instruction encoders, all register operations are 32-bit
+
+    void emit(uint8_t byte) { out.push_back(byte); }
+
+    void emit32(uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            emit(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    void rex(int reg, int rm, bool force = false)
+    {
+        uint8_t prefix = 0x40 | ((reg >> 3) << 2) | (rm >> 3);
+        if (prefix != 0x40 || force)
+            emit(prefix);
+    }
+
+    // [rdi + disp32] operand
+    void memory_operand(int reg, ptrdiff_t disp)
+    {
+        emit(0x80 | ((reg & 7) << 3) | RDI);
+        emit32(static_cast<uint32_t>(disp));
+    }
+
+    void load_byte(int reg, ptrdiff_t disp)
+    {
+        rex(reg, RDI);
+        emit(0x0F); emit(0xB6);         // movzx r32, byte
+        memory_operand(reg, disp);
+    }
+
+    void store_byte(ptrdiff_t disp, int reg)
+    {
+        rex(reg, RDI, true);            // REX so sil/dil/bpl encode as byte registers
+        emit(0x88);
+        memory_operand(reg, disp);
+    }
+
+    void load_word(int reg, ptrdiff_t disp)
+    {
+        rex(reg, RDI);
+        emit(0x0F); emit(0xB7);         // movzx r32, word
+        memory_operand(reg, disp);
+    }
+
+    void store_word(ptrdiff_t disp, int reg)
+    {
+        emit(0x66);
+        rex(reg, RDI);
+        emit(0x89);
+        memory_operand(reg, disp);
+    }
+
+    void store_word_imm(ptrdiff_t disp, uint16_t value)
+    {
+        emit(0x66);
+        emit(0xC7);
+        memory_operand(0, disp);
+        emit(static_cast<uint8_t>(value));
+        emit(static_cast<uint8_t>(value >> 8));
+    }
+
+    void mov_imm(int reg, uint32_t value)
+    {
+        rex(0, reg);
+        emit(0xB8 + (reg & 7));
+        emit32(value);
+    }
+
+    // opcode is the "r/m32, r32" form: 01 add, 09 or, 21 and, 29 sub, 31 xor, 39 cmp, 89 mov
+    void alu(uint8_t opcode, int dst, int src)
+    {
+        rex(src, dst);
+        emit(opcode);
+        emit(0xC0 | ((src & 7) << 3) | (dst & 7));
+    }
+
+    // Group 1 immediate: 0 add, 4 and, 5 sub, 6 xor, 7 cmp
+    void alu_imm(int ext, int reg, uint32_t value)
+    {
+        rex(0, reg);
+        emit(0x81);
+        emit(0xC0 | (ext << 3) | (reg & 7));
+        emit32(value);
+    }
+
+    // Group 2 shift: 4 shl, 5 shr
+    void shift_imm(int ext, int reg, uint8_t count)
+    {
+        rex(0, reg);
+        emit(0xC1);
+        emit(0xC0 | (ext << 3) | (reg & 7));
+        emit(count);
+    }
+};
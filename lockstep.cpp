@@ -0,0 +1,972 @@
+#pragma once
+
+// Lockstep engine that runs many Chip8 machines at once on the same program.
+//
+// Machine state is kept as structure-of-arrays, one array per register with a byte per
+// lane, so an ALU opcode is applied to every lane with a handful of SSE2/AVX2 vector
+// operations and a lane mask. Lanes sharing a program counter form a group that decodes
+// and executes each instruction once. Groups split when lanes take different branches and
+// merge again when they land on the same program counter, always running the group with
+// the lowest program counter next so loops reconverge. Opcodes that touch per-lane memory,
+// the stack or the display run lane by lane with the same semantics as Chip8::step().
+
+#include <vector>
+#include <string.h>
+#include "cpu.cpp"
+
+#if defined(__AVX2__)
+#define CHIP8_LANE_VECTOR_BYTES 32
+#else
+#define CHIP8_LANE_VECTOR_BYTES 16
+#endif
+
+class Chip8Lockstep {
+public:
+
+    typedef uint8_t LaneVector __attribute__((vector_size(CHIP8_LANE_VECTOR_BYTES)));
+    static const size_t lane_vector_bytes = CHIP8_LANE_VECTOR_BYTES;
+
+    explicit Chip8Lockstep(size_t lanes)
+        : lane_count(lanes),
+          padded((lanes + lane_vector_bytes - 1) / lane_vector_bytes * lane_vector_bytes)
+    {
+        registers.assign(16 * padded, 0);
+        index.assign(padded, 0);
+        lane_pc.assign(padded, 0);
+        current_opcode.assign(padded, 0);
+        sp.assign(padded, 0);
+        stack.assign(32 * padded, 0);
+        delay_timer.assign(padded, 0);
+        sound_timer.assign(padded, 0);
+        rpl_user_flags.assign(8 * padded, 0);
+        keys.assign(padded, 0);
+        memory.assign(4096 * padded, 0);
+        written_pages.assign(padded, 0);
+        graphics.assign(32 * padded, 0);
+        graphics_extended.assign(128 * padded, 0);
+        extended_mode.assign(padded, 0);
+        cycle_count.assign(padded, 0);
+        cycles_into_frame.assign(padded, 0);
+        frame_count.assign(padded, 0);
+        budget_end.assign(padded, 0);
+        status.assign(padded, StopReason::None);
+        fault_message.assign(padded, nullptr);
+        rng_state.assign(padded, 0);
+    }
+
+    size_t lanes() const { return lane_count; }
+
+    // Puts every lane into the state of boot, normally a Chip8 right after init() and loadROM()
+    void reset(const Chip8 &boot)
+    {
+        cycles_per_frame = boot.cycles_per_frame;
+        quirks = quirk_flags(boot.quirks);
+        memcpy(shared_memory, boot.memory, sizeof(shared_memory));
+        for (auto &d : shared_decoded)
+            d.handler = nullptr;
+        pages_written_any = 0;
+
+        for (size_t l = 0; l < padded; ++l)
+        {
+            load_lane(l, boot);
+            // Lane 0 continues boot's random sequence, the others get their own
+            if (l > 0)
+            {
+                rng_state[l] = boot.rng_state ^ (0x9E3779B9u * static_cast<uint32_t>(l));
+                if (rng_state[l] == 0)
+                    rng_state[l] = 1;
+            }
+            if (l >= lane_count)
+                status[l] = StopReason::Halted;  // Padding lanes never run
+        }
+    }
+
+    // Copies a regular Chip8 into one lane, call reset() first to set the shared program image
+    void load_lane(size_t l, const Chip8 &cpu)
+    {
+        for (int r = 0; r < 16; ++r)
+            reg(r)[l] = cpu.registers[r];
+        index[l] = cpu.index;
+        lane_pc[l] = cpu.program_counter;
+        current_opcode[l] = cpu.current_opcode;
+        sp[l] = static_cast<uint8_t>(cpu.sp);
+        memcpy(&stack[l * 32], cpu.stack, sizeof(cpu.stack));
+        delay_timer[l] = cpu.delay_timer;
+        sound_timer[l] = cpu.sound_timer;
+        memcpy(&rpl_user_flags[l * 8], cpu.rpl_user_flags, 8);
+        uint16_t key_mask = 0;
+        for (int k = 0; k < 16; ++k)
+            if (cpu.keys[k])
+                key_mask |= 1 << k;
+        keys[l] = key_mask;
+
+        // Pages that differ from the shared image are fetched from the lane's own memory
+        memcpy(&memory[l * 4096], cpu.memory, 4096);
+        written_pages[l] = 0;
+        for (int page = 0; page < 64; ++page)
+            if (memcmp(&shared_memory[page * 64], &cpu.memory[page * 64], 64) != 0)
+                written_pages[l] |= 1ull << page;
+        pages_written_any |= written_pages[l];
+
+        memcpy(&graphics[l * 32], cpu.graphics, sizeof(cpu.graphics));
+        memcpy(&graphics_extended[l * 128], cpu.graphics_extended, sizeof(cpu.graphics_extended));
+        extended_mode[l] = cpu.extendedScreenMode;
+        cycle_count[l] = cpu.cycle_count;
+        cycles_into_frame[l] = cpu.cycles_into_frame;
+        frame_count[l] = cpu.frame_count;
+        status[l] = cpu.status;
+        fault_message[l] = cpu.fault_message;
+        rng_state[l] = cpu.rng_state;
+    }
+
+    // Copies one lane out into a regular Chip8, e.g. to render it or keep running it alone
+    void export_lane(size_t l, Chip8 &cpu) const
+    {
+        cpu.cycles_per_frame = cycles_per_frame;
+        for (int r = 0; r < 16; ++r)
+            cpu.registers[r] = reg(r)[l];
+        cpu.index = index[l];
+        cpu.program_counter = lane_pc[l];
+        cpu.sp = sp[l];
+        memcpy(cpu.stack, &stack[l * 32], sizeof(cpu.stack));
+        cpu.delay_timer = delay_timer[l];
+        cpu.sound_timer = sound_timer[l];
+        memcpy(cpu.rpl_user_flags, &rpl_user_flags[l * 8], 8);
+        for (int k = 0; k < 16; ++k)
+            cpu.keys[k] = (keys[l] >> k) & 1;
+        memcpy(cpu.memory, &memory[l * 4096], 4096);
+        cpu.invalidate_decoded();
+        cpu.current_opcode = current_opcode[l];
+        memcpy(cpu.graphics, &graphics[l * 32], sizeof(cpu.graphics));
+        memcpy(cpu.graphics_extended, &graphics_extended[l * 128], sizeof(cpu.graphics_extended));
+        cpu.extendedScreenMode = extended_mode[l] != 0;
+        cpu.mark_display_changed();
+        cpu.cycle_count = cycle_count[l];
+        cpu.cycles_into_frame = cycles_into_frame[l];
+        cpu.frame_count = frame_count[l];
+        cpu.status = status[l] == StopReason::Halted || status[l] == StopReason::Fault ? status[l] : StopReason::None;
+        cpu.fault_message = fault_message[l];
+        cpu.rng_state = rng_state[l];
+    }
+
+    // Key state of one lane, bit k set while key k is held
+    void set_keys(size_t l, uint16_t mask) { keys[l] = mask; }
+
+    // Why a lane stopped during the last run_cycles()
+    StopReason lane_status(size_t l) const { return status[l]; }
+    const char* lane_fault_message(size_t l) const { return fault_message[l]; }
+    uint64_t lane_cycle_count(size_t l) const { return cycle_count[l]; }
+
+    // Every lane runs up to n instructions, lanes stop early exactly where Chip8::run_cycles()
+    // would. Returns how many lanes can keep running.
+    size_t run_cycles(uint64_t n)
+    {
+        groups.clear();
+        for (size_t l = 0; l < lane_count; ++l)
+        {
+            if (status[l] == StopReason::Halted || status[l] == StopReason::Fault)
+                continue;
+            status[l] = StopReason::None;
+            budget_end[l] = cycle_count[l] + n;
+            if (n == 0)
+            {
+                status[l] = StopReason::CycleLimit;
+                continue;
+            }
+
+            Group* g = find_group(lane_pc[l]);
+            if (g == nullptr)
+            {
+                groups.push_back(new_group(lane_pc[l]));
+                g = &groups.back();
+                g->min_remaining = n;
+            }
+            g->mask[l] = 0xFF;
+            ++g->count;
+        }
+
+        while (!groups.empty())
+        {
+            size_t next = 0;
+            for (size_t i = 1; i < groups.size(); ++i)
+                if (groups[i].pc < groups[next].pc)
+                    next = i;
+            Group g = std::move(groups[next]);
+            if (next + 1 != groups.size())
+                groups[next] = std::move(groups.back());
+            groups.pop_back();
+
+            if (g.pending >= g.min_remaining)
+            {
+                flush(g);
+                retire_finished(g);
+                if (g.count > 0)
+                    add_group(std::move(g));
+                else
+                    release(g);
+                continue;
+            }
+
+            step(g);
+        }
+
+        size_t runnable = 0;
+        for (size_t l = 0; l < lane_count; ++l)
+            if (status[l] == StopReason::CycleLimit || status[l] == StopReason::WaitingForKey)
+                ++runnable;
+        return runnable;
+    }
+
+private:
+
+    // Lanes currently at the same program counter
+    struct Group
+    {
+        uint16_t pc = 0;
+        std::vector<uint8_t> mask;  // 0xFF for member lanes
+        size_t count = 0;
+        uint64_t pending = 0;       // Instructions every member retired since the last flush
+        uint16_t opcode = 0;        // The last of them, current_opcode once they're flushed
+        uint64_t min_remaining = 0; // Budget left for the member closest to its limit at the last flush
+    };
+
+    size_t lane_count;
+    size_t padded;
+    uint32_t cycles_per_frame = 10;
+
+    std::vector<uint8_t> registers;  // registers[r * padded + lane]
+    std::vector<uint16_t> index;
+    std::vector<uint16_t> lane_pc;   // Valid for lanes that are not inside a group
+    std::vector<uint16_t> current_opcode;  // Same
+    std::vector<uint8_t> sp;
+    std::vector<uint16_t> stack;     // stack[lane * 32 + depth]
+    std::vector<uint8_t> delay_timer;
+    std::vector<uint8_t> sound_timer;
+    std::vector<uint8_t> rpl_user_flags;
+    std::vector<uint16_t> keys;
+    std::vector<uint8_t> memory;     // memory[lane * 4096 + address]
+    std::vector<uint64_t> written_pages;
+    std::vector<uint64_t> graphics;
+    std::vector<uint64_t> graphics_extended;
+    std::vector<uint8_t> extended_mode;
+    std::vector<uint64_t> cycle_count;
+    std::vector<uint32_t> cycles_into_frame;
+    std::vector<uint64_t> frame_count;
+    std::vector<uint64_t> budget_end;
+    std::vector<StopReason> status;
+    std::vector<const char*> fault_message;
+    std::vector<uint32_t> rng_state;
+    QuirkFlags quirks = quirk_flags(QuirkProfile::Original);  // Taken from the boot machine
+
+    // Program image every lane starts from, code is fetched and decoded from here for pages
+    // no lane has written to
+    uint8_t shared_memory[4096];
+    Chip8::DecodedOp shared_decoded[4096 / 2];
+    uint64_t pages_written_any = 0;
+
+    std::vector<Group> groups;
+    std::vector<std::vector<uint8_t>> mask_pool;
+
+    uint8_t* reg(int r) { return &registers[r * padded]; }
+    const uint8_t* reg(int r) const { return &registers[r * padded]; }
+
+    // Vector helpers, loads and stores go through memcpy so lane arrays need no extra alignment
+
+    static LaneVector load(const uint8_t* p)
+    {
+        LaneVector v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static void store(uint8_t* p, LaneVector v) { memcpy(p, &v, sizeof(v)); }
+
+    static LaneVector splat(uint8_t value) { return LaneVector{} + value; }
+
+    static LaneVector blend(LaneVector mask, LaneVector set, LaneVector keep)
+    {
+        return (mask & set) | (~mask & keep);
+    }
+
+    size_t count_members(const std::vector<uint8_t> &mask) const
+    {
+        size_t count = 0;
+        for (size_t l = 0; l < padded; ++l)
+            count += mask[l] & 1;
+        return count;
+    }
+
+    Group new_group(uint16_t pc)
+    {
+        Group g;
+        g.pc = pc;
+        if (!mask_pool.empty())
+        {
+            g.mask = std::move(mask_pool.back());
+            mask_pool.pop_back();
+            memset(g.mask.data(), 0, padded);
+        }
+        else
+        {
+            g.mask.assign(padded, 0);
+        }
+        return g;
+    }
+
+    void release(Group &g)
+    {
+        if (!g.mask.empty())
+            mask_pool.push_back(std::move(g.mask));
+    }
+
+    Group* find_group(uint16_t pc)
+    {
+        for (auto &g : groups)
+            if (g.pc == pc)
+                return &g;
+        return nullptr;
+    }
+
+    // Adds a group to the run list, merging it into one already at the same program counter
+    void add_group(Group &&g)
+    {
+        Group* existing = find_group(g.pc);
+        if (existing == nullptr)
+        {
+            groups.push_back(std::move(g));
+            return;
+        }
+
+        flush(*existing);
+        flush(g);
+        for (size_t b = 0; b < padded; b += lane_vector_bytes)
+            store(&existing->mask[b], load(&existing->mask[b]) | load(&g.mask[b]));
+        existing->count += g.count;
+        if (g.min_remaining < existing->min_remaining)
+            existing->min_remaining = g.min_remaining;
+        release(g);
+    }
+
+    // Same clock update as Chip8::advance_cycles() for one lane
+    void advance_lane(size_t l, uint64_t n)
+    {
+        cycle_count[l] += n;
+        uint64_t total = cycles_into_frame[l] + n;
+        if (total < cycles_per_frame)
+        {
+            cycles_into_frame[l] = static_cast<uint32_t>(total);
+            return;
+        }
+        uint64_t frames = total / cycles_per_frame;
+        delay_timer[l] = delay_timer[l] > frames ? static_cast<uint8_t>(delay_timer[l] - frames) : 0;
+        sound_timer[l] = sound_timer[l] > frames ? static_cast<uint8_t>(sound_timer[l] - frames) : 0;
+        frame_count[l] += frames;
+        cycles_into_frame[l] = static_cast<uint32_t>(total % cycles_per_frame);
+    }
+
+    // Applies the group's pending instructions to every member's clock and timers
+    void flush(Group &g)
+    {
+        uint64_t min_remaining = ~0ull;
+        for (size_t l = 0; l < padded; ++l)
+        {
+            if (!g.mask[l])
+                continue;
+            if (g.pending)
+            {
+                advance_lane(l, g.pending);
+                current_opcode[l] = g.opcode;
+            }
+            uint64_t remaining = budget_end[l] - cycle_count[l];
+            if (remaining < min_remaining)
+                min_remaining = remaining;
+        }
+        g.pending = 0;
+        g.min_remaining = min_remaining;
+    }
+
+    // Drops members that used up their budget, call right after flush()
+    void retire_finished(Group &g)
+    {
+        uint64_t min_remaining = ~0ull;
+        for (size_t l = 0; l < padded; ++l)
+        {
+            if (!g.mask[l])
+                continue;
+            if (cycle_count[l] >= budget_end[l])
+            {
+                retire_lane(g, l, StopReason::CycleLimit, nullptr, g.pc, 0);
+                continue;
+            }
+            uint64_t remaining = budget_end[l] - cycle_count[l];
+            if (remaining < min_remaining)
+                min_remaining = remaining;
+        }
+        g.min_remaining = min_remaining;
+    }
+
+    // Takes one lane out of its group, extra is the instructions it retired beyond g.pending
+    void retire_lane(Group &g, size_t l, StopReason reason, const char* message, uint16_t pc, uint64_t extra)
+    {
+        advance_lane(l, g.pending + extra);
+        if (g.pending + extra > 0)
+            current_opcode[l] = g.opcode;
+        g.mask[l] = 0;
+        --g.count;
+        lane_pc[l] = pc;
+        status[l] = reason;
+        if (reason == StopReason::Fault)
+            fault_message[l] = message;
+    }
+
+    const Chip8::DecodedOp &shared_op(uint16_t pc)
+    {
+        Chip8::DecodedOp &op = shared_decoded[pc >> 1];
+        if (op.handler == nullptr)
+            op = Chip8::decode(static_cast<uint16_t>(shared_memory[pc]) << 8 | shared_memory[pc + 1]);
+        return op;
+    }
+
+    uint16_t lane_opcode(size_t l, uint16_t pc) const
+    {
+        const uint8_t* m = &memory[l * 4096];
+        return static_cast<uint16_t>(m[pc]) << 8 | m[pc + 1];
+    }
+
+    void write_lane_memory(size_t l, uint16_t address, uint8_t value)
+    {
+        address &= 0xFFF;
+        memory[l * 4096 + address] = value;
+        written_pages[l] |= 1ull << (address >> 6);
+        pages_written_any |= 1ull << (address >> 6);
+    }
+
+    // Runs the instruction at g.pc for every member
+    void step(Group &g)
+    {
+        uint16_t pc = g.pc;
+        if (pc > 0xFFE)
+        {
+            // Same as Chip8::cycle(), the instruction is never counted
+            for (size_t l = 0; l < padded; ++l)
+                if (g.mask[l])
+                    retire_lane(g, l, StopReason::Fault, "OPcode out of range! Your program has an error!", pc, 0);
+            release(g);
+            return;
+        }
+
+        uint64_t code_pages = (1ull << (pc >> 6)) | (1ull << ((pc + 1) >> 6));
+        if (!(pc & 1) && !(pages_written_any & code_pages))
+        {
+            Chip8::DecodedOp op = shared_op(pc);
+            execute(g, op);
+            return;
+        }
+
+        // Some lane rewrote this code, split the group by what each member actually sees
+        while (g.count > 0)
+        {
+            size_t leader = 0;
+            while (!g.mask[leader])
+                ++leader;
+            uint16_t opcode = lane_opcode(leader, pc);
+
+            Group same = new_group(pc);
+            same.pending = g.pending;
+            same.opcode = g.opcode;
+            same.min_remaining = g.min_remaining;
+            for (size_t l = leader; l < padded; ++l)
+            {
+                if (g.mask[l] && lane_opcode(l, pc) == opcode)
+                {
+                    same.mask[l] = 0xFF;
+                    ++same.count;
+                    g.mask[l] = 0;
+                    --g.count;
+                }
+            }
+            execute(same, Chip8::decode(opcode));
+        }
+        release(g);
+    }
+
+    // Executes op for every member of g and hands the group, or what it split into, back
+    // to the run list
+    void execute(Group &g, const Chip8::DecodedOp &op)
+    {
+        switch (op.opcode >> 12)
+        {
+            case 0x1:
+                g.pc = op.nnn;
+                return continue_group(g, op.opcode);
+
+            case 0x3:
+            case 0x4:
+            case 0x5:
+            case 0x9:
+                return execute_skip(g, op);
+
+            case 0x6:
+                vector_op(g, op.x, [&](LaneVector, LaneVector) { return splat(op.nn); });
+                return advance(g, op.opcode);
+
+            case 0x7:
+                vector_op(g, op.x, [&](LaneVector vx, LaneVector) { return vx + splat(op.nn); });
+                return advance(g, op.opcode);
+
+            case 0x8:
+                if (execute_alu(g, op))
+                    return advance(g, op.opcode);
+                break;
+        }
+
+        execute_per_lane(g, op);
+    }
+
+    // Applies fn(Vx, Vy) to Vx of every member lane
+    template <typename Fn>
+    void vector_op(Group &g, uint8_t x, Fn fn, uint8_t y = 0)
+    {
+        uint8_t* vx = reg(x);
+        const uint8_t* vy = reg(y);
+        for (size_t b = 0; b < padded; b += lane_vector_bytes)
+        {
+            LaneVector m = load(&g.mask[b]);
+            LaneVector old = load(&vx[b]);
+            store(&vx[b], blend(m, fn(old, load(&vy[b])), old));
+        }
+    }
+
+    // 8XYN with VF written after Vx, like the interpreter, so X = F ends up holding the flag
+    template <typename Fn>
+    void vector_flag_op(Group &g, uint8_t x, uint8_t y, Fn fn)
+    {
+        uint8_t* vx = reg(x);
+        const uint8_t* vy = reg(y);
+        uint8_t* vf = reg(0xF);
+        for (size_t b = 0; b < padded; b += lane_vector_bytes)
+        {
+            LaneVector m = load(&g.mask[b]);
+            LaneVector a = load(&vx[b]);
+            LaneVector flag;
+            LaneVector result = fn(a, load(&vy[b]), flag);
+            store(&vx[b], blend(m, result, a));
+            store(&vf[b], blend(m, flag, load(&vf[b])));
+        }
+    }
+
+    bool execute_alu(Group &g, const Chip8::DecodedOp &op)
+    {
+        const LaneVector one = splat(1);
+        switch (op.n)
+        {
+            case 0x0: vector_op(g, op.x, [](LaneVector, LaneVector vy) { return vy; }, op.y); return true;
+            case 0x1: vector_op(g, op.x, [](LaneVector vx, LaneVector vy) { return vx | vy; }, op.y); return true;
+            case 0x2: vector_op(g, op.x, [](LaneVector vx, LaneVector vy) { return vx & vy; }, op.y); return true;
+            case 0x3: vector_op(g, op.x, [](LaneVector vx, LaneVector vy) { return vx ^ vy; }, op.y); return true;
+
+            case 0x4:
+                vector_flag_op(g, op.x, op.y, [&](LaneVector vx, LaneVector vy, LaneVector &flag) {
+                    LaneVector sum = vx + vy;
+                    flag = reinterpret_cast<LaneVector>(sum < vx) & one;
+                    return sum;
+                });
+                return true;
+
+            case 0x5:
+                vector_flag_op(g, op.x, op.y, [&](LaneVector vx, LaneVector vy, LaneVector &flag) {
+                    flag = reinterpret_cast<LaneVector>(vx >= vy) & one;
+                    return static_cast<LaneVector>(vx - vy);
+                });
+                return true;
+
+            case 0x6:
+                vector_flag_op(g, op.x, op.y, [&](LaneVector vx, LaneVector vy, LaneVector &flag) {
+                    LaneVector source = quirks.shift_uses_vy ? vy : vx;
+                    flag = source & one;
+                    return static_cast<LaneVector>(source >> 1);
+                });
+                return true;
+
+            case 0x7:
+                vector_flag_op(g, op.x, op.y, [&](LaneVector vx, LaneVector vy, LaneVector &flag) {
+                    flag = reinterpret_cast<LaneVector>(vy >= vx) & one;
+                    return static_cast<LaneVector>(vy - vx);
+                });
+                return true;
+
+            case 0xE:
+                vector_flag_op(g, op.x, op.y, [&](LaneVector vx, LaneVector vy, LaneVector &flag) {
+                    LaneVector source = quirks.shift_uses_vy ? vy : vx;
+                    flag = source >> 7;
+                    return static_cast<LaneVector>(source << 1);
+                });
+                return true;
+        }
+        return false;
+    }
+
+    // 3XNN, 4XNN, 5XY0 and 9XY0 compare across lanes and split the group on the outcome
+    void execute_skip(Group &g, const Chip8::DecodedOp &op)
+    {
+        uint8_t kind = op.opcode >> 12;
+        const uint8_t* vx = reg(op.x);
+        const uint8_t* vy = reg(op.y);
+        Group taken = new_group(g.pc + 4);
+
+        for (size_t b = 0; b < padded; b += lane_vector_bytes)
+        {
+            LaneVector a = load(&vx[b]);
+            LaneVector other = kind == 0x3 || kind == 0x4 ? splat(op.nn) : load(&vy[b]);
+            LaneVector equal = reinterpret_cast<LaneVector>(a == other);
+            LaneVector skip = kind == 0x3 || kind == 0x5 ? equal : ~equal;
+            LaneVector m = load(&g.mask[b]);
+            store(&taken.mask[b], m & skip);
+            store(&g.mask[b], m & ~skip);
+        }
+
+        taken.count = count_members(taken.mask);
+        g.count -= taken.count;
+        taken.pending = g.pending;
+        taken.min_remaining = g.min_remaining;
+
+        if (taken.count > 0)
+        {
+            ++taken.pending;
+            taken.opcode = op.opcode;
+            add_group(std::move(taken));
+        }
+        else
+        {
+            release(taken);
+        }
+        if (g.count > 0)
+            advance(g, op.opcode);
+        else
+            release(g);
+    }
+
+    // Retires the instruction for every member and moves the group to pc + 2
+    void advance(Group &g, uint16_t opcode)
+    {
+        g.pc += 2;
+        continue_group(g, opcode);
+    }
+
+    void continue_group(Group &g, uint16_t opcode)
+    {
+        ++g.pending;
+        g.opcode = opcode;
+        add_group(std::move(g));
+    }
+
+    // Everything without a vector form, run member by member. Lanes can end up at different
+    // program counters, so each is regrouped by where it goes next.
+    void execute_per_lane(Group &g, const Chip8::DecodedOp &op)
+    {
+        // Timer opcodes read or set per-lane time, bring every member's clock up to date first
+        if ((op.opcode >> 12) == 0xF)
+        {
+            flush(g);
+        }
+        g.opcode = op.opcode;
+
+        std::vector<Group> out;
+        for (size_t l = 0; l < padded; ++l)
+        {
+            if (!g.mask[l])
+                continue;
+
+            uint16_t next_pc = g.pc + 2;
+            StopReason reason = execute_lane(l, op, g.pc, next_pc);
+            if (reason == StopReason::Halted || reason == StopReason::Fault || reason == StopReason::WaitingForKey)
+            {
+                retire_lane(g, l, reason, fault_message[l], next_pc, 1);
+                continue;
+            }
+
+            Group* target = nullptr;
+            for (auto &o : out)
+                if (o.pc == next_pc)
+                    target = &o;
+            if (target == nullptr)
+            {
+                out.push_back(new_group(next_pc));
+                target = &out.back();
+                target->pending = g.pending + 1;
+                target->opcode = op.opcode;
+                target->min_remaining = g.min_remaining;
+            }
+            target->mask[l] = 0xFF;
+            ++target->count;
+        }
+
+        release(g);
+        for (auto &o : out)
+            add_group(std::move(o));
+    }
+
+    // Same xorshift32 as Chip8::next_random()
+    uint32_t next_random(size_t l)
+    {
+        uint32_t x = rng_state[l];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        rng_state[l] = x;
+        return x;
+    }
+
+    // One lane's worth of Chip8::step() for the opcodes handled lane by lane
+    StopReason execute_lane(size_t l, const Chip8::DecodedOp &op, uint16_t pc, uint16_t &next_pc)
+    {
+        uint8_t* m = &memory[l * 4096];
+        uint16_t &I = index[l];
+        auto V = [&](int r) -> uint8_t & { return registers[r * padded + l]; };
+
+        switch (op.opcode >> 12)
+        {
+            case 0x0:
+                switch (op.opcode)
+                {
+                    case 0x0000:
+                        next_pc = pc;
+                        return StopReason::None;
+                    case 0x00E0:
+                        if (extended_mode[l])
+                            memset(&graphics_extended[l * 128], 0, 128 * sizeof(uint64_t));
+                        else
+                            memset(&graphics[l * 32], 0, 32 * sizeof(uint64_t));
+                        return StopReason::None;
+                    case 0x00EE:
+                        if (sp[l] == 0)
+                        {
+                            fault_message[l] = "Stack underflow! Your program has an error!";
+                            next_pc = pc;
+                            return StopReason::Fault;
+                        }
+                        --sp[l];
+                        next_pc = stack[l * 32 + sp[l]] + 2;
+                        return StopReason::None;
+                    case 0x00FB:
+                    case 0x00FC:
+                        scroll_horizontal(l, op.opcode == 0x00FB);
+                        return StopReason::None;
+                    case 0x00FD:
+                        next_pc = pc;
+                        return StopReason::Halted;
+                    case 0x00FE:
+                    case 0x00FF:
+                        extended_mode[l] = op.opcode == 0x00FF;
+                        return StopReason::None;
+                }
+                if ((op.opcode & 0xFFF0) == 0x00C0)
+                {
+                    scroll_down(l, op.n);
+                    return StopReason::None;
+                }
+                break;
+
+            case 0x2:
+                if (sp[l] >= 32)
+                {
+                    fault_message[l] = "Stack overflow! Your program has an error!";
+                    next_pc = pc;
+                    return StopReason::Fault;
+                }
+                stack[l * 32 + sp[l]] = pc;
+                ++sp[l];
+                next_pc = op.nnn;
+                return StopReason::None;
+
+            case 0xA:
+                I = op.nnn;
+                return StopReason::None;
+
+            case 0xB:
+                next_pc = (V(quirks.jump_uses_vx ? op.x : 0) + op.nnn) & 0xFFF;
+                return StopReason::None;
+
+            case 0xC:
+                V(op.x) = static_cast<uint8_t>(next_random(l) & op.nn);
+                return StopReason::None;
+
+            case 0xD:
+                draw_sprite(l, op);
+                return StopReason::None;
+
+            case 0xE:
+                if (op.nn == 0x9E)
+                {
+                    next_pc = pc + ((keys[l] >> (V(op.x) & 0xF)) & 1 ? 4 : 2);
+                    return StopReason::None;
+                }
+                if (op.nn == 0xA1)
+                {
+                    next_pc = pc + ((keys[l] >> (V(op.x) & 0xF)) & 1 ? 2 : 4);
+                    return StopReason::None;
+                }
+                break;
+
+            case 0xF:
+                switch (op.nn)
+                {
+                    case 0x07: V(op.x) = delay_timer[l]; return StopReason::None;
+                    case 0x15: delay_timer[l] = V(op.x); return StopReason::None;
+                    case 0x18: sound_timer[l] = V(op.x); return StopReason::None;
+                    case 0x1E: I = (I + V(op.x)) & 0xFFF; return StopReason::None;
+                    case 0x29: I = chip8_font_address + (V(op.x) & 0xF) * 5; return StopReason::None;
+                    case 0x30: I = chip48_font_address + (V(op.x) & 0xF) * 10; return StopReason::None;
+                    case 0x0A:
+                        for (int k = 0; k < 16; ++k)
+                        {
+                            if ((keys[l] >> k) & 1)
+                            {
+                                V(op.x) = static_cast<uint8_t>(k);
+                                return StopReason::None;
+                            }
+                        }
+                        next_pc = pc;
+                        return StopReason::WaitingForKey;
+                    case 0x33:
+                    {
+                        uint8_t value = V(op.x);
+                        write_lane_memory(l, I, value / 100);
+                        write_lane_memory(l, I + 1, (value / 10) % 10);
+                        write_lane_memory(l, I + 2, value % 10);
+                        return StopReason::None;
+                    }
+                    case 0x55:
+                        for (int i = 0; i <= (quirks.load_store_skips_vx ? op.x - 1 : op.x); ++i)
+                            write_lane_memory(l, I + i, V(i));
+                        if (quirks.load_store_advances_i)
+                            I = (I + op.x + 1) & 0xFFF;
+                        return StopReason::None;
+                    case 0x65:
+                        for (int i = 0; i <= (quirks.load_store_skips_vx ? op.x - 1 : op.x); ++i)
+                            V(i) = m[(I + i) & 0xFFF];
+                        if (quirks.load_store_advances_i)
+                            I = (I + op.x + 1) & 0xFFF;
+                        return StopReason::None;
+                    case 0x75:
+                        for (int i = 0; i <= op.x && i < 8; ++i)
+                            rpl_user_flags[l * 8 + i] = V(i);
+                        return StopReason::None;
+                    case 0x85:
+                        for (int i = 0; i <= op.x && i < 8; ++i)
+                            V(i) = rpl_user_flags[l * 8 + i];
+                        return StopReason::None;
+                }
+                break;
+        }
+
+        next_pc = pc;
+        switch (op.opcode >> 12)
+        {
+            case 0x0:  fault_message[l] = "Unknown 0x0 opcode, Your program has an error!"; break;
+            case 0x8:  fault_message[l] = "Unknown opcode within 0x8 cases in ALU!"; break;
+            case 0xE:  fault_message[l] = "Unknown opcode within 0xE cases in ALU!"; break;
+            default:   fault_message[l] = "Unknown opcode within 0xF cases in ALU!"; break;
+        }
+        return StopReason::Fault;
+    }
+
+    void draw_sprite(size_t l, const Chip8::DecodedOp &op)
+    {
+        const uint8_t* m = &memory[l * 4096];
+        uint16_t I = index[l];
+        uint8_t x = registers[op.x * padded + l];
+        uint8_t y = registers[op.y * padded + l];
+        bool extended = extended_mode[l] != 0;
+        uint8_t height = op.n == 0 ? 16 : op.n;
+        bool wide = op.n == 0 && extended;
+        uint64_t collision = 0;
+
+        if (quirks.sprites_clip)
+        {
+            int rows = extended ? 64 : 32;
+            x &= extended ? 127 : 63;
+            y &= rows - 1;
+            if (height > rows - y)
+                height = static_cast<uint8_t>(rows - y);
+        }
+
+        for (int row = 0; row < height; ++row)
+        {
+            uint16_t spriteRow;
+            if (wide)
+                spriteRow = static_cast<uint16_t>(m[(I + row * 2) & 0xFFF]) << 8 | m[(I + row * 2 + 1) & 0xFFF];
+            else
+                spriteRow = static_cast<uint16_t>(m[(I + row) & 0xFFF]) << 8;
+
+            if (extended)
+            {
+                uint64_t left = static_cast<uint64_t>(spriteRow) << 48;
+                uint64_t right = 0;
+                if (quirks.sprites_clip)
+                    Chip8::shift_right(left, right, x);
+                else
+                    Chip8::rotate_right(left, right, x);
+                uint64_t* line = &graphics_extended[l * 128 + ((y + row) & 63) * 2];
+                collision |= (line[0] & left) | (line[1] & right);
+                line[0] ^= left;
+                line[1] ^= right;
+            }
+            else
+            {
+                uint64_t sprite_bits = static_cast<uint64_t>(spriteRow) << 48;
+                uint64_t bits = quirks.sprites_clip ? sprite_bits >> x : Chip8::rotate_right(sprite_bits, x);
+                uint64_t &line = graphics[l * 32 + ((y + row) & 31)];
+                collision |= line & bits;
+                line ^= bits;
+            }
+        }
+        registers[0xF * padded + l] = collision != 0 ? 1 : 0;
+    }
+
+    void scroll_down(size_t l, uint8_t n)
+    {
+        if (extended_mode[l])
+        {
+            uint64_t* rows = &graphics_extended[l * 128];
+            memmove(rows + n * 2, rows, (64 - n) * 2 * sizeof(uint64_t));
+            memset(rows, 0, n * 2 * sizeof(uint64_t));
+        }
+        else
+        {
+            uint64_t* rows = &graphics[l * 32];
+            memmove(rows + n, rows, (32 - n) * sizeof(uint64_t));
+            memset(rows, 0, n * sizeof(uint64_t));
+        }
+    }
+
+    void scroll_horizontal(size_t l, bool right)
+    {
+        const int scroll = 4;
+        if (extended_mode[l])
+        {
+            uint64_t* rows = &graphics_extended[l * 128];
+            for (int y = 0; y < 64; ++y)
+            {
+                uint64_t &a = rows[y * 2];
+                uint64_t &b = rows[y * 2 + 1];
+                if (right)
+                {
+                    b = (b >> scroll) | (a << (64 - scroll));
+                    a >>= scroll;
+                }
+                else
+                {
+                    a = (a << scroll) | (b >> (64 - scroll));
+                    b <<= scroll;
+                }
+            }
+        }
+        else
+        {
+            uint64_t* rows = &graphics[l * 32];
+            for (int y = 0; y < 32; ++y)
+                rows[y] = right ? rows[y] >> scroll : rows[y] << scroll;
+        }
+    }
+};
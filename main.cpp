@@ -5,7 +5,15 @@
 #include </Users/seshak/Desktop/chip8/include/SDL2/SDL.h>
 #include <unordered_map>
 #include "cpu.cpp"
+#include "rewind.cpp"
+#include "movie.cpp"
+#include "audio.cpp"
+#include "framebuffer.cpp"
+#include "pixels.cpp"
+#include <time.h>
+#include <memory>
 #include <vector>
+#include <string.h>
 
 
 using namespace std;
@@ -13,12 +21,14 @@ using namespace std;
 class Chip8Emulator 
 {
 public:
-    Chip8Emulator() 
+    // scale is how much the pixel buffer is blown up on the CPU, colours are 0xRRGGBB
+    Chip8Emulator(int scale, uint32_t off_rgb, uint32_t on_rgb)
+        : pixels(scale)
     {
         cout << "CHIP8 Started!" << endl;
         cout << "Initializing SDL!" << endl;
 
-        if (SDL_Init(SDL_INIT_EVERYTHING) < 0) {
+        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
             cerr << "SDL Initialization Failed!" << endl;
             exit(EXIT_FAILURE); // Handle the failure using exit
         }
@@ -26,7 +36,8 @@ public:
         create_window();
 
 
-        renderer = SDL_CreateRenderer(window, -1, 0);
+        // Vsync caps presents at the host refresh rate
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_PRESENTVSYNC);
 
         if (renderer == nullptr) {
             const char* err = SDL_GetError();
@@ -35,15 +46,27 @@ public:
             exit(EXIT_FAILURE); // Handle the failure using exit
         }
 
-        texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, 64, 32);
+        // Same pixel format as the window where it's 32-bit, so the software renderer
+        // copies the texture without converting every pixel
+        Uint32 format = SDL_GetWindowPixelFormat(window);
+        if (SDL_BYTESPERPIXEL(format) != 4)
+            format = SDL_PIXELFORMAT_RGBA8888;
+
+        texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, pixels.width(), pixels.height());
         if (texture == nullptr) {
             cerr << "SDL Texture Creation Failed!" << endl;
             exit(EXIT_FAILURE); // Handle the failure using exit
         }
+
+        SDL_PixelFormat* layout = SDL_AllocFormat(format);
+        pixels.set_palette({pack(layout, off_rgb), pack(layout, on_rgb)});
+        SDL_FreeFormat(layout);
     }
 
     ~Chip8Emulator() 
     {
+        if (audio_device != 0)
+            SDL_CloseAudioDevice(audio_device);
         SDL_DestroyTexture(texture);
 		SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
@@ -53,6 +76,29 @@ public:
         cout << "CHIP8 Exiting! 😵" << endl;
     }
 
+    // Starts pulling samples from beeper on SDL's audio thread. buffer_samples sets the
+    // device buffer and so the latency, 512 at 44.1 kHz is about 12 ms. Runs on without
+    // sound when there is no audio device.
+    bool open_audio(Chip8Beeper &beeper, int sample_rate, int buffer_samples)
+    {
+        if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0)
+            return false;
+
+        SDL_AudioSpec want = {};
+        SDL_AudioSpec have = {};
+        want.freq = sample_rate;
+        want.format = AUDIO_S16SYS;
+        want.channels = 1;
+        want.samples = static_cast<Uint16>(buffer_samples);
+        want.callback = audio_callback;
+        want.userdata = &beeper;
+        audio_device = SDL_OpenAudioDevice(nullptr, 0, &want, &have, 0);
+        if (audio_device == 0)
+            return false;
+        SDL_PauseAudioDevice(audio_device, 0);
+        return true;
+    }
+
     void clear_window()
     {
         SDL_RenderClear(renderer);
@@ -79,11 +125,42 @@ public:
         return window;
     }
 
+    // Largest 2:1 rectangle that fits the window, centred. With --scale matching the
+    // window this is the texture's own size and the copy doesn't scale at all.
+    SDL_Rect display_rect()
+    {
+        int w = 0, h = 0;
+        SDL_GetRendererOutputSize(renderer, &w, &h);
+        SDL_Rect rect = {0, 0, w, w / 2};
+        if (rect.h > h)
+        {
+            rect.h = h;
+            rect.w = h * 2;
+        }
+        rect.x = (w - rect.w) / 2;
+        rect.y = (h - rect.h) / 2;
+        return rect;
+    }
+
+    // CPU side copy of the texture, rebuilt only where the display changed
+    Chip8PixelBuffer pixels;
+
 private:
+    SDL_AudioDeviceID audio_device = 0;
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
     SDL_Texture* texture = nullptr;
 
+    static void audio_callback(void* userdata, Uint8* stream, int length)
+    {
+        static_cast<Chip8Beeper*>(userdata)->fill(reinterpret_cast<int16_t*>(stream), length / sizeof(int16_t));
+    }
+
+    static uint32_t pack(const SDL_PixelFormat* layout, uint32_t rgb)
+    {
+        return SDL_MapRGBA(layout, (rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF, 0xFF);
+    }
+
     void create_window()
     {
         window = SDL_CreateWindow("CHIP8 Window", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1024, 512, SDL_WINDOW_SHOWN);
@@ -91,58 +168,17 @@ private:
 
 };
 
-void loadROM(const char* filename, Chip8 &cpu)  // Implement file opener
+// Converts the rows that changed since the last frame and uploads only the span from the
+// first to the last of them, returns false when nothing changed
+bool buildTexture(Chip8Emulator &emulator, const Chip8Frame &frame)
 {
-    std::ifstream rom(filename, std::ios::binary);
-
-    if (rom.is_open()) {
-        rom.seekg(0, std::ios::end);
-        std::streampos size = rom.tellg();
-        rom.seekg(0, std::ios::beg);
-
-        cout << "Loading ROM: " << filename << endl;    
-        if (size > 0 && size <= 0xFFFE00) {
-            // Read the ROM directly into Chip-8 memory starting from 0x200
-            rom.read(reinterpret_cast<char*>(&cpu.memory[0x200]), size);
-        }
-
-        rom.close();
-    }
-}
-
-void buildTexture(Chip8Emulator &emulator, Chip8 &cpu)
-{
-    uint32_t* bytes = nullptr;
-    int pitch = 0;
-
-    SDL_LockTexture(emulator.getSDL_Texture(), nullptr, reinterpret_cast<void**>(&bytes), &pitch);
-
-        //cout << "is it locked in" << endl;
-
-        // if(!cpu.extendedScreenMode)
-        // {
-            //cout << "chip8" << endl;
-            for (size_t y = 0; y < 32; ++y) {  // Update for CHIP-8 resolution
-                for (size_t x = 0; x < 64; ++x) {  // Update for CHIP-8 resolution
-                    bytes[y * 64 + x] = (cpu.graphics[y * 64 + x] == 1) ? 0xFFFFFFFF : 0x000000FF;
-                }
-            }
-        // }
-        // else
-        // {
-        //     cout << "chip48" << endl;
-        //     for (size_t y = 0; y < 64; ++y) {  // Update for Super CHIP-48 resolution
-        //         for (size_t x = 0; x < 128; ++x) {  // Update for Super CHIP-48 resolution
-        //             bytes[y * 128 + x] = (cpu.graphics_extended[y * 128 + x] == 1) ? 0xFFFFFFFF : 0x000000FF;
-        //         }
-        //     }
-        // }
-
-
-    SDL_UnlockTexture(emulator.getSDL_Texture());
-
-    //cout << "does this work" << endl;
+    int first, count;
+    if (!emulator.pixels.convert(frame, first, count))
+        return false;
 
+    SDL_Rect span = {0, first, emulator.pixels.width(), count};
+    SDL_UpdateTexture(emulator.getSDL_Texture(), &span, emulator.pixels.row(first), emulator.pixels.pitch());
+    return true;
 }
 
 const array<int, 16> keymap = {{
@@ -164,51 +200,249 @@ const array<int, 16> keymap = {{
     SDL_SCANCODE_V
 }};
 
-int main() 
+int main(int argc, char* argv[]) 
 {
+    const char* usage = "Usage: play [--ips N] [--turbo] [--render-every N] [--seed N] [--record movie] [--quirks profile] [--trace file] [--profile heatmap] [--audio-buffer N | --mute] [--scale N] [--palette RRGGBB,RRGGBB] <rom>\n"
+                        "       play [options] --replay movie";
+    const char* rom_path = nullptr;
+    uint32_t ips = 600;
+    bool turbo = false;
+    uint32_t render_every = 10;
+    uint32_t seed = static_cast<uint32_t>(time(NULL));
+    const char* record_path = nullptr;
+    const char* replay_path = nullptr;
+    const char* trace_path = nullptr;
+    const char* profile_path = nullptr;
+    QuirkProfile quirks = QuirkProfile::Original;
+    int audio_buffer = 512;
+    bool mute = false;
+    int scale = 1;
+    uint32_t off_rgb = 0x000000, on_rgb = 0xFFFFFF;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--ips") == 0 && i + 1 < argc)
+            ips = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "--turbo") == 0)
+            turbo = true;
+        else if (strcmp(argv[i], "--render-every") == 0 && i + 1 < argc)
+            render_every = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            record_path = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replay_path = argv[++i];
+        else if (strcmp(argv[i], "--quirks") == 0 && i + 1 < argc)
+        {
+            if (!parse_quirk_profile(argv[++i], quirks))
+            {
+                cerr << "Unknown quirk profile: " << argv[i] << " (original, vip, schip or xochip)" << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            trace_path = argv[++i];
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+            profile_path = argv[++i];
+        else if (strcmp(argv[i], "--audio-buffer") == 0 && i + 1 < argc)
+            audio_buffer = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--mute") == 0)
+            mute = true;
+        else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+            scale = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--palette") == 0 && i + 1 < argc)
+        {
+            if (!parse_chip8_palette(argv[++i], off_rgb, on_rgb))
+            {
+                cerr << "Palette should look like 000000,FFFFFF (background, foreground)" << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strncmp(argv[i], "--", 2) != 0 && !rom_path)
+            rom_path = argv[i];
+        else
+        {
+            cerr << usage << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    // A movie brings its own starting state, anything else needs a ROM
+    if (!rom_path && !replay_path)
+    {
+        cerr << usage << endl;
+        return EXIT_FAILURE;
+    }
+    if (render_every == 0)
+        render_every = 1;
+
+    // Tone while sound_timer runs, fed a frame at a time to the audio callback. Declared
+    // first so it outlives the audio device the emulator closes.
+    const int sample_rate = 44100;
+    Chip8Beeper beeper(sample_rate);
+
+    Chip8Emulator emulator(scale, off_rgb, on_rgb);
+
+    // Movies take over the keys while replaying, and rewinding is off while one is recorded or played.
+    // A movie replays under the profile it was recorded with, whatever --quirks says.
+    Chip8MovieRecorder recorder;
+    Chip8MoviePlayer player;
+    bool replaying = false;
+    if (replay_path)
+    {
+        // The movie starts from a full snapshot, so no ROM is needed
+        if (!player.open(replay_path))
+        {
+            cerr << "Could not open movie: " << replay_path << endl;
+            return EXIT_FAILURE;
+        }
+        quirks = player.quirks();
+    }
 
+    Chip8 cpu(quirks);
+    if (!mute && !emulator.open_audio(beeper, sample_rate, audio_buffer > 0 ? audio_buffer : 512))
+        cerr << "No audio device, running without sound" << endl;
 
-    Chip8Emulator emulator;
-    Chip8 cpu;
-
-    //cout << __cplusplus << endl;
-    bool running = true;
-    int duration_ms = 16;
-    auto duration = chrono::milliseconds(duration_ms);
+    // Hold Backspace to step back a frame at a time
+    Chip8Rewind history;
 
-    
     cpu.init();
+    cpu.seed_random(seed);
+
+    // Instruction trace for tracedump, written from a background thread
+    unique_ptr<Chip8Trace> trace;
+    Chip8TraceWriter trace_writer;
+    if (trace_path)
+    {
+        trace.reset(new Chip8Trace);
+        if (trace_writer.start(trace_path, *trace))
+            cpu.trace = trace.get();
+        else
+            cerr << "Could not write trace: " << trace_path << endl;
+    }
+
+    // Opcode and address counts, reported when the emulator exits
+    unique_ptr<Chip8Profile> profile;
+    if (profile_path)
+    {
+        profile.reset(new Chip8Profile);
+        cpu.profile = profile.get();
+    }
+
+    cpu.cycles_per_frame = ips >= 60 ? ips / 60 : 1;
     cout << "init functions ran" << endl;
 
     for(int i = 0; i < 8; i++) 
-        cpu.rpl_user_flags[i] = rand() & 0x3F;
+        cpu.rpl_user_flags[i] = cpu.next_random() & 0x3F;
 
 
 
-    loadROM("/Users/seshak/Desktop/chip8/test_opcode.ch8", cpu);
-    cout << "Emulator cycle begins" << endl;
-    while(running)
+    if (replay_path)
     {
-        auto x = cpu.program_counter; // debugging
-
-        // Emulation Cycle
-        SDL_Event event;
-        cpu.cycle();
+        player.seek(cpu, 0);
+        replaying = true;
+    }
+    else
+    {
+        if (!loadROM(rom_path, cpu))
+        {
+            cerr << "Could not open ROM: " << rom_path << endl;
+            return EXIT_FAILURE;
+        }
+        if (record_path && !recorder.open(record_path, cpu))
+            cerr << "Could not record to: " << record_path << endl;
+    }
+    history.push(cpu);
+    cout << "Emulator cycle begins" << endl;
 
-        char hex_string[20];
-        if(x != cpu.program_counter)
+    // The emulation thread owns cpu from here on. This thread handles events and draws
+    // whatever frame was published last, keys go over as a bitmask, so a slow present or a
+    // vsync wait never holds up emulated time.
+    atomic<bool> running{true};
+    atomic<bool> fast_forward{false};
+    atomic<bool> rewinding{false};
+    atomic<uint16_t> key_mask{0};
+    Chip8TripleBuffer<Chip8Frame> frames;
+    chip8_capture_frame(cpu, frames.back());
+    frames.publish();
+
+    thread emulation([&] {
+        // Frames are paced against absolute 60 Hz deadlines so time spent emulating
+        // doesn't add up into drift the way a relative sleep after each frame does
+        using frame_clock = chrono::steady_clock;
+        const auto frame_duration = chrono::duration_cast<frame_clock::duration>(chrono::duration<double>(1.0 / 60.0));
+        auto next_frame = frame_clock::now() + frame_duration;
+        uint64_t published_generation = cpu.display_generation;
+
+        while (running.load(memory_order_relaxed))
         {
-            sprintf(hex_string, "%X", cpu.current_opcode); //convert number to hex
-            cout << "debugging message: 0x" << hex_string << endl; 
+            if (!replaying)
+                chip8_set_key_mask(cpu, key_mask.load(memory_order_relaxed));
+
+            // Emulation, one 60 Hz frame worth of instructions, or one frame back while rewinding
+            if (rewinding.load(memory_order_relaxed) && !replaying && !recorder.recording())
+                history.step_back(cpu);
+            else
+            {
+                StopReason reason;
+                if (replaying)
+                {
+                    player.play_to(cpu, cpu.cycle_count + cpu.cycles_per_frame - cpu.cycles_into_frame);
+                    reason = cpu.status;
+                    if (cpu.cycle_count >= player.end_cycle())
+                        replaying = false;  // Movie over, the keyboard takes over again
+                }
+                else
+                {
+                    recorder.frame(cpu);
+                    reason = cpu.run_frame();
+                }
+                history.push(cpu);
+                beeper.frame(cpu.sound_timer > 0);
+                if (reason == StopReason::Halted || reason == StopReason::Fault)
+                {
+                    if (reason == StopReason::Fault)
+                        cerr << cpu.fault_message << endl;
+                    running = false;
+                }
+            }
+
+            // Unthrottled runs only publish every Nth frame
+            bool unthrottled = turbo || fast_forward.load(memory_order_relaxed);
+            if (cpu.display_generation != published_generation && (!unthrottled || cpu.frame_count % render_every == 0))
+            {
+                chip8_capture_frame(cpu, frames.back());
+                frames.publish();
+                published_generation = cpu.display_generation;
+            }
+
+            if (unthrottled)
+            {
+                next_frame = frame_clock::now() + frame_duration;
+                continue;
+            }
+
+            this_thread::sleep_until(next_frame);
+            next_frame += frame_duration;
+
+            // Far behind (process stopped), resync instead of racing to catch up
+            if (frame_clock::now() > next_frame + 5 * frame_duration)
+                next_frame = frame_clock::now() + frame_duration;
         }
-        
-        while( SDL_PollEvent(&event) > 0 )
+    });
+
+    bool window_damaged = true;
+    while (running.load(memory_order_relaxed))
+    {
+        // Waiting here rather than sleeping keeps input latency down while nothing new is drawn
+        SDL_Event event;
+        bool have_event = SDL_WaitEventTimeout(&event, 2) > 0;
+        while (have_event)
         {
             switch(event.type)
             {
                 case SDL_QUIT:
                 {
-                    //cout << "quit";
                     running = false;
                     break;
                 }
@@ -217,38 +451,59 @@ int main()
                     {
                         running = false;
                     }
+                    // Hold Tab to fast-forward
+                    if (event.key.keysym.scancode == SDL_SCANCODE_TAB)
+                        fast_forward = true;
+                    if (event.key.keysym.scancode == SDL_SCANCODE_BACKSPACE)
+                        rewinding = true;
                     for (int i = 0; i < 16; ++i) {
                         if (event.key.keysym.scancode == keymap[i]) {
-                            cpu.keys[i] = 1;
+                            key_mask.fetch_or(static_cast<uint16_t>(1 << i), memory_order_relaxed);
                         }
                     }
                     break;
                 case SDL_KEYUP:
+                    if (event.key.keysym.scancode == SDL_SCANCODE_TAB)
+                        fast_forward = false;
+                    if (event.key.keysym.scancode == SDL_SCANCODE_BACKSPACE)
+                        rewinding = false;
                     for (int i = 0; i < 16; ++i) {
                         if (event.key.keysym.scancode == keymap[i]) {
-                            cpu.keys[i] = 0;
+                            key_mask.fetch_and(static_cast<uint16_t>(~(1 << i)), memory_order_relaxed);
                         }
                     }
                     break;
+                case SDL_WINDOWEVENT:
+                    window_damaged = true;
+                    break;
                 default:
-                    //cout << "failure";
-                
-            }   
+                    break;
+            }
+            have_event = SDL_PollEvent(&event) > 0;
         }
 
-        emulator.clear_window();
-
-        buildTexture(emulator, cpu); //lol broken
+        bool new_frame = frames.acquire();
+        if (new_frame || window_damaged)
+        {
+            buildTexture(emulator, frames.front());
+            window_damaged = false;
 
-        SDL_Rect dest = {0, 0, 640, 320};
+            emulator.clear_window();
 
-        SDL_RenderCopy(emulator.getSDL_Renderer(),emulator.getSDL_Texture() , nullptr, &dest);
-        emulator.present_render();
+            SDL_Rect dest = emulator.display_rect();
 
-        this_thread::sleep_for(duration);
+            SDL_RenderCopy(emulator.getSDL_Renderer(),emulator.getSDL_Texture() , nullptr, &dest);
+            emulator.present_render();
+        }
     }
+    emulation.join();
 
-
+    if (profile)
+    {
+        profile->report(cout);
+        if (!profile->write_heatmap(profile_path))
+            cerr << "Could not write heatmap: " << profile_path << endl;
+    }
 
     return 0;
 
@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <string.h>
+#include "rompack.cpp"
+
+// Builds a ROM pack from ROM files, or lists one.
+// Usage: mkpack <pack> <rom>...
+//        mkpack --list <pack>
+int main(int argc, char* argv[])
+{
+    if (argc == 3 && strcmp(argv[1], "--list") == 0)
+    {
+        Chip8RomPack pack;
+        if (!pack.open(argv[2]))
+        {
+            fprintf(stderr, "Not a valid ROM pack: %s\n", argv[2]);
+            return 1;
+        }
+        for (size_t i = 0; i < pack.size(); ++i)
+        {
+            size_t size;
+            pack.rom(i, size);
+            printf("%016llx %5zu %s\n", static_cast<unsigned long long>(pack.hash(i)), size, pack.name(i).c_str());
+        }
+        return 0;
+    }
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: mkpack <pack> <rom>...\n       mkpack --list <pack>\n");
+        return 1;
+    }
+
+    Chip8RomPackWriter writer;
+    for (int i = 2; i < argc; ++i)
+        if (!writer.add_file(argv[i]))
+            fprintf(stderr, "Skipping %s, unreadable or bigger than %zu bytes\n", argv[i], chip8_max_rom_size);
+
+    if (!writer.write(argv[1]))
+    {
+        fprintf(stderr, "Could not write all of %s, or two ROMs have the same file name\n", argv[1]);
+        return 1;
+    }
+    printf("%zu ROMs in %s\n", writer.size(), argv[1]);
+    return 0;
+}
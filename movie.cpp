@@ -0,0 +1,353 @@
+#pragma once
+
+// Input movies. A movie is a starting snapshot plus every change of the key state, each
+// stamped with the instruction count (Chip8::cycle_count) it took effect at. Since the core
+// is deterministic for a given state, seed and key timeline, replaying it reproduces the run
+// exactly.
+//
+// The recorder also writes a snapshot every keyframe_interval frames and, on close, an index
+// of them at the end of the file, so the player can seek anywhere by loading the nearest
+// keyframe and replaying only the key changes after it.
+//
+// File layout, host byte order:
+//   header    "C8MV", u32 version, u32 sizeof(Chip8State), u32 cycles_per_frame,
+//             u32 QuirkProfile
+//   records   'K' u64 cycle, u16 keys                     key state changed
+//             'S' u64 cycle, u16 keys, Chip8State         keyframe
+//             'I' u32 count, count * (u64 cycle, u64 offset of the 'S' record)
+//   footer    u64 offset of the 'I' record, "C8IX"
+// A movie that was never closed has no index, the player rebuilds it by scanning.
+
+#include <fstream>
+#include <vector>
+#include <string.h>
+#include "cpu.cpp"
+
+static const uint32_t chip8_movie_version = 2;
+
+inline uint16_t chip8_key_mask(const Chip8 &cpu)
+{
+    uint16_t mask = 0;
+    for (int k = 0; k < 16; ++k)
+        if (cpu.keys[k])
+            mask |= 1 << k;
+    return mask;
+}
+
+inline void chip8_set_key_mask(Chip8 &cpu, uint16_t mask)
+{
+    for (int k = 0; k < 16; ++k)
+        cpu.keys[k] = (mask >> k) & 1;
+}
+
+// Runs until cycle_count reaches target or the machine halts. While FX0A waits the clock is
+// moved forward in one go, which is what executing FX0A over and over would do anyway.
+inline void chip8_run_until(Chip8 &cpu, uint64_t target)
+{
+    while (cpu.cycle_count < target)
+    {
+        StopReason reason = cpu.run_cycles(target - cpu.cycle_count);
+        if (reason == StopReason::WaitingForKey)
+            cpu.advance_cycles(target - cpu.cycle_count);
+        else if (reason != StopReason::CycleLimit)
+            return;
+    }
+}
+
+class Chip8MovieRecorder {
+public:
+
+    explicit Chip8MovieRecorder(uint32_t keyframe_interval = 600)
+        : keyframe_interval(keyframe_interval ? keyframe_interval : 1)
+    {
+    }
+
+    ~Chip8MovieRecorder() { close(); }
+
+    // Starts a movie from the current state of cpu
+    bool open(const char* filename, const Chip8 &cpu)
+    {
+        close();
+        file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        file.write("C8MV", 4);
+        put(chip8_movie_version);
+        put(static_cast<uint32_t>(sizeof(Chip8State)));
+        put(cpu.cycles_per_frame);
+        put(static_cast<uint32_t>(cpu.quirks));
+
+        keyframes.clear();
+        last_keys = chip8_key_mask(cpu);
+        write_keyframe(cpu);
+        frames_since_keyframe = 0;
+        return true;
+    }
+
+    bool recording() const { return file.is_open(); }
+
+    // Call once per frame, after the front end updated cpu.keys and before it runs the frame
+    void frame(const Chip8 &cpu)
+    {
+        if (!file.is_open())
+            return;
+
+        if (++frames_since_keyframe >= keyframe_interval)
+        {
+            last_keys = chip8_key_mask(cpu);
+            write_keyframe(cpu);
+            frames_since_keyframe = 0;
+            return;
+        }
+
+        uint16_t keys = chip8_key_mask(cpu);
+        if (keys != last_keys)
+        {
+            file.put('K');
+            put(cpu.cycle_count);
+            put(keys);
+            last_keys = keys;
+        }
+    }
+
+    // Writes the keyframe index and footer
+    void close()
+    {
+        if (!file.is_open())
+            return;
+
+        uint64_t index_offset = static_cast<uint64_t>(file.tellp());
+        file.put('I');
+        put(static_cast<uint32_t>(keyframes.size()));
+        for (auto &k : keyframes)
+        {
+            put(k.cycle);
+            put(k.offset);
+        }
+        put(index_offset);
+        file.write("C8IX", 4);
+        file.close();
+    }
+
+private:
+
+    struct Keyframe
+    {
+        uint64_t cycle;
+        uint64_t offset;
+    };
+
+    std::ofstream file;
+    std::vector<Keyframe> keyframes;
+    uint32_t keyframe_interval;
+    uint32_t frames_since_keyframe = 0;
+    uint16_t last_keys = 0;
+
+    template <typename T>
+    void put(T value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+
+    void write_keyframe(const Chip8 &cpu)
+    {
+        Chip8State state;
+        cpu.save_state(state);
+
+        keyframes.push_back({cpu.cycle_count, static_cast<uint64_t>(file.tellp())});
+        file.put('S');
+        put(cpu.cycle_count);
+        put(last_keys);
+        file.write(reinterpret_cast<const char*>(&state), sizeof(state));
+    }
+};
+
+class Chip8MoviePlayer {
+public:
+
+    bool open(const char* filename)
+    {
+        file.close();
+        file.clear();
+        keyframes.clear();
+        has_pending = false;
+        finished = true;
+        last_cycle = 0;
+
+        file.open(filename, std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        char magic[4];
+        uint32_t version = 0, state_size = 0, profile = 0;
+        file.read(magic, 4);
+        get(version);
+        get(state_size);
+        get(cycles_per_frame);
+        get(profile);
+        if (!file || memcmp(magic, "C8MV", 4) != 0 || version != chip8_movie_version || state_size != sizeof(Chip8State))
+            return false;
+        if (profile > static_cast<uint32_t>(QuirkProfile::XoChip))
+            return false;
+        recorded_quirks = static_cast<QuirkProfile>(profile);
+        records_start = static_cast<uint64_t>(file.tellg());
+
+        if (!read_index())
+            scan_index();
+        return !keyframes.empty();
+    }
+
+    // Instruction count of the last key change or keyframe in the movie
+    uint64_t end_cycle() const { return last_cycle; }
+    size_t keyframe_count() const { return keyframes.size(); }
+    // The profile the movie was recorded under, the Chip8 replaying it has to be made with it
+    QuirkProfile quirks() const { return recorded_quirks; }
+
+    // Puts cpu at exactly the given instruction count, loading the nearest keyframe at or
+    // before it and replaying the key changes in between. Fails, leaving cpu alone, when cpu
+    // runs a different profile than the movie was recorded under.
+    bool seek(Chip8 &cpu, uint64_t target)
+    {
+        if (cpu.quirks != recorded_quirks)
+            return false;
+        if (target < keyframes[0].cycle)
+            target = keyframes[0].cycle;
+
+        size_t lo = 0, hi = keyframes.size();
+        while (hi - lo > 1)
+        {
+            size_t mid = (lo + hi) / 2;
+            if (keyframes[mid].cycle <= target)
+                lo = mid;
+            else
+                hi = mid;
+        }
+
+        file.clear();
+        file.seekg(keyframes[lo].offset);
+        has_pending = false;
+        finished = false;
+        cpu.cycles_per_frame = cycles_per_frame;
+        play_to(cpu, target);
+        return true;
+    }
+
+    // Plays forward from where the last seek() or play_to() left off, applying key changes
+    // as their instruction counts come up. Start with a seek(), going backwards needs one too.
+    void play_to(Chip8 &cpu, uint64_t target)
+    {
+        for (;;)
+        {
+            if (!has_pending && (finished || !read_record(pending)))
+            {
+                finished = true;
+                break;
+            }
+            has_pending = true;
+            if (pending.cycle > target)
+                break;
+
+            if (pending.keyframe)
+                cpu.load_state(pending_state);
+            else
+                chip8_run_until(cpu, pending.cycle);
+            chip8_set_key_mask(cpu, pending.keys);
+            has_pending = false;
+        }
+        chip8_run_until(cpu, target);
+    }
+
+private:
+
+    struct Keyframe
+    {
+        uint64_t cycle;
+        uint64_t offset;
+    };
+
+    struct Record
+    {
+        bool keyframe;
+        uint64_t cycle;
+        uint16_t keys;
+    };
+
+    std::ifstream file;
+    std::vector<Keyframe> keyframes;
+    uint32_t cycles_per_frame = 10;
+    QuirkProfile recorded_quirks = QuirkProfile::Original;
+    uint64_t records_start = 0;
+    uint64_t last_cycle = 0;
+    Record pending;
+    bool has_pending = false;
+    bool finished = false;  // Ran into the index, stop reading records until the next seek()
+    Chip8State pending_state;
+
+    template <typename T>
+    bool get(T &value) { return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value))); }
+
+    // Next key change or keyframe, false at the index or end of file
+    bool read_record(Record &record)
+    {
+        int tag = file.get();
+        if (tag != 'K' && tag != 'S')
+            return false;
+        record.keyframe = tag == 'S';
+        if (!get(record.cycle) || !get(record.keys))
+            return false;
+        if (record.keyframe && !file.read(reinterpret_cast<char*>(&pending_state), sizeof(pending_state)))
+            return false;
+        return true;
+    }
+
+    bool read_index()
+    {
+        uint64_t index_offset = 0;
+        char magic[4];
+        file.seekg(-12, std::ios::end);
+        if (!get(index_offset) || !file.read(magic, 4) || memcmp(magic, "C8IX", 4) != 0)
+        {
+            file.clear();
+            return false;
+        }
+
+        uint32_t count = 0;
+        file.seekg(index_offset);
+        if (file.get() != 'I' || !get(count))
+        {
+            file.clear();
+            return false;
+        }
+        keyframes.resize(count);
+        for (auto &k : keyframes)
+            if (!get(k.cycle) || !get(k.offset))
+            {
+                file.clear();
+                keyframes.clear();
+                return false;
+            }
+
+        // End of the movie is the last record before the index, found from the last keyframe on
+        file.seekg(keyframes.empty() ? records_start : keyframes.back().offset);
+        Record record;
+        while (read_record(record))
+            last_cycle = record.cycle;
+        file.clear();
+        return true;
+    }
+
+    void scan_index()
+    {
+        file.clear();
+        file.seekg(records_start);
+        for (;;)
+        {
+            uint64_t offset = static_cast<uint64_t>(file.tellg());
+            Record record;
+            if (!read_record(record))
+                break;
+            if (record.keyframe)
+                keyframes.push_back({record.cycle, offset});
+            last_cycle = record.cycle;
+        }
+        file.clear();
+    }
+};
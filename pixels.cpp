@@ -0,0 +1,243 @@
+#pragma once
+
+// Display to 32-bit pixels for the renderer.
+//
+// Chip8PixelBuffer turns a Chip8Frame into one packed 32-bit colour per pixel through a
+// two colour palette, optionally scaled up by a whole number so the renderer can copy it
+// 1:1 instead of stretching it (the software renderer stretches on the CPU every frame).
+// The output is always 128x64 times the scale: CHIP-8 frames come out with every pixel
+// doubled, so switching display modes never needs a new texture. Only rows that differ
+// from the previous convert() are redone.
+//
+// Each 8 pixels of a row are one byte of the frame. The byte is broadcast into every lane,
+// ANDed with a one-bit-per-lane selector and compared, giving an all-ones mask for lit
+// pixels that picks between the palette colours. Doubled pixels are lane shuffles of that,
+// bigger scales broadcast each colour. AVX2 does 8 pixels per vector, SSE2 4, anything
+// else falls back to the plain loop.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "framebuffer.cpp"
+
+#if defined(__AVX2__)
+#define CHIP8_PIXELS_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#define CHIP8_PIXELS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Packed pixel values, in whatever format the texture uses
+struct Chip8Palette
+{
+    uint32_t off;
+    uint32_t on;
+};
+
+// "RRGGBB,RRGGBB", background then foreground, into 0xRRGGBB values
+inline bool parse_chip8_palette(const char* text, uint32_t &off_rgb, uint32_t &on_rgb)
+{
+    char* end;
+    unsigned long off = strtoul(text, &end, 16);
+    if (end != text + 6 || *end != ',')
+        return false;
+    const char* second = end + 1;
+    unsigned long on = strtoul(second, &end, 16);
+    if (end != second + 6 || *end != '\0')
+        return false;
+    off_rgb = static_cast<uint32_t>(off);
+    on_rgb = static_cast<uint32_t>(on);
+    return true;
+}
+
+// Reference version, 64 pixels (bit 63 first) each written repeat times
+inline void chip8_expand_bits_scalar(uint64_t bits, const Chip8Palette &palette, int repeat, uint32_t* out)
+{
+    for (int x = 0; x < 64; ++x)
+    {
+        uint32_t colour = (bits >> (63 - x)) & 1 ? palette.on : palette.off;
+        for (int r = 0; r < repeat; ++r)
+            *out++ = colour;
+    }
+}
+
+inline void chip8_expand_bits(uint64_t bits, const Chip8Palette &palette, int repeat, uint32_t* out)
+{
+#if defined(CHIP8_PIXELS_AVX2)
+    const __m256i select = _mm256_setr_epi32(128, 64, 32, 16, 8, 4, 2, 1);
+    const __m256i off = _mm256_set1_epi32(static_cast<int>(palette.off));
+    const __m256i flip = _mm256_set1_epi32(static_cast<int>(palette.off ^ palette.on));
+
+    if (repeat <= 2)
+    {
+        const __m256i low = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+        const __m256i high = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+        for (int i = 0; i < 8; ++i)
+        {
+            __m256i byte = _mm256_set1_epi32(static_cast<int>((bits >> (56 - 8 * i)) & 0xFF));
+            __m256i lit = _mm256_cmpeq_epi32(_mm256_and_si256(byte, select), select);
+            __m256i pixels = _mm256_xor_si256(off, _mm256_and_si256(lit, flip));
+            if (repeat == 1)
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 8 * i), pixels);
+            else
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16 * i), _mm256_permutevar8x32_epi32(pixels, low));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16 * i + 8), _mm256_permutevar8x32_epi32(pixels, high));
+            }
+        }
+        return;
+    }
+
+    // Wider pixels are whole vectors of one colour and a scalar tail
+    for (int x = 0; x < 64; ++x)
+    {
+        uint32_t colour = (bits >> (63 - x)) & 1 ? palette.on : palette.off;
+        __m256i run = _mm256_set1_epi32(static_cast<int>(colour));
+        int r = 0;
+        for (; r + 8 <= repeat; r += 8)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + r), run);
+        for (; r < repeat; ++r)
+            out[r] = colour;
+        out += repeat;
+    }
+#elif defined(CHIP8_PIXELS_SSE2)
+    const __m128i select_high = _mm_setr_epi32(128, 64, 32, 16);
+    const __m128i select_low = _mm_setr_epi32(8, 4, 2, 1);
+    const __m128i off = _mm_set1_epi32(static_cast<int>(palette.off));
+    const __m128i flip = _mm_set1_epi32(static_cast<int>(palette.off ^ palette.on));
+
+    if (repeat <= 2)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            __m128i byte = _mm_set1_epi32(static_cast<int>((bits >> (56 - 8 * i)) & 0xFF));
+            __m128i first = _mm_xor_si128(off, _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(byte, select_high), select_high), flip));
+            __m128i second = _mm_xor_si128(off, _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(byte, select_low), select_low), flip));
+            __m128i* line = reinterpret_cast<__m128i*>(out + 8 * repeat * i);
+            if (repeat == 1)
+            {
+                _mm_storeu_si128(line, first);
+                _mm_storeu_si128(line + 1, second);
+            }
+            else
+            {
+                _mm_storeu_si128(line, _mm_unpacklo_epi32(first, first));
+                _mm_storeu_si128(line + 1, _mm_unpackhi_epi32(first, first));
+                _mm_storeu_si128(line + 2, _mm_unpacklo_epi32(second, second));
+                _mm_storeu_si128(line + 3, _mm_unpackhi_epi32(second, second));
+            }
+        }
+        return;
+    }
+
+    for (int x = 0; x < 64; ++x)
+    {
+        uint32_t colour = (bits >> (63 - x)) & 1 ? palette.on : palette.off;
+        __m128i run = _mm_set1_epi32(static_cast<int>(colour));
+        int r = 0;
+        for (; r + 4 <= repeat; r += 4)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + r), run);
+        for (; r < repeat; ++r)
+            out[r] = colour;
+        out += repeat;
+    }
+#else
+    chip8_expand_bits_scalar(bits, palette, repeat, out);
+#endif
+}
+
+class Chip8PixelBuffer {
+public:
+
+    static const int max_scale = 16;
+
+    explicit Chip8PixelBuffer(int scale = 1, Chip8Palette palette = {0x000000FF, 0xFFFFFFFF})
+        : scale(scale < 1 ? 1 : scale > max_scale ? max_scale : scale), palette(palette),
+          buffer(static_cast<size_t>(128 * this->scale) * 64 * this->scale, palette.off)
+    {
+    }
+
+    int width() const  { return 128 * scale; }
+    int height() const { return 64 * scale; }
+    int pitch() const  { return width() * static_cast<int>(sizeof(uint32_t)); }
+    const uint32_t* pixels() const { return buffer.data(); }
+    const uint32_t* row(int y) const { return buffer.data() + static_cast<size_t>(y) * width(); }
+
+    void set_palette(const Chip8Palette &colours)
+    {
+        palette = colours;
+        valid = false;
+    }
+
+    // Redraws everything on the next convert()
+    void invalidate() { valid = false; }
+
+    // Converts the rows of frame that changed since the last call. first_row and row_count
+    // give the span of output rows to upload, false when nothing changed.
+    bool convert(const Chip8Frame &frame, int &first_row, int &row_count)
+    {
+        const int rows = frame.extended ? 64 : 32;
+        uint64_t dirty = 0;
+        if (!valid || frame.extended != shown_extended)
+            dirty = frame.extended ? ~0ull : 0xFFFFFFFFull;
+        else if (frame.extended)
+        {
+            for (int y = 0; y < rows; ++y)
+                if (frame.graphics_extended[y][0] != shown[y][0] || frame.graphics_extended[y][1] != shown[y][1])
+                    dirty |= 1ull << y;
+        }
+        else
+        {
+            for (int y = 0; y < rows; ++y)
+                if (frame.graphics[y] != shown[y][0])
+                    dirty |= 1ull << y;
+        }
+        if (dirty == 0)
+            return false;
+
+        const int row_scale = frame.extended ? scale : 2 * scale;
+        const int first = __builtin_ctzll(dirty);
+        const int last = 63 - __builtin_clzll(dirty);
+        const size_t line_pixels = static_cast<size_t>(width());
+
+        for (int y = first; y <= last; ++y)
+        {
+            if (!((dirty >> y) & 1))
+                continue;
+            uint32_t* line = buffer.data() + static_cast<size_t>(y) * row_scale * line_pixels;
+            if (frame.extended)
+            {
+                chip8_expand_bits(frame.graphics_extended[y][0], palette, scale, line);
+                chip8_expand_bits(frame.graphics_extended[y][1], palette, scale, line + 64 * scale);
+                shown[y][0] = frame.graphics_extended[y][0];
+                shown[y][1] = frame.graphics_extended[y][1];
+            }
+            else
+            {
+                chip8_expand_bits(frame.graphics[y], palette, row_scale, line);
+                shown[y][0] = frame.graphics[y];
+            }
+            for (int copy = 1; copy < row_scale; ++copy)
+                memcpy(line + copy * line_pixels, line, line_pixels * sizeof(uint32_t));
+        }
+        shown_extended = frame.extended;
+        valid = true;
+
+        first_row = first * row_scale;
+        row_count = (last - first + 1) * row_scale;
+        return true;
+    }
+
+private:
+
+    int scale;
+    Chip8Palette palette;
+    std::vector<uint32_t> buffer;
+
+    // Rows the buffer was last built from
+    uint64_t shown[64][2] = {};
+    bool shown_extended = false;
+    bool valid = false;
+};
@@ -0,0 +1,176 @@
+#pragma once
+
+// Execution profile. With a Chip8Profile attached (Chip8::profile), Chip8::step() counts
+// every instruction by opcode class and by address, and whether skips were taken. report()
+// prints the summary, write_heatmap() dumps one byte per address (4 KB, readable as a
+// 64x64 greyscale image) with log-scaled execution counts.
+//
+// Building with -DCHIP8_NO_PROFILE compiles the hook out of step().
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+class Chip8Profile {
+public:
+
+    Chip8Profile() { reset(); }
+
+    void reset()
+    {
+        memset(class_count, 0, sizeof(class_count));
+        memset(skips_taken, 0, sizeof(skips_taken));
+        memset(pc_count, 0, sizeof(pc_count));
+        total = 0;
+    }
+
+    // pc_after is the program counter once the instruction ran, a skip landed 4 bytes on
+    void record(uint16_t pc, uint16_t opcode, uint16_t pc_after)
+    {
+        uint16_t c = opcode_class(opcode);
+        ++class_count[c];
+        ++pc_count[pc & 0xFFF];
+        ++total;
+        if (is_skip(c) && pc_after == pc + 4)
+            ++skips_taken[c];
+    }
+
+    uint64_t instructions() const { return total; }
+    uint64_t executions_at(uint16_t pc) const { return pc_count[pc & 0xFFF]; }
+
+    void report(std::ostream &out, size_t top = 16) const
+    {
+        out << "Profile: " << total << " instructions" << std::endl;
+        if (total == 0)
+            return;
+
+        std::vector<uint16_t> classes;
+        for (uint16_t c = 0; c < class_slots; ++c)
+            if (class_count[c] != 0)
+                classes.push_back(c);
+        std::sort(classes.begin(), classes.end(),
+                  [this](uint16_t a, uint16_t b) { return class_count[a] > class_count[b]; });
+
+        out << std::endl << "Opcodes" << std::endl;
+        for (uint16_t c : classes)
+        {
+            out << "  " << std::setw(4) << class_name(c) << std::setw(14) << class_count[c]
+                << std::setw(8) << std::fixed << std::setprecision(2) << percent(class_count[c]) << "%";
+            if (is_skip(c))
+                out << "   taken " << skips_taken[c] << ", not taken " << class_count[c] - skips_taken[c];
+            out << std::endl;
+        }
+
+        std::vector<uint16_t> pcs;
+        for (uint16_t pc = 0; pc < 4096; ++pc)
+            if (pc_count[pc] != 0)
+                pcs.push_back(pc);
+        size_t shown = std::min(top, pcs.size());
+        std::partial_sort(pcs.begin(), pcs.begin() + shown, pcs.end(),
+                          [this](uint16_t a, uint16_t b) { return pc_count[a] > pc_count[b]; });
+
+        out << std::endl << "Hottest addresses (" << pcs.size() << " executed)" << std::endl;
+        for (size_t i = 0; i < shown; ++i)
+        {
+            char address[8];
+            snprintf(address, sizeof(address), "0x%03X", pcs[i]);
+            out << "  " << address << std::setw(14) << pc_count[pcs[i]]
+                << std::setw(8) << percent(pc_count[pcs[i]]) << "%" << std::endl;
+        }
+        out << std::defaultfloat;
+    }
+
+    // One byte per address, 0 for never executed and 255 for the hottest
+    bool write_heatmap(const char* filename) const
+    {
+        uint64_t hottest = *std::max_element(pc_count, pc_count + 4096);
+        uint8_t heat[4096] = {};
+        if (hottest != 0)
+        {
+            double scale = 254.0 / log1p(static_cast<double>(hottest));
+            for (int pc = 0; pc < 4096; ++pc)
+                if (pc_count[pc] != 0)
+                    heat[pc] = static_cast<uint8_t>(1 + log1p(static_cast<double>(pc_count[pc])) * scale);
+        }
+
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open())
+            return false;
+        file.write(reinterpret_cast<const char*>(heat), sizeof(heat));
+        return static_cast<bool>(file);
+    }
+
+private:
+
+    // Class is first nibble * 256 + sub-opcode, the sub-opcode being the low byte where
+    // it selects the instruction (0, E, F), the low nibble for 8XY?, and 0 otherwise
+    static const int class_slots = 16 * 256;
+
+    uint64_t class_count[class_slots];
+    uint64_t skips_taken[class_slots];
+    uint64_t pc_count[4096];
+    uint64_t total;
+
+    static uint16_t opcode_class(uint16_t opcode)
+    {
+        uint16_t first = opcode >> 12;
+        switch (first)
+        {
+            case 0x0:
+                if ((opcode & 0xFFF0) == 0x00C0)
+                    return 0x0C0;  // 00CN
+                return (opcode & 0x0F00) ? 0 : opcode & 0xFF;
+            case 0x8:
+                return 0x800 | (opcode & 0xF);
+            case 0xE:
+            case 0xF:
+                return first << 8 | (opcode & 0xFF);
+            default:
+                return first << 8;
+        }
+    }
+
+    static bool is_skip(uint16_t c)
+    {
+        switch (c >> 8)
+        {
+            case 0x3: case 0x4: case 0x5: case 0x9:
+                return true;
+            case 0xE:
+                return c == 0xE9E || c == 0xEA1;
+            default:
+                return false;
+        }
+    }
+
+    static std::string class_name(uint16_t c)
+    {
+        static const char* const names[16] =
+        {
+            nullptr, "1NNN", "2NNN", "3XNN", "4XNN", "5XY0", "6XNN", "7XNN",
+            nullptr, "9XY0", "ANNN", "BNNN", "CXNN", "DXYN", nullptr, nullptr
+        };
+        char name[8];
+        uint16_t first = c >> 8, sub = c & 0xFF;
+        if (names[first] != nullptr)
+            return names[first];
+        if (first == 0x0 && sub == 0)
+            return "0NNN";
+        if (first == 0x0)
+            snprintf(name, sizeof(name), sub == 0xC0 ? "00CN" : "00%02X", sub);
+        else if (first == 0x8)
+            snprintf(name, sizeof(name), "8XY%X", sub);
+        else
+            snprintf(name, sizeof(name), "%XX%02X", first, sub);
+        return name;
+    }
+
+    double percent(uint64_t count) const { return 100.0 * count / total; }
+};
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <string.h>
+#include "recompiler.cpp"
+
+// Compiles a ROM to C++ for aot.cpp, and writes its disassembly and control flow graph.
+// Usage: recompile [--quirks profile] [--name id] [--listing file] [--dot file] <rom> [out.cpp]
+// The generated file defines a Chip8AotProgram called chip8_aot_program unless --name says
+// otherwise. `make headless AOT=out.cpp` builds it into headless for --aot.
+int main(int argc, char* argv[])
+{
+    QuirkProfile quirks = QuirkProfile::Original;
+    const char* name = "chip8_aot_program";
+    const char* listing_path = nullptr;
+    const char* dot_path = nullptr;
+    const char* rom_path = nullptr;
+    const char* out_path = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quirks") == 0 && i + 1 < argc)
+        {
+            if (!parse_quirk_profile(argv[++i], quirks))
+            {
+                fprintf(stderr, "Unknown quirk profile: %s (original, vip, schip or xochip)\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--name") == 0 && i + 1 < argc)
+            name = argv[++i];
+        else if (strcmp(argv[i], "--listing") == 0 && i + 1 < argc)
+            listing_path = argv[++i];
+        else if (strcmp(argv[i], "--dot") == 0 && i + 1 < argc)
+            dot_path = argv[++i];
+        else if (rom_path == nullptr)
+            rom_path = argv[i];
+        else
+            out_path = argv[i];
+    }
+
+    if (rom_path == nullptr)
+    {
+        fprintf(stderr, "Usage: recompile [--quirks profile] [--name id] [--listing file] [--dot file] <rom> [out.cpp]\n");
+        return 1;
+    }
+
+    Chip8 cpu(quirks);
+    cpu.init();
+    if (!loadROM(rom_path, cpu))
+    {
+        fprintf(stderr, "Could not open ROM: %s\n", rom_path);
+        return 1;
+    }
+
+    Chip8Recompiler recompiler(cpu.memory, quirks);
+    recompiler.analyze();
+    printf("%zu instructions reached, %zu blocks, %zu compiled, %zu indirect jumps\n",
+           recompiler.instruction_count(), recompiler.blocks().size(), recompiler.compiled_count(),
+           recompiler.indirect_jumps().size());
+
+    const char* paths[3] = {listing_path, dot_path, out_path};
+    for (int i = 0; i < 3; ++i)
+    {
+        if (paths[i] == nullptr)
+            continue;
+        FILE* out = fopen(paths[i], "w");
+        if (out == nullptr)
+        {
+            fprintf(stderr, "Could not write %s\n", paths[i]);
+            return 1;
+        }
+        if (i == 0)
+            recompiler.write_listing(out);
+        else if (i == 1)
+            recompiler.write_dot(out);
+        else
+            recompiler.write_cpp(out, name, rom_path);
+        fclose(out);
+    }
+    return 0;
+}
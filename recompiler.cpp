@@ -0,0 +1,630 @@
+#pragma once
+
+// Ahead-of-time recompiler, offline half of aot.cpp.
+//
+// Chip8Recompiler takes a memory image (a Chip8 after init() and loadROM()) and follows the
+// code from 0x200: fallthroughs, 1NNN and 2NNN targets, both ways out of every skip and the
+// return address after every call. BNNN targets depend on a register and aren't followed,
+// so code only reached through one is interpreted when the program gets there. Reached
+// code is cut into basic blocks at every branch target and after every branch, and each
+// block becomes a C++ function. ALU, timer and index opcodes are written out inline,
+// everything touching the display, stack or memory calls the interpreter's own handler.
+// So a compiled block can't disagree with step() about what an opcode does.
+//
+// Not compiled, left to step(): FX0A, 0000, unknown opcodes, and both idle loops
+// Chip8::skip_idle() recognises, so they still get fast-forwarded. A block that writes
+// memory on a page holding compiled code returns right after the write, so Chip8Aot can
+// check whether it overwrote code before running more of it.
+//
+// The same analysis gives a disassembly listing and a Graphviz control flow graph.
+
+#include <set>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "cpu.cpp"
+
+// Mnemonics as in Cowgod's reference plus the SUPER-CHIP ones, out has to hold 24 characters
+inline const char* chip8_disassemble(uint16_t opcode, char* out, size_t size)
+{
+    unsigned x = (opcode >> 8) & 0xF, y = (opcode >> 4) & 0xF, n = opcode & 0xF, nn = opcode & 0xFF, nnn = opcode & 0xFFF;
+    static const char* alu[16] = {"LD", "OR", "AND", "XOR", "ADD", "SUB", "SHR", "SUBN",
+                                  nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, "SHL", nullptr};
+    switch (opcode >> 12)
+    {
+        case 0x0:
+            if (opcode == 0x00E0)                 snprintf(out, size, "CLS");
+            else if (opcode == 0x00EE)            snprintf(out, size, "RET");
+            else if ((opcode & 0xFFF0) == 0x00C0) snprintf(out, size, "SCD %u", n);
+            else if (opcode == 0x00FB)            snprintf(out, size, "SCR");
+            else if (opcode == 0x00FC)            snprintf(out, size, "SCL");
+            else if (opcode == 0x00FD)            snprintf(out, size, "EXIT");
+            else if (opcode == 0x00FE)            snprintf(out, size, "LOW");
+            else if (opcode == 0x00FF)            snprintf(out, size, "HIGH");
+            else                                  snprintf(out, size, "DW 0x%04X", opcode);
+            break;
+        case 0x1: snprintf(out, size, "JP 0x%03X", nnn); break;
+        case 0x2: snprintf(out, size, "CALL 0x%03X", nnn); break;
+        case 0x3: snprintf(out, size, "SE V%X, 0x%02X", x, nn); break;
+        case 0x4: snprintf(out, size, "SNE V%X, 0x%02X", x, nn); break;
+        case 0x5: snprintf(out, size, "SE V%X, V%X", x, y); break;
+        case 0x6: snprintf(out, size, "LD V%X, 0x%02X", x, nn); break;
+        case 0x7: snprintf(out, size, "ADD V%X, 0x%02X", x, nn); break;
+        case 0x8:
+            if (alu[n] == nullptr)
+                snprintf(out, size, "DW 0x%04X", opcode);
+            else
+                snprintf(out, size, "%s V%X, V%X", alu[n], x, y);
+            break;
+        case 0x9: snprintf(out, size, "SNE V%X, V%X", x, y); break;
+        case 0xA: snprintf(out, size, "LD I, 0x%03X", nnn); break;
+        case 0xB: snprintf(out, size, "JP V0, 0x%03X", nnn); break;
+        case 0xC: snprintf(out, size, "RND V%X, 0x%02X", x, nn); break;
+        case 0xD: snprintf(out, size, "DRW V%X, V%X, %u", x, y, n); break;
+        case 0xE:
+            if (nn == 0x9E)      snprintf(out, size, "SKP V%X", x);
+            else if (nn == 0xA1) snprintf(out, size, "SKNP V%X", x);
+            else                 snprintf(out, size, "DW 0x%04X", opcode);
+            break;
+        case 0xF:
+            switch (nn)
+            {
+                case 0x07: snprintf(out, size, "LD V%X, DT", x); break;
+                case 0x0A: snprintf(out, size, "LD V%X, K", x); break;
+                case 0x15: snprintf(out, size, "LD DT, V%X", x); break;
+                case 0x18: snprintf(out, size, "LD ST, V%X", x); break;
+                case 0x1E: snprintf(out, size, "ADD I, V%X", x); break;
+                case 0x29: snprintf(out, size, "LD F, V%X", x); break;
+                case 0x30: snprintf(out, size, "LD HF, V%X", x); break;
+                case 0x33: snprintf(out, size, "LD B, V%X", x); break;
+                case 0x55: snprintf(out, size, "LD [I], V%X", x); break;
+                case 0x65: snprintf(out, size, "LD V%X, [I]", x); break;
+                case 0x75: snprintf(out, size, "LD R, V%X", x); break;
+                case 0x85: snprintf(out, size, "LD V%X, R", x); break;
+                default:   snprintf(out, size, "DW 0x%04X", opcode); break;
+            }
+            break;
+    }
+    return out;
+}
+
+class Chip8Recompiler {
+public:
+
+    static const uint32_t max_block_length = 64;
+
+    struct Edge
+    {
+        uint16_t target;
+        const char* kind;  // "next", "jump", "call", "skip" or "return to"
+    };
+
+    struct Block
+    {
+        uint16_t start;
+        uint16_t end;          // One past the last byte
+        uint32_t length;
+        uint32_t timer_reach;  // As in Chip8AotBlock
+        bool compiled;         // Otherwise step() runs it
+        std::vector<Edge> successors;
+    };
+
+    // memory is a whole 4 KB image, normally Chip8::memory after init() and loadROM()
+    Chip8Recompiler(const uint8_t* memory, QuirkProfile quirks) : quirks(quirks)
+    {
+        memcpy(image, memory, sizeof(image));
+    }
+
+    void analyze(uint16_t entry = 0x200)
+    {
+        memset(reached, 0, sizeof(reached));
+        memset(leader, 0, sizeof(leader));
+        indirect.clear();
+        code_blocks.clear();
+
+        std::vector<uint16_t> work(1, entry);
+        leader[entry] = true;
+        while (!work.empty())
+        {
+            uint16_t pc = work.back();
+            work.pop_back();
+            if (pc > 0xFFE || reached[pc])
+                continue;
+            reached[pc] = true;
+
+            Info info = classify(pc);
+            if (info.indirect)
+                indirect.push_back(pc);
+            bool cut = info.ends || info.excluded;
+            if (info.excluded)
+                leader[pc] = true;
+            for (int i = 0; i < info.successor_count; ++i)
+            {
+                uint16_t target = info.successors[i].target;
+                if (target > 0xFFE)
+                    continue;
+                if (cut)
+                    leader[target] = true;
+                work.push_back(target);
+            }
+        }
+
+        // Cut blocks in address order, a block that gets too long starts a new one
+        std::set<uint16_t> starts;
+        for (uint32_t pc = 0; pc <= 0xFFE; ++pc)
+            if (leader[pc] && reached[pc])
+                starts.insert(static_cast<uint16_t>(pc));
+        for (auto it = starts.begin(); it != starts.end(); ++it)
+        {
+            Block block;
+            block.start = *it;
+            block.length = 0;
+            block.timer_reach = 0;
+            block.compiled = !(block.start & 1) && !classify(block.start).excluded;
+
+            uint16_t pc = block.start;
+            for (;;)
+            {
+                Info info = classify(pc);
+                ++block.length;
+                uint16_t op = read(pc);
+                if ((op & 0xF000) == 0xF000 && ((op & 0xFF) == 0x07 || (op & 0xFF) == 0x15 || (op & 0xFF) == 0x18))
+                    block.timer_reach = block.length;
+                if (info.ends || info.excluded)
+                {
+                    block.successors.assign(info.successors, info.successors + info.successor_count);
+                    break;
+                }
+                uint16_t next = pc + 2;
+                if (next > 0xFFE || leader[next] || block.length == max_block_length)
+                {
+                    if (next <= 0xFFE && !leader[next])
+                    {
+                        leader[next] = true;
+                        starts.insert(next);
+                    }
+                    block.successors.push_back({next, "next"});
+                    break;
+                }
+                pc = next;
+            }
+            block.end = pc + 2;
+            code_blocks.push_back(block);
+        }
+    }
+
+    const std::vector<Block> &blocks() const { return code_blocks; }
+
+    // BNNN sites, their targets are only known at run time
+    const std::vector<uint16_t> &indirect_jumps() const { return indirect; }
+
+    size_t instruction_count() const
+    {
+        size_t count = 0;
+        for (bool r : reached)
+            count += r ? 1 : 0;
+        return count;
+    }
+
+    size_t compiled_count() const
+    {
+        size_t count = 0;
+        for (const auto &b : code_blocks)
+            count += b.compiled ? 1 : 0;
+        return count;
+    }
+
+    // Every reached instruction with a header in front of each block
+    void write_listing(FILE* out) const
+    {
+        char text[32];
+        size_t next_block = 0;
+        for (uint32_t pc = 0; pc <= 0xFFE; ++pc)
+        {
+            while (next_block < code_blocks.size() && code_blocks[next_block].start < pc)
+                ++next_block;
+            if (next_block < code_blocks.size() && code_blocks[next_block].start == pc)
+            {
+                const Block &b = code_blocks[next_block];
+                fprintf(out, "\n; 0x%03X, %u instruction%s%s", b.start, b.length, b.length == 1 ? "" : "s",
+                        b.compiled ? "" : ", interpreted");
+                for (const auto &e : b.successors)
+                    fprintf(out, ", %s 0x%03X", e.kind, e.target);
+                fputc('\n', out);
+            }
+            if (!reached[pc])
+                continue;
+            uint16_t op = read(static_cast<uint16_t>(pc));
+            fprintf(out, "0x%03X  %04X  %s\n", pc, op, chip8_disassemble(op, text, sizeof(text)));
+        }
+        for (uint16_t pc : indirect)
+            fprintf(out, "\n; 0x%03X jumps through a register, its targets weren't followed", pc);
+        if (!indirect.empty())
+            fputc('\n', out);
+    }
+
+    // Graphviz, one node per block holding its disassembly
+    void write_dot(FILE* out) const
+    {
+        char text[32];
+        fprintf(out, "digraph chip8 {\n    node [shape=box, fontname=\"monospace\"];\n");
+        for (const auto &b : code_blocks)
+        {
+            fprintf(out, "    b%03X [label=\"", b.start);
+            for (uint16_t pc = b.start; pc < b.end; pc += 2)
+                fprintf(out, "%03X  %s\\l", pc, chip8_disassemble(read(pc), text, sizeof(text)));
+            fprintf(out, "\"%s];\n", b.compiled ? "" : ", style=dashed");
+        }
+        for (const auto &b : code_blocks)
+            for (const auto &e : b.successors)
+                if (e.target <= 0xFFE && reached[e.target])
+                    fprintf(out, "    b%03X -> b%03X [label=\"%s\"];\n", b.start, block_containing(e.target), e.kind);
+        for (uint16_t pc : indirect)
+            fprintf(out, "    b%03X -> indirect;\n", block_containing(pc));
+        if (!indirect.empty())
+            fprintf(out, "    indirect [shape=ellipse, label=\"BNNN\"];\n");
+        fprintf(out, "}\n");
+    }
+
+    // A translation unit defining the Chip8AotProgram name, include it after aot.cpp
+    void write_cpp(FILE* out, const char* name, const char* source) const
+    {
+        uint16_t image_start = 0xFFF, image_end = 0;
+        uint64_t code_pages = 0;
+        for (const auto &b : code_blocks)
+        {
+            if (!b.compiled)
+                continue;
+            image_start = b.start < image_start ? b.start : image_start;
+            image_end = b.end > image_end ? b.end : image_end;
+            for (uint32_t page = b.start >> 6; page <= static_cast<uint32_t>(b.end - 1) >> 6; ++page)
+                code_pages |= 1ull << page;
+        }
+        if (image_end == 0)
+            image_start = 0;
+
+        fprintf(out, "// Generated by recompile from %s with %s quirks, don't edit.\n", source, quirk_profile_name(quirks));
+        fprintf(out, "// %zu reached instructions, %zu compiled blocks, %zu indirect jumps.\n\n",
+                instruction_count(), compiled_count(), indirect.size());
+        fprintf(out, "#pragma once\n\n#include \"aot.cpp\"\n\nnamespace %s_blocks {\n\n", name);
+        fprintf(out, "typedef %s Q;\nstatic const uint64_t code_pages = 0x%016llXull;\n\n",
+                quirks_type(), static_cast<unsigned long long>(code_pages));
+
+        fprintf(out, "static const uint8_t image[] = {");
+        for (uint32_t a = image_start; a < image_end; ++a)
+            fprintf(out, "%s0x%02X,", (a - image_start) % 16 == 0 ? "\n    " : " ", image[a]);
+        fprintf(out, "\n};\n");
+
+        for (const auto &b : code_blocks)
+            if (b.compiled)
+                write_block(out, b);
+
+        fprintf(out, "\nstatic const Chip8AotBlock blocks[] = {\n");
+        for (const auto &b : code_blocks)
+            if (b.compiled)
+                fprintf(out, "    {&block_%03X, 0x%03X, 0x%03X, %u, %u},\n", b.start, b.start, b.end, b.length, b.timer_reach);
+        fprintf(out, "};\n\n} // namespace %s_blocks\n\n", name);
+
+        fprintf(out, "static const Chip8AotProgram %s = {\n", name);
+        fprintf(out, "    QuirkProfile::%s, %s_blocks::blocks, sizeof(%s_blocks::blocks) / sizeof(Chip8AotBlock),\n",
+                quirks_enum(), name, name);
+        fprintf(out, "    %s_blocks::image, 0x%03X, 0x%03X, %s_blocks::code_pages\n};\n", name, image_start, image_end, name);
+    }
+
+private:
+
+    struct Info
+    {
+        bool ends = false;      // No fallthrough into the next instruction's block
+        bool excluded = false;  // Left to step()
+        bool indirect = false;
+        int successor_count = 0;
+        Edge successors[2];
+
+        void add(uint16_t target, const char* kind) { successors[successor_count++] = {target, kind}; }
+    };
+
+    QuirkProfile quirks;
+    uint8_t image[4096];
+    bool reached[4096];
+    bool leader[4096];
+    std::vector<uint16_t> indirect;
+    std::vector<Block> code_blocks;
+
+    uint16_t read(uint16_t pc) const { return static_cast<uint16_t>(image[pc]) << 8 | image[pc + 1]; }
+
+    Info classify(uint16_t pc) const
+    {
+        Info info;
+        uint16_t op = read(pc);
+        uint16_t nnn = op & 0xFFF;
+        uint16_t next = pc + 2;
+
+        if (Chip8::decode(op, false, quirks).handler == &Chip8::op_unknown || op == 0x0000)
+        {
+            info.excluded = true;  // Faults, or spins in place on empty memory
+            return info;
+        }
+        switch (op >> 12)
+        {
+            case 0x0:
+                if (op == 0x00EE || op == 0x00FD)
+                {
+                    info.ends = true;
+                    return info;
+                }
+                break;
+            case 0x1:
+                info.ends = true;
+                info.excluded = nnn == pc;  // Idle loop
+                info.add(nnn, "jump");
+                return info;
+            case 0x2:
+                info.ends = true;
+                info.add(nnn, "call");
+                info.add(next, "return to");
+                return info;
+            case 0x3: case 0x4: case 0x5: case 0x9: case 0xE:
+                info.ends = true;
+                info.add(next, "next");
+                info.add(pc + 4, "skip");
+                return info;
+            case 0xB:
+                info.ends = true;
+                info.indirect = true;
+                return info;
+            case 0xF:
+                if ((op & 0xFF) == 0x0A)
+                    info.excluded = true;
+                else if ((op & 0xFF) == 0x07 && delay_poll(pc))
+                    info.excluded = true;
+                break;
+        }
+        info.add(next, "next");
+        return info;
+    }
+
+    // Same pattern as Chip8::at_delay_poll(), for the FX07 itself
+    bool delay_poll(uint16_t pc) const
+    {
+        if (pc > 0xFFA)
+            return false;
+        uint16_t x = read(pc) & 0x0F00;
+        return read(pc + 2) == (0x3000 | x) && read(pc + 4) == (0x1000 | pc);
+    }
+
+    uint16_t block_containing(uint16_t pc) const
+    {
+        for (const auto &b : code_blocks)
+            if (pc >= b.start && pc < b.end && ((pc - b.start) & 1) == 0)
+                return b.start;
+        return pc;
+    }
+
+    const char* quirks_type() const
+    {
+        switch (quirks)
+        {
+            case QuirkProfile::CosmacVip: return "CosmacVipQuirks";
+            case QuirkProfile::SuperChip: return "SuperChipQuirks";
+            case QuirkProfile::XoChip:    return "XoChipQuirks";
+            default:                      return "OriginalQuirks";
+        }
+    }
+
+    const char* quirks_enum() const
+    {
+        switch (quirks)
+        {
+            case QuirkProfile::CosmacVip: return "CosmacVip";
+            case QuirkProfile::SuperChip: return "SuperChip";
+            case QuirkProfile::XoChip:    return "XoChip";
+            default:                      return "Original";
+        }
+    }
+
+    // Leaves the block the way step() would after its k-th instruction
+    static void write_exit(FILE* out, const char* indent, const std::string &pc, uint16_t opcode, uint32_t k)
+    {
+        if (!pc.empty())
+            fprintf(out, "%sc.program_counter = %s;\n", indent, pc.c_str());
+        fprintf(out, "%sc.current_opcode = 0x%04X;\n%sc.advance_cycles(%u);\n%sreturn %u;\n",
+                indent, opcode, indent, k, indent, k);
+    }
+
+    void write_block(FILE* out, const Block &b) const
+    {
+        char text[32], pc_text[16];
+        QuirkFlags q = quirk_flags(quirks);
+
+        // Operands for the handlers called from this block
+        fputc('\n', out);
+        for (uint16_t pc = b.start; pc < b.end; pc += 2)
+        {
+            uint16_t op = read(pc);
+            if (!inline_op(op))
+                fprintf(out, "static const Chip8::DecodedOp op_%03X = {nullptr, 0x%04X, 0x%03X, 0x%X, 0x%X, 0x%X, 0x%02X};\n",
+                        pc, op, op & 0xFFF, (op >> 8) & 0xF, (op >> 4) & 0xF, op & 0xF, op & 0xFF);
+        }
+
+        bool uses_v = false;
+        for (uint16_t pc = b.start; pc < b.end; pc += 2)
+        {
+            uint16_t op = read(pc);
+            bool same_registers = ((op >> 8) & 0xF) == ((op >> 4) & 0xF);
+            switch (op >> 12)
+            {
+                case 0x1: case 0xA: break;
+                case 0x5: case 0x9: uses_v |= !same_registers; break;
+                default:            uses_v |= inline_op(op); break;
+            }
+        }
+        fprintf(out, "\nstatic uint32_t block_%03X(Chip8 &c)\n{\n", b.start);
+        if (uses_v)
+            fprintf(out, "    uint8_t* v = c.registers;\n");
+        uint32_t k = 0;
+        for (uint16_t pc = b.start; pc < b.end; pc += 2)
+        {
+            ++k;
+            uint16_t op = read(pc);
+            unsigned x = (op >> 8) & 0xF, y = (op >> 4) & 0xF, n = op & 0xF, nn = op & 0xFF, nnn = op & 0xFFF;
+            bool last = pc + 2 >= b.end;
+            snprintf(pc_text, sizeof(pc_text), "0x%03X", pc + 2);
+            std::string next = pc_text;
+            fprintf(out, "    // %03X  %04X  %s\n", pc, op, chip8_disassemble(op, text, sizeof(text)));
+
+            switch (op >> 12)
+            {
+                case 0x0:
+                    if (op == 0x00EE || op == 0x00FD)
+                    {
+                        fprintf(out, "    c.program_counter = 0x%03X;\n    Chip8::op_%04X(c, op_%03X);\n", pc, op, pc);
+                        write_exit(out, "    ", "", op, k);
+                        break;
+                    }
+                    if (op == 0x00FE || op == 0x00FF)
+                        fprintf(out, "    Chip8::op_%04X(c, op_%03X);\n", op, pc);
+                    else
+                    {
+                        const char* handler = (op & 0xFFF0) == 0x00C0 ? "00CN" : op == 0x00E0 ? "00E0" : op == 0x00FB ? "00FB" : "00FC";
+                        fprintf(out, "    if (c.extendedScreenMode) Chip8::op_%s<true>(c, op_%03X); else Chip8::op_%s<false>(c, op_%03X);\n",
+                                handler, pc, handler, pc);
+                    }
+                    break;
+                case 0x1:
+                    snprintf(pc_text, sizeof(pc_text), "0x%03X", nnn);
+                    write_exit(out, "    ", pc_text, op, k);
+                    break;
+                case 0x2:
+                    fprintf(out, "    c.program_counter = 0x%03X;\n    Chip8::op_2NNN(c, op_%03X);\n", pc, pc);
+                    write_exit(out, "    ", "", op, k);
+                    break;
+                case 0x3: case 0x4: case 0x5: case 0x9: case 0xE:
+                {
+                    char condition[48];
+                    switch (op >> 12)
+                    {
+                        case 0x3: snprintf(condition, sizeof(condition), "v[0x%X] == 0x%02X", x, nn); break;
+                        case 0x4: snprintf(condition, sizeof(condition), "v[0x%X] != 0x%02X", x, nn); break;
+                        case 0x5: snprintf(condition, sizeof(condition), x == y ? "true" : "v[0x%X] == v[0x%X]", x, y); break;
+                        case 0x9: snprintf(condition, sizeof(condition), x == y ? "false" : "v[0x%X] != v[0x%X]", x, y); break;
+                        default:
+                            snprintf(condition, sizeof(condition), "c.keys[v[0x%X] & 0xF] %s 0", x, nn == 0x9E ? "!=" : "==");
+                            break;
+                    }
+                    char target[96];
+                    snprintf(target, sizeof(target), "%s ? 0x%03X : 0x%03X", condition, pc + 4, pc + 2);
+                    write_exit(out, "    ", target, op, k);
+                    break;
+                }
+                case 0x6: fprintf(out, "    v[0x%X] = 0x%02X;\n", x, nn); break;
+                case 0x7: fprintf(out, "    v[0x%X] += 0x%02X;\n", x, nn); break;
+                case 0x8:
+                {
+                    unsigned source = q.shift_uses_vy ? y : x;
+                    switch (n)
+                    {
+                        case 0x0: fprintf(out, "    v[0x%X] = v[0x%X];\n", x, y); break;
+                        case 0x1: fprintf(out, "    v[0x%X] |= v[0x%X];\n", x, y); break;
+                        case 0x2: fprintf(out, "    v[0x%X] &= v[0x%X];\n", x, y); break;
+                        case 0x3: fprintf(out, "    v[0x%X] ^= v[0x%X];\n", x, y); break;
+                        case 0x4:
+                            fprintf(out, "    { unsigned sum = v[0x%X] + v[0x%X]; v[0x%X] = static_cast<uint8_t>(sum); v[0xF] = sum > 255u; }\n", x, y, x);
+                            break;
+                        case 0x5: case 0x7:
+                            if (x == y)
+                            {
+                                fprintf(out, "    v[0x%X] = 0; v[0xF] = 1;\n", x);
+                                break;
+                            }
+                            if (n == 0x7)
+                            {
+                                fprintf(out, "    { uint8_t flag = v[0x%X] >= v[0x%X]; v[0x%X] = v[0x%X] - v[0x%X]; v[0xF] = flag; }\n", y, x, x, y, x);
+                                break;
+                            }
+                            fprintf(out, "    { uint8_t flag = v[0x%X] >= v[0x%X]; v[0x%X] -= v[0x%X]; v[0xF] = flag; }\n", x, y, x, y);
+                            break;
+                        case 0x6:
+                            fprintf(out, "    { uint8_t s = v[0x%X]; v[0x%X] = s >> 1; v[0xF] = s & 1; }\n", source, x);
+                            break;
+                        case 0xE:
+                            fprintf(out, "    { uint8_t s = v[0x%X]; v[0x%X] = static_cast<uint8_t>(s << 1); v[0xF] = s >> 7; }\n", source, x);
+                            break;
+                    }
+                    break;
+                }
+                case 0xA: fprintf(out, "    c.index = 0x%03X;\n", nnn); break;
+                case 0xB:
+                {
+                    char target[48];
+                    snprintf(target, sizeof(target), "(v[0x%X] + 0x%03X) & 0xFFF", q.jump_uses_vx ? x : 0, nnn);
+                    write_exit(out, "    ", target, op, k);
+                    break;
+                }
+                case 0xC: fprintf(out, "    v[0x%X] = static_cast<uint8_t>(c.next_random() & 0x%02X);\n", x, nn); break;
+                case 0xD:
+                {
+                    const char* handler = n == 0 ? "DXY0" : "DXYN";
+                    fprintf(out, "    if (c.extendedScreenMode) Chip8::op_%s<true, Q>(c, op_%03X); else Chip8::op_%s<false, Q>(c, op_%03X);\n",
+                            handler, pc, handler, pc);
+                    break;
+                }
+                case 0xF:
+                    switch (nn)
+                    {
+                        case 0x07: fprintf(out, "    v[0x%X] = c.delay_timer;\n", x); break;
+                        case 0x15: fprintf(out, "    c.delay_timer = v[0x%X];\n", x); break;
+                        case 0x18: fprintf(out, "    c.sound_timer = v[0x%X];\n", x); break;
+                        case 0x1E: fprintf(out, "    c.index = static_cast<uint16_t>((c.index + v[0x%X]) & 0xFFF);\n", x); break;
+                        case 0x29: fprintf(out, "    c.index = static_cast<uint16_t>(chip8_font_address + (v[0x%X] & 0xF) * 5);\n", x); break;
+                        case 0x30: fprintf(out, "    c.index = static_cast<uint16_t>(chip48_font_address + (v[0x%X] & 0xF) * 10);\n", x); break;
+                        case 0x55: case 0x65:
+                            fprintf(out, "    Chip8::op_FX%02X<Q>(c, op_%03X);\n", nn, pc);
+                            break;
+                        default:
+                            fprintf(out, "    Chip8::op_FX%02X(c, op_%03X);\n", nn, pc);
+                            break;
+                    }
+                    // Stop after writing over compiled code, it may have changed what comes next
+                    if ((nn == 0x33 || nn == 0x55) && !last)
+                    {
+                        fprintf(out, "    if (c.code_dirty_pages & code_pages)\n    {\n");
+                        write_exit(out, "        ", next, op, k);
+                        fprintf(out, "    }\n");
+                    }
+                    break;
+            }
+
+            if (last && !ends(op))
+                write_exit(out, "    ", next, op, k);
+        }
+        fprintf(out, "}\n");
+    }
+
+    // Written out in full rather than through a handler
+    static bool inline_op(uint16_t op)
+    {
+        switch (op >> 12)
+        {
+            case 0x0: case 0x2: case 0xD: return false;
+            case 0xF:
+            {
+                uint8_t nn = op & 0xFF;
+                return nn == 0x07 || nn == 0x15 || nn == 0x18 || nn == 0x1E || nn == 0x29 || nn == 0x30;
+            }
+            default: return true;
+        }
+    }
+
+    static bool ends(uint16_t op)
+    {
+        switch (op >> 12)
+        {
+            case 0x0: return op == 0x00EE || op == 0x00FD;
+            case 0x1: case 0x2: case 0x3: case 0x4: case 0x5: case 0x9: case 0xB: case 0xE: return true;
+            default: return false;
+        }
+    }
+};
@@ -0,0 +1,317 @@
+#pragma once
+
+// Regression runs of a ROM corpus against golden display hashes, spread over every core.
+//
+// A manifest has one run per line, blank lines and # comments are skipped:
+//     <rom> frames=N | cycles=N [hash=H] [quirks=profile] [ipf=N] [seed=N] [keys=F:M,F:M...]
+// ROM paths are relative to the manifest. A run is N frames or N instructions on a fresh
+// machine with ipf instructions per frame (10 by default). keys holds the keypad as mask M
+// (bit i for key i) from the start of frame F until the next change. hash is the golden
+// chip8_display_hash() of the display at the end, in hex. A run without one still runs and
+// reports its hash, for writing the goldens of new ROMs.
+//
+// Each run gets its own Chip8 on a Chip8WorkPool thread. Runs are dealt out to per-thread
+// queues longest first, and a thread that runs out takes from the back of someone else's
+// queue, so a few long ROMs don't leave the other cores idle at the end.
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cpu.cpp"
+#include "jit.cpp"
+#include "movie.cpp"
+#include "rompack.cpp"
+
+// FNV-1a over the display mode and the active display's rows, leftmost pixel in the top bit
+// of each row's first byte, so the value is the same on every host
+inline uint64_t chip8_display_hash(const Chip8 &cpu)
+{
+    uint8_t bytes[1 + 64 * 16];
+    size_t size = 0;
+    bytes[size++] = cpu.extendedScreenMode ? 1 : 0;
+    const uint64_t* words = cpu.extendedScreenMode ? &cpu.graphics_extended[0][0] : cpu.graphics;
+    size_t count = cpu.extendedScreenMode ? 128 : 32;
+    for (size_t w = 0; w < count; ++w)
+        for (int b = 0; b < 8; ++b)
+            bytes[size++] = static_cast<uint8_t>(words[w] >> (56 - 8 * b));
+    return chip8_rom_hash(bytes, size);
+}
+
+struct Chip8RegressionKeys
+{
+    uint64_t frame;
+    uint16_t mask;
+};
+
+struct Chip8RegressionEntry
+{
+    int line_number = 0;
+    std::string rom;       // Resolved against the manifest
+    bool by_frames = true;
+    uint64_t length = 0;   // Frames or instructions
+    QuirkProfile quirks = QuirkProfile::Original;
+    uint32_t ipf = 10;
+    uint32_t seed = 0;
+    std::vector<Chip8RegressionKeys> keys;  // By frame
+    bool have_hash = false;
+    uint64_t hash = 0;
+};
+
+enum class Chip8Verdict { Pass, Mismatch, NoGolden, Fault, Unreadable };
+
+inline const char* chip8_verdict_name(Chip8Verdict verdict)
+{
+    switch (verdict)
+    {
+        case Chip8Verdict::Pass:       return "PASS";
+        case Chip8Verdict::Mismatch:   return "FAIL";
+        case Chip8Verdict::NoGolden:   return "NEW";
+        case Chip8Verdict::Fault:      return "FAULT";
+        case Chip8Verdict::Unreadable: return "NOROM";
+    }
+    return "?";
+}
+
+struct Chip8RegressionResult
+{
+    Chip8Verdict verdict = Chip8Verdict::Unreadable;
+    StopReason stop = StopReason::None;
+    const char* fault_message = nullptr;
+    uint16_t program_counter = 0;
+    uint64_t hash = 0;
+    uint64_t instructions = 0;
+    uint64_t frames = 0;
+    double seconds = 0;
+};
+
+// Reads every entry, false with error set to the first line it can't make sense of
+inline bool parse_chip8_manifest(const char* filename, std::vector<Chip8RegressionEntry> &entries, std::string &error)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        error = std::string("Could not open manifest: ") + filename;
+        return false;
+    }
+    std::string directory = filename;
+    size_t slash = directory.rfind('/');
+    directory = slash == std::string::npos ? "" : directory.substr(0, slash + 1);
+
+    std::string line;
+    for (int number = 1; std::getline(file, line); ++number)
+    {
+        std::istringstream words(line);
+        std::string word;
+        if (!(words >> word) || word[0] == '#')
+            continue;
+
+        Chip8RegressionEntry entry;
+        entry.line_number = number;
+        entry.rom = word[0] == '/' ? word : directory + word;
+        bool have_length = false;
+        auto fail = [&](const std::string &why) {
+            error = std::string(filename) + ":" + std::to_string(number) + ": " + why;
+            return false;
+        };
+
+        while (words >> word)
+        {
+            size_t equals = word.find('=');
+            if (equals == std::string::npos)
+                return fail("expected key=value, got " + word);
+            std::string key = word.substr(0, equals);
+            std::string value = word.substr(equals + 1);
+            char* end = nullptr;
+            if (key == "frames" || key == "cycles")
+            {
+                entry.by_frames = key == "frames";
+                entry.length = strtoull(value.c_str(), &end, 10);
+                have_length = true;
+            }
+            else if (key == "hash")
+            {
+                if (value.size() > 16)
+                    return fail("hash is 64 bits, got " + value);
+                entry.hash = strtoull(value.c_str(), &end, 16);
+                entry.have_hash = true;
+            }
+            else if (key == "ipf")
+                entry.ipf = static_cast<uint32_t>(strtoul(value.c_str(), &end, 10));
+            else if (key == "seed")
+                entry.seed = static_cast<uint32_t>(strtoul(value.c_str(), &end, 10));
+            else if (key == "quirks")
+            {
+                if (!parse_quirk_profile(value.c_str(), entry.quirks))
+                    return fail("unknown quirk profile " + value);
+                continue;
+            }
+            else if (key == "keys")
+            {
+                std::istringstream changes(value);
+                std::string change;
+                while (std::getline(changes, change, ','))
+                {
+                    Chip8RegressionKeys keys;
+                    keys.frame = strtoull(change.c_str(), &end, 10);
+                    if (*end != ':')
+                        return fail("keys are frame:mask, got " + change);
+                    keys.mask = static_cast<uint16_t>(strtoul(end + 1, &end, 0));
+                    if (*end != '\0' || (!entry.keys.empty() && keys.frame < entry.keys.back().frame))
+                        return fail("keys have to be frame:mask in frame order, got " + change);
+                    entry.keys.push_back(keys);
+                }
+                continue;
+            }
+            else
+                return fail("unknown key " + key);
+
+            if (value.empty() || *end != '\0')
+                return fail("bad number in " + word);
+        }
+        if (!have_length)
+            return fail("needs frames=N or cycles=N");
+        if (entry.ipf == 0)
+            return fail("ipf has to be at least 1");
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+// One entry on a fresh machine, frame by frame so the keys change on frame boundaries
+inline Chip8RegressionResult run_chip8_regression(const Chip8RegressionEntry &entry, bool use_jit = false)
+{
+    Chip8RegressionResult result;
+    std::vector<uint8_t> rom;
+    {
+        std::ifstream file(entry.rom, std::ios::binary);
+        if (!file.is_open())
+            return result;
+        rom.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    Chip8 cpu(entry.quirks);
+    cpu.init();
+    cpu.seed_random(entry.seed);
+    cpu.cycles_per_frame = entry.ipf;
+    if (!loadROM(rom.data(), rom.size(), cpu))
+        return result;
+    std::unique_ptr<Chip8Jit> jit;
+    if (use_jit)
+        jit.reset(new Chip8Jit(cpu));
+
+    auto start = std::chrono::steady_clock::now();
+    size_t next_keys = 0;
+    StopReason reason = StopReason::None;
+    while (entry.by_frames ? cpu.frame_count < entry.length : cpu.cycle_count < entry.length)
+    {
+        while (next_keys < entry.keys.size() && entry.keys[next_keys].frame <= cpu.frame_count)
+            chip8_set_key_mask(cpu, entry.keys[next_keys++].mask);
+
+        uint64_t rest = cpu.cycles_per_frame - cpu.cycles_into_frame;
+        if (entry.by_frames || rest <= entry.length - cpu.cycle_count)
+            reason = jit ? cpu.run_frame_on(*jit) : cpu.run_frame();
+        else
+        {
+            // A cycles= run ending partway through a frame, any wait lasts to the end of the run
+            uint64_t end = entry.length;
+            reason = jit ? jit->run_cycles(end - cpu.cycle_count) : cpu.run_cycles(end - cpu.cycle_count);
+            if (reason == StopReason::WaitingForKey)
+                cpu.advance_cycles(end - cpu.cycle_count);
+        }
+        if (reason == StopReason::Halted || reason == StopReason::Fault)
+            break;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    result.stop = reason;
+    result.fault_message = cpu.fault_message;
+    result.program_counter = cpu.program_counter;
+    result.hash = chip8_display_hash(cpu);
+    result.instructions = cpu.cycle_count;
+    result.frames = cpu.frame_count;
+    if (reason == StopReason::Fault)
+        result.verdict = Chip8Verdict::Fault;
+    else if (!entry.have_hash)
+        result.verdict = Chip8Verdict::NoGolden;
+    else
+        result.verdict = result.hash == entry.hash ? Chip8Verdict::Pass : Chip8Verdict::Mismatch;
+    return result;
+}
+
+// Runs a batch of independent tasks on every core with work stealing
+class Chip8WorkPool {
+public:
+
+    explicit Chip8WorkPool(size_t threads = 0)
+        : thread_count(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    size_t threads() const { return thread_count; }
+
+    // Calls task(i) once for each i in order, from any thread, and returns when all are done.
+    // Put the longest tasks first: each thread starts at the front of its share and thieves
+    // take from the back of someone else's.
+    void run(const std::vector<size_t> &order, const std::function<void(size_t)> &task)
+    {
+        size_t count = std::min(thread_count, std::max<size_t>(order.size(), 1));
+        std::vector<Queue> queues(count);
+        for (size_t k = 0; k < order.size(); ++k)
+            queues[k % count].tasks.push_back(order[k]);
+
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < count; ++t)
+            workers.emplace_back([&, t] {
+                size_t i;
+                while (take(queues, t, i))
+                    task(i);
+            });
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+private:
+
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+
+    size_t thread_count;
+
+    // Own queue from the front, then the others from the back. Nothing gets queued during a
+    // run, so empty everywhere means done.
+    static bool take(std::vector<Queue> &queues, size_t self, size_t &task)
+    {
+        {
+            std::lock_guard<std::mutex> guard(queues[self].lock);
+            if (!queues[self].tasks.empty())
+            {
+                task = queues[self].tasks.front();
+                queues[self].tasks.pop_front();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues.size(); ++k)
+        {
+            Queue &victim = queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty())
+            {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+};
@@ -0,0 +1,208 @@
+#pragma once
+
+// In-memory rewind history for one Chip8.
+//
+// push() is called once per frame. Every keyframe_interval frames the whole Chip8State is
+// kept, the frames in between only keep the XOR of their state against the previous
+// frame, run-length encoded so unchanged bytes cost nothing. Consecutive frames usually
+// differ in a few registers, a handful of memory bytes and some display rows, so a delta
+// is tens of bytes instead of the 5.5 KB snapshot.
+//
+// XOR deltas undo themselves, so stepping back one frame is applying the newest delta to
+// the current state again. Only stepping back over a keyframe needs a rebuild, from the
+// keyframe before it forward. When the history grows past max_bytes the oldest keyframe
+// and its deltas are dropped together.
+
+#include <deque>
+#include <vector>
+#include <string.h>
+#include "cpu.cpp"
+
+class Chip8Rewind {
+public:
+
+    explicit Chip8Rewind(size_t max_bytes = 16 << 20, uint32_t keyframe_interval = 60)
+        : max_bytes(max_bytes), keyframe_interval(keyframe_interval ? keyframe_interval : 1)
+    {
+    }
+
+    // Records the state of cpu as the newest frame of the history
+    void push(const Chip8 &cpu)
+    {
+        Chip8State next;
+        cpu.save_state(next);
+
+        Entry entry;
+        entry.keyframe = entries.empty() || ++since_keyframe >= keyframe_interval;
+        if (entry.keyframe)
+        {
+            since_keyframe = 0;
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&next);
+            entry.data.assign(bytes, bytes + sizeof(next));
+        }
+        else
+            encode_delta(current, next, entry.data);
+
+        stored_bytes += entry.data.size();
+        entries.push_back(std::move(entry));
+        current = next;
+
+        drop_oldest();
+    }
+
+    // Restores cpu to the frame before the newest one and forgets the newest,
+    // returns false when there is nothing older to go back to
+    bool step_back(Chip8 &cpu)
+    {
+        if (entries.size() < 2)
+            return false;
+
+        Entry &newest = entries.back();
+        if (newest.keyframe)
+        {
+            stored_bytes -= newest.data.size();
+            entries.pop_back();
+            rebuild_current();
+        }
+        else
+        {
+            apply_delta(current, newest.data);
+            stored_bytes -= newest.data.size();
+            entries.pop_back();
+            --since_keyframe;
+        }
+
+        cpu.load_state(current);
+        return true;
+    }
+
+    size_t frames() const { return entries.size(); }
+    size_t bytes() const { return stored_bytes; }
+
+    void clear()
+    {
+        entries.clear();
+        stored_bytes = 0;
+        since_keyframe = 0;
+    }
+
+private:
+
+    struct Entry
+    {
+        bool keyframe = false;
+        std::vector<uint8_t> data;  // Full Chip8State for keyframes, encoded XOR delta otherwise
+    };
+
+    size_t max_bytes;
+    uint32_t keyframe_interval;
+    uint32_t since_keyframe = 0;  // Deltas pushed since the newest keyframe
+    size_t stored_bytes = 0;
+    std::deque<Entry> entries;
+    Chip8State current;           // State of the newest entry
+
+    // Drops whole keyframe groups from the front while over budget, always keeping the newest group
+    void drop_oldest()
+    {
+        while (stored_bytes > max_bytes)
+        {
+            size_t next_keyframe = 1;
+            while (next_keyframe < entries.size() && !entries[next_keyframe].keyframe)
+                ++next_keyframe;
+            if (next_keyframe == entries.size())
+                return;
+            for (size_t i = 0; i < next_keyframe; ++i)
+                stored_bytes -= entries[i].data.size();
+            entries.erase(entries.begin(), entries.begin() + next_keyframe);
+        }
+    }
+
+    // Replays from the last keyframe forward to get the state of the newest entry
+    void rebuild_current()
+    {
+        size_t key = entries.size() - 1;
+        while (!entries[key].keyframe)
+            --key;
+
+        memcpy(&current, entries[key].data.data(), sizeof(current));
+        for (size_t i = key + 1; i < entries.size(); ++i)
+            apply_delta(current, entries[i].data);
+        since_keyframe = static_cast<uint32_t>(entries.size() - 1 - key);
+    }
+
+    static void put_varint(std::vector<uint8_t> &out, size_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static size_t get_varint(const uint8_t* &in)
+    {
+        size_t value = 0;
+        for (int shift = 0; ; shift += 7)
+        {
+            uint8_t b = *in++;
+            value |= static_cast<size_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return value;
+        }
+    }
+
+    // Delta is a list of (equal byte count, changed byte count, XORed changed bytes),
+    // trailing equal bytes are implied. Short equal stretches stay inside the literal
+    // since a new pair costs more than the bytes it would skip.
+    static void encode_delta(const Chip8State &from, const Chip8State &to, std::vector<uint8_t> &out)
+    {
+        const uint8_t* a = reinterpret_cast<const uint8_t*>(&from);
+        const uint8_t* b = reinterpret_cast<const uint8_t*>(&to);
+        const size_t size = sizeof(Chip8State);
+
+        size_t i = 0;
+        while (i < size)
+        {
+            size_t start = i;
+            // Skip equal bytes a word at a time where we can
+            while (i + 8 <= size && memcmp(a + i, b + i, 8) == 0)
+                i += 8;
+            while (i < size && a[i] == b[i])
+                ++i;
+            if (i == size)
+                break;
+
+            size_t literal = i;
+            size_t equal_run = 0;
+            while (i < size && equal_run < 4)
+            {
+                equal_run = a[i] == b[i] ? equal_run + 1 : 0;
+                ++i;
+            }
+            size_t literal_end = i - equal_run;
+
+            put_varint(out, literal - start);
+            put_varint(out, literal_end - literal);
+            for (size_t j = literal; j < literal_end; ++j)
+                out.push_back(a[j] ^ b[j]);
+            i = literal_end;
+        }
+    }
+
+    static void apply_delta(Chip8State &state, const std::vector<uint8_t> &delta)
+    {
+        uint8_t* bytes = reinterpret_cast<uint8_t*>(&state);
+        const uint8_t* in = delta.data();
+        const uint8_t* end = in + delta.size();
+        size_t pos = 0;
+
+        while (in < end)
+        {
+            pos += get_varint(in);
+            size_t literal = get_varint(in);
+            for (size_t j = 0; j < literal; ++j)
+                bytes[pos++] ^= *in++;
+        }
+    }
+};
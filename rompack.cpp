@@ -0,0 +1,298 @@
+#pragma once
+
+// ROM packs. One file holds many ROMs with their names, sizes and hashes, so a corpus run
+// opens and maps a single file instead of thousands of tiny ones. Chip8RomPack maps the
+// pack read-only and checks every entry once in open(). After that rom() hands out
+// pointers straight into the mapping, and load() copies one into a machine through the
+// same bounds checks as loadROM(). Entries are sorted by name, so find() is a binary search.
+//
+// File layout, host byte order:
+//   header    "C8PK", u32 version, u32 count, u32 names_size
+//   entries   count * Chip8RomPackEntry
+//   names     names_size bytes, not NUL terminated
+//   data      ROM images, each entry says where
+// Hashes are 64-bit FNV-1a over the ROM bytes.
+
+#include <algorithm>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "cpu.cpp"
+
+#if !defined(_WIN32)
+#define CHIP8_ROM_PACK_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const uint32_t chip8_rom_pack_version = 1;
+
+struct Chip8RomPackEntry
+{
+    uint64_t hash;
+    uint64_t offset;       // From the start of the file
+    uint32_t size;
+    uint32_t name_offset;  // Into the names block
+    uint32_t name_length;
+    uint32_t reserved;
+};
+
+inline uint64_t chip8_rom_hash(const uint8_t* data, size_t size)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+class Chip8RomPack {
+public:
+
+    Chip8RomPack() {}
+    ~Chip8RomPack() { close(); }
+
+    Chip8RomPack(const Chip8RomPack &) = delete;
+    Chip8RomPack &operator=(const Chip8RomPack &) = delete;
+
+    // Maps the pack and validates the header and every entry, hashes too unless told not to
+    bool open(const char* filename, bool check_hashes = true)
+    {
+        close();
+#ifdef CHIP8_ROM_PACK_MMAP
+        int fd = ::open(filename, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED)
+            return false;
+        base = static_cast<const uint8_t*>(mapped);
+        length = static_cast<size_t>(info.st_size);
+#else
+        // No mmap, read the whole pack in one go instead
+        FILE* file = fopen(filename, "rb");
+        if (file == nullptr)
+            return false;
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (size > 0)
+        {
+            fallback.resize(static_cast<size_t>(size));
+            fallback.resize(fread(fallback.data(), 1, fallback.size(), file));
+        }
+        fclose(file);
+        base = fallback.data();
+        length = fallback.size();
+#endif
+        if (!validate(check_hashes))
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+#ifdef CHIP8_ROM_PACK_MMAP
+        if (base != nullptr)
+            munmap(const_cast<uint8_t*>(base), length);
+#else
+        fallback.clear();
+#endif
+        base = nullptr;
+        length = 0;
+        entries = nullptr;
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+
+    std::string name(size_t i) const
+    {
+        return std::string(reinterpret_cast<const char*>(names + entries[i].name_offset), entries[i].name_length);
+    }
+
+    uint64_t hash(size_t i) const { return entries[i].hash; }
+
+    // Read-only view into the mapping, valid until close()
+    const uint8_t* rom(size_t i, size_t &rom_size) const
+    {
+        rom_size = entries[i].size;
+        return base + entries[i].offset;
+    }
+
+    // Index of the ROM with that name, or size() when there is none
+    size_t find(const char* rom_name) const
+    {
+        size_t wanted = strlen(rom_name);
+        size_t lo = 0, hi = count;
+        while (lo < hi)
+        {
+            size_t mid = (lo + hi) / 2;
+            if (compare_name(mid, rom_name, wanted) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo < count && compare_name(lo, rom_name, wanted) == 0 ? lo : count;
+    }
+
+    // Copies ROM i to 0x200 of cpu, normally right after init()
+    bool load(size_t i, Chip8 &cpu) const
+    {
+        if (i >= count)
+            return false;
+        size_t rom_size;
+        const uint8_t* data = rom(i, rom_size);
+        return loadROM(data, rom_size, cpu);
+    }
+
+private:
+
+    const uint8_t* base = nullptr;
+    size_t length = 0;
+    const Chip8RomPackEntry* entries = nullptr;
+    const uint8_t* names = nullptr;
+    size_t count = 0;
+#ifndef CHIP8_ROM_PACK_MMAP
+    std::vector<uint8_t> fallback;
+#endif
+
+    static const size_t header_size = 16;
+
+    bool validate(bool check_hashes)
+    {
+        if (length < header_size || memcmp(base, "C8PK", 4) != 0)
+            return false;
+        uint32_t header[3];
+        memcpy(header, base + 4, sizeof(header));
+        uint32_t version = header[0], entry_count = header[1], names_size = header[2];
+        if (version != chip8_rom_pack_version)
+            return false;
+
+        uint64_t names_start = header_size + static_cast<uint64_t>(entry_count) * sizeof(Chip8RomPackEntry);
+        if (names_start + names_size > length)
+            return false;
+        entries = reinterpret_cast<const Chip8RomPackEntry*>(base + header_size);
+        names = base + names_start;
+        count = entry_count;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Chip8RomPackEntry &e = entries[i];
+            if (e.size == 0 || e.size > chip8_max_rom_size || e.offset > length || e.size > length - e.offset)
+                return false;
+            if (static_cast<uint64_t>(e.name_offset) + e.name_length > names_size)
+                return false;
+            if (i > 0 && compare_name(i - 1, reinterpret_cast<const char*>(names + e.name_offset), e.name_length) >= 0)
+                return false;
+            if (check_hashes && chip8_rom_hash(base + e.offset, e.size) != e.hash)
+                return false;
+        }
+        return true;
+    }
+
+    int compare_name(size_t i, const char* other, size_t other_length) const
+    {
+        const Chip8RomPackEntry &e = entries[i];
+        int c = memcmp(names + e.name_offset, other, std::min<size_t>(e.name_length, other_length));
+        if (c != 0)
+            return c;
+        return e.name_length < other_length ? -1 : e.name_length > other_length ? 1 : 0;
+    }
+};
+
+// Collects ROMs in memory and writes them out as a pack
+class Chip8RomPackWriter {
+public:
+
+    // False for images that couldn't be loaded into a machine anyway
+    bool add(const std::string &name, const uint8_t* data, size_t size)
+    {
+        if (size == 0 || size > chip8_max_rom_size)
+            return false;
+        roms.push_back({name, std::vector<uint8_t>(data, data + size)});
+        return true;
+    }
+
+    // Adds a ROM file under its name without the directory
+    bool add_file(const char* path)
+    {
+        FILE* file = fopen(path, "rb");
+        if (file == nullptr)
+            return false;
+        std::vector<uint8_t> image(chip8_max_rom_size + 1);
+        size_t size = fread(image.data(), 1, image.size(), file);
+        fclose(file);
+
+        const char* slash = strrchr(path, '/');
+        return add(slash ? slash + 1 : path, image.data(), size);
+    }
+
+    size_t size() const { return roms.size(); }
+
+    // False when two ROMs share a name, or the file can't be written in full
+    bool write(const char* filename)
+    {
+        std::sort(roms.begin(), roms.end(), [](const Rom &a, const Rom &b) { return a.name < b.name; });
+        for (size_t i = 1; i < roms.size(); ++i)
+            if (roms[i].name == roms[i - 1].name)
+                return false;
+
+        std::string names;
+        for (auto &r : roms)
+            names += r.name;
+
+        std::vector<Chip8RomPackEntry> entries(roms.size());
+        uint64_t offset = 16 + entries.size() * sizeof(Chip8RomPackEntry) + names.size();
+        uint32_t name_offset = 0;
+        for (size_t i = 0; i < roms.size(); ++i)
+        {
+            Chip8RomPackEntry &e = entries[i];
+            e.hash = chip8_rom_hash(roms[i].image.data(), roms[i].image.size());
+            e.offset = offset;
+            e.size = static_cast<uint32_t>(roms[i].image.size());
+            e.name_offset = name_offset;
+            e.name_length = static_cast<uint32_t>(roms[i].name.size());
+            e.reserved = 0;
+            offset += e.size;
+            name_offset += e.name_length;
+        }
+
+        FILE* file = fopen(filename, "wb");
+        if (file == nullptr)
+            return false;
+        uint32_t header[3] = {chip8_rom_pack_version, static_cast<uint32_t>(roms.size()), static_cast<uint32_t>(names.size())};
+        bool ok = fwrite("C8PK", 1, 4, file) == 4 && fwrite(header, sizeof(header), 1, file) == 1 &&
+                  fwrite(entries.data(), sizeof(Chip8RomPackEntry), entries.size(), file) == entries.size() &&
+                  fwrite(names.data(), 1, names.size(), file) == names.size();
+        for (size_t i = 0; ok && i < roms.size(); ++i)
+            ok = fwrite(roms[i].image.data(), 1, roms[i].image.size(), file) == roms[i].image.size();
+        return fclose(file) == 0 && ok;
+    }
+
+private:
+
+    struct Rom
+    {
+        std::string name;
+        std::vector<uint8_t> image;
+    };
+
+    std::vector<Rom> roms;
+};
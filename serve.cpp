@@ -0,0 +1,116 @@
+#include <chrono>
+#include <iostream>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include "cpu.cpp"
+#include "movie.cpp"
+#include "stream.cpp"
+
+using namespace std;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void request_stop(int)
+{
+    stop_requested = 1;
+}
+
+// Runs a ROM in real time and streams its display over a Unix domain socket (see stream.cpp).
+// Clients send back key masks, so a dashboard can also play it.
+// Usage: serve [--ips N] [--quirks profile] [--rle] [--frames N] <socket> <rom>
+// Runs until interrupted, or for N frames with --frames.
+int main(int argc, char* argv[])
+{
+    uint32_t ips = 600;
+    uint64_t frame_limit = 0;
+    bool rle = false;
+    QuirkProfile quirks = QuirkProfile::Original;
+    const char* socket_path = nullptr;
+    const char* rom_path = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--ips") == 0 && i + 1 < argc)
+            ips = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frame_limit = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--rle") == 0)
+            rle = true;
+        else if (strcmp(argv[i], "--quirks") == 0 && i + 1 < argc)
+        {
+            if (!parse_quirk_profile(argv[++i], quirks))
+            {
+                cerr << "Unknown quirk profile: " << argv[i] << " (original, vip, schip or xochip)" << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (socket_path == nullptr)
+            socket_path = argv[i];
+        else
+            rom_path = argv[i];
+    }
+
+    if (rom_path == nullptr)
+    {
+        cerr << "Usage: serve [--ips N] [--quirks profile] [--rle] [--frames N] <socket> <rom>" << endl;
+        return EXIT_FAILURE;
+    }
+
+    Chip8 cpu(quirks);
+    cpu.init();
+    cpu.cycles_per_frame = ips >= 60 ? ips / 60 : 1;
+    if (!loadROM(rom_path, cpu))
+    {
+        cerr << "Could not open ROM: " << rom_path << endl;
+        return EXIT_FAILURE;
+    }
+
+    Chip8StreamServer server;
+    server.rle = rle;
+    if (!server.start(socket_path))
+    {
+        cerr << "Could not listen on: " << socket_path << endl;
+        return EXIT_FAILURE;
+    }
+    signal(SIGINT, request_stop);
+    signal(SIGTERM, request_stop);
+    server.publish(cpu);
+
+    // Paced against absolute 60 Hz deadlines, the same as play's emulation thread
+    using frame_clock = chrono::steady_clock;
+    const auto frame_duration = chrono::duration_cast<frame_clock::duration>(chrono::duration<double>(1.0 / 60.0));
+    auto next_frame = frame_clock::now() + frame_duration;
+    uint64_t published_generation = cpu.display_generation;
+    StopReason reason = StopReason::FrameBoundary;
+
+    while (!stop_requested && (frame_limit == 0 || cpu.frame_count < frame_limit))
+    {
+        chip8_set_key_mask(cpu, server.key_mask());
+        reason = cpu.run_frame();
+        if (reason == StopReason::Halted || reason == StopReason::Fault)
+            break;
+
+        if (cpu.display_generation != published_generation)
+        {
+            server.publish(cpu);
+            published_generation = cpu.display_generation;
+        }
+
+        this_thread::sleep_until(next_frame);
+        next_frame += frame_duration;
+        if (frame_clock::now() > next_frame + 5 * frame_duration)
+            next_frame = frame_clock::now() + frame_duration;
+    }
+    server.stop();
+
+    cout << "Stop reason: " << stop_reason_name(reason) << endl;
+    if (reason == StopReason::Fault)
+        cout << "Fault: " << cpu.fault_message << endl;
+    cout << "Frames: " << cpu.frame_count << ", published: " << server.frames_published() << endl;
+    cout << "Clients: " << server.clients_accepted() << endl;
+    cout << "Messages: " << server.messages_sent() << ", bytes: " << server.bytes_sent()
+         << ", frames skipped: " << server.frames_skipped() << endl;
+    return reason == StopReason::Fault ? EXIT_FAILURE : EXIT_SUCCESS;
+}
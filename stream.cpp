@@ -0,0 +1,491 @@
+#pragma once
+
+// Live frames over a Unix domain socket, for dashboards watching running machines.
+//
+// The emulation thread hands changed frames to Chip8StreamServer::publish() through the
+// same triple buffer play draws from, and a server thread does all the socket work, so
+// emulation never waits for a viewer. A client gets a keyframe with every row when it
+// connects and when the display mode changes, and after that only the rows that differ from
+// the last frame it was sent. A client whose socket still holds an earlier message isn't sent
+// anything, and once it drains it gets the difference to the newest frame, so a slow viewer
+// skips frames instead of building up a backlog.
+//
+// Server to client, numbers in host byte order:
+//   u8 flags     1: SUPER-CHIP frame with 64 rows of 16 bytes, 32 rows of 8 otherwise
+//                2: keyframe, every row follows
+//                4: run-length coded rows may follow
+//   u8 rows      rows that follow
+//   u16 size     bytes of rows that follow
+//   u64 frame    frame_count of the machine
+//   rows         u8 index, 0x80 set when the row is run-length coded, then the row as is,
+//                or u8 count, u8 byte pairs until the row is full
+// Rows start with the leftmost pixel in the top bit of their first byte, as in video.cpp.
+//
+// Client to server: u16 key masks, bit i for key i. The keypad is every client's mask ORed.
+
+#include <algorithm>
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "framebuffer.cpp"
+
+static const size_t chip8_stream_header_size = 12;
+
+enum : uint8_t
+{
+    chip8_stream_extended = 1,
+    chip8_stream_keyframe = 2,
+    chip8_stream_rle = 4,
+    chip8_stream_row_rle = 0x80
+};
+
+// Row y of a frame, leftmost pixel in the top bit of the first byte, returns its size
+inline size_t chip8_stream_pack_row(const Chip8Frame &frame, size_t y, uint8_t* out)
+{
+    const uint64_t* words = frame.extended ? frame.graphics_extended[y] : &frame.graphics[y];
+    size_t count = frame.extended ? 2 : 1;
+    for (size_t w = 0; w < count; ++w)
+        for (int b = 0; b < 8; ++b)
+            *out++ = static_cast<uint8_t>(words[w] >> (56 - 8 * b));
+    return count * 8;
+}
+
+class Chip8StreamServer {
+public:
+
+    Chip8StreamServer() = default;
+    ~Chip8StreamServer() { stop(); }
+
+    Chip8StreamServer(const Chip8StreamServer &) = delete;
+    Chip8StreamServer &operator=(const Chip8StreamServer &) = delete;
+
+    // Run-length code rows where that comes out smaller, set before start()
+    bool rle = false;
+
+    // Listens on socket_path, replacing a socket left there by an earlier run
+    bool start(const char* socket_path)
+    {
+        stop();
+        sockaddr_un address = {};
+        if (strlen(socket_path) >= sizeof(address.sun_path))
+            return false;
+        address.sun_family = AF_UNIX;
+        strcpy(address.sun_path, socket_path);
+
+        struct stat existing;
+        if (stat(socket_path, &existing) == 0 && S_ISSOCK(existing.st_mode))
+            unlink(socket_path);
+
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0)
+            return false;
+        if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listener, 16) != 0 || pipe(wake) != 0)
+        {
+            close(listener);
+            listener = -1;
+            return false;
+        }
+        set_nonblocking(listener);
+        set_nonblocking(wake[0]);
+        set_nonblocking(wake[1]);
+
+        path = socket_path;
+        serial = 0;
+        published = 0;
+        keys.store(0);
+        running.store(true);
+        worker = std::thread([this] { serve(); });
+        return true;
+    }
+
+    // Emulation thread, whenever the display changed
+    void publish(const Chip8 &cpu)
+    {
+        if (listener < 0)
+            return;
+        chip8_capture_frame(cpu, frames.back());
+        frames.publish();
+        ++published;
+        poke();
+    }
+
+    // Emulation thread, the keys every client holds down
+    uint16_t key_mask() const { return keys.load(std::memory_order_relaxed); }
+
+    // Disconnects everyone and removes the socket
+    void stop()
+    {
+        if (listener < 0)
+            return;
+        running.store(false);
+        poke();
+        worker.join();
+        for (auto &client : clients)
+            close(client.fd);
+        clients.clear();
+        close(listener);
+        close(wake[0]);
+        close(wake[1]);
+        listener = -1;
+        unlink(path.c_str());
+    }
+
+    uint64_t frames_published() const { return published; }
+
+    // Server thread counts
+    uint64_t clients_accepted() const { return accepted.load(std::memory_order_relaxed); }
+    uint64_t messages_sent() const { return messages.load(std::memory_order_relaxed); }
+    uint64_t bytes_sent() const { return bytes.load(std::memory_order_relaxed); }
+    uint64_t frames_skipped() const { return skipped.load(std::memory_order_relaxed); }
+
+private:
+
+    // A small send buffer, so a slow client is skipped ahead after a few frames rather
+    // than sitting on hundreds of kilobytes of old ones in the kernel
+    static const int send_buffer_size = 8192;
+
+    struct Client
+    {
+        int fd;
+        uint16_t keys = 0;
+        uint8_t key_bytes[2];
+        size_t key_byte_count = 0;
+        uint64_t sent_serial = 0;  // Newest frame it was sent, 0 before its keyframe
+        Chip8Frame sent;
+        std::vector<uint8_t> out;
+        size_t out_offset = 0;
+    };
+
+    int listener = -1;
+    int wake[2] = {-1, -1};
+    std::string path;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    Chip8TripleBuffer<Chip8Frame> frames;
+    uint64_t published = 0;  // Emulation thread only
+
+    alignas(64) std::atomic<uint16_t> keys{0};
+    std::atomic<uint64_t> accepted{0};
+    std::atomic<uint64_t> messages{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> skipped{0};
+
+    // Server thread only
+    std::vector<Client> clients;
+    uint64_t serial = 0;  // Frames taken from the triple buffer
+
+    static void set_nonblocking(int fd)
+    {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    // Wakes the server thread, a full pipe means it's awake anyway
+    void poke()
+    {
+        uint8_t byte = 0;
+        ssize_t written = write(wake[1], &byte, 1);
+        (void)written;
+    }
+
+    void serve()
+    {
+        std::vector<pollfd> fds;
+        while (running.load())
+        {
+            fds.clear();
+            fds.push_back({wake[0], POLLIN, 0});
+            fds.push_back({listener, POLLIN, 0});
+            for (auto &client : clients)
+                fds.push_back({client.fd, static_cast<short>(POLLIN | (client.out.empty() ? 0 : POLLOUT)), 0});
+            if (poll(fds.data(), fds.size(), -1) < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return;
+            }
+
+            uint8_t drain[64];
+            while (read(wake[0], drain, sizeof(drain)) > 0) {}
+            if (frames.acquire())
+                ++serial;
+
+            bool keys_changed = false;
+            for (size_t i = 0; i < clients.size(); ++i)
+            {
+                Client &client = clients[i];
+                bool alive = true;
+                if (fds[i + 2].revents & (POLLIN | POLLHUP | POLLERR))
+                {
+                    uint16_t before = client.keys;
+                    alive = read_keys(client);
+                    keys_changed |= client.keys != before;
+                }
+                if (alive && !client.out.empty())
+                    alive = flush(client);
+                if (alive && client.out.empty() && serial != 0 && client.sent_serial != serial)
+                {
+                    encode(client, frames.front());
+                    alive = flush(client);
+                }
+                if (!alive)
+                {
+                    close(client.fd);
+                    keys_changed |= client.keys != 0;
+                    client.fd = -1;
+                }
+            }
+            size_t before = clients.size();
+            clients.erase(std::remove_if(clients.begin(), clients.end(), [](const Client &c) { return c.fd < 0; }),
+                          clients.end());
+            keys_changed |= clients.size() != before;
+
+            if (fds[1].revents & POLLIN)
+                accept_clients();
+
+            if (keys_changed)
+            {
+                uint16_t mask = 0;
+                for (auto &client : clients)
+                    mask |= client.keys;
+                keys.store(mask, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void accept_clients()
+    {
+        for (;;)
+        {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd < 0)
+                return;
+            set_nonblocking(fd);
+            int buffer_size = send_buffer_size;
+            setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+#ifdef SO_NOSIGPIPE
+            int on = 1;
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+            Client client;
+            client.fd = fd;
+            // Sent right away when there's a frame, otherwise with the first one published
+            if (serial != 0)
+            {
+                encode(client, frames.front());
+                if (!flush(client))
+                {
+                    close(fd);
+                    continue;
+                }
+            }
+            clients.push_back(std::move(client));
+            accepted.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // False once the client hung up
+    bool read_keys(Client &client)
+    {
+        uint8_t buffer[64];
+        for (;;)
+        {
+            ssize_t n = read(client.fd, buffer, sizeof(buffer));
+            if (n == 0)
+                return false;
+            if (n < 0)
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            for (ssize_t i = 0; i < n; ++i)
+            {
+                client.key_bytes[client.key_byte_count++] = buffer[i];
+                if (client.key_byte_count == 2)
+                {
+                    memcpy(&client.keys, client.key_bytes, 2);
+                    client.key_byte_count = 0;
+                }
+            }
+        }
+    }
+
+    // False once the client hung up
+    bool flush(Client &client)
+    {
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;
+#else
+        const int flags = 0;
+#endif
+        while (client.out_offset < client.out.size())
+        {
+            ssize_t n = send(client.fd, client.out.data() + client.out_offset, client.out.size() - client.out_offset, flags);
+            if (n < 0)
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            client.out_offset += n;
+            bytes.fetch_add(n, std::memory_order_relaxed);
+        }
+        client.out.clear();
+        client.out_offset = 0;
+        return true;
+    }
+
+    // Queues the rows that differ from what the client has, nothing when no row does
+    void encode(Client &client, const Chip8Frame &frame)
+    {
+        bool keyframe = client.sent_serial == 0 || client.sent.extended != frame.extended;
+        if (client.sent_serial != 0)
+            skipped.fetch_add(serial - client.sent_serial - 1, std::memory_order_relaxed);
+        client.sent_serial = serial;
+
+        size_t row_count = frame.extended ? 64 : 32;
+        std::vector<uint8_t> &out = client.out;
+        out.resize(chip8_stream_header_size);
+        uint8_t rows = 0;
+        for (size_t y = 0; y < row_count; ++y)
+        {
+            if (!keyframe && (frame.extended ? memcmp(frame.graphics_extended[y], client.sent.graphics_extended[y], 16) == 0
+                                             : frame.graphics[y] == client.sent.graphics[y]))
+                continue;
+
+            uint8_t row[16];
+            size_t size = chip8_stream_pack_row(frame, y, row);
+            uint8_t coded[32];
+            size_t coded_size = rle ? run_length(row, size, coded) : size;
+            bool use_rle = coded_size < size;
+            out.push_back(static_cast<uint8_t>(y | (use_rle ? chip8_stream_row_rle : 0)));
+            out.insert(out.end(), use_rle ? coded : row, (use_rle ? coded : row) + (use_rle ? coded_size : size));
+            ++rows;
+        }
+
+        if (rows == 0 && !keyframe)
+        {
+            out.clear();  // Drawn and undrawn since, the client is already up to date
+            return;
+        }
+
+        uint16_t size = static_cast<uint16_t>(out.size() - chip8_stream_header_size);
+        out[0] = (frame.extended ? chip8_stream_extended : 0) | (keyframe ? chip8_stream_keyframe : 0) |
+                 (rle ? chip8_stream_rle : 0);
+        out[1] = rows;
+        memcpy(&out[2], &size, sizeof(size));
+        memcpy(&out[4], &frame.frame_count, sizeof(frame.frame_count));
+        client.sent = frame;
+        messages.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static size_t run_length(const uint8_t* row, size_t size, uint8_t* out)
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < size;)
+        {
+            size_t j = i + 1;
+            while (j < size && row[j] == row[i])
+                ++j;
+            out[n++] = static_cast<uint8_t>(j - i);
+            out[n++] = row[i];
+            i = j;
+        }
+        return n;
+    }
+};
+
+// Client side, applies messages from a Chip8StreamServer to a copy of the display
+class Chip8StreamDecoder {
+public:
+
+    Chip8Frame frame = {};
+
+    // Bytes as they come off the socket, returns how many whole messages were applied.
+    // False from ok() afterwards means the stream was malformed.
+    size_t feed(const uint8_t* data, size_t size)
+    {
+        pending.insert(pending.end(), data, data + size);
+        size_t applied = 0;
+        size_t offset = 0;
+        while (valid && pending.size() - offset >= chip8_stream_header_size)
+        {
+            uint16_t body;
+            memcpy(&body, &pending[offset + 2], sizeof(body));
+            if (pending.size() - offset < chip8_stream_header_size + body)
+                break;
+            valid = apply(&pending[offset], chip8_stream_header_size + body);
+            offset += chip8_stream_header_size + body;
+            ++applied;
+        }
+        pending.erase(pending.begin(), pending.begin() + offset);
+        return applied;
+    }
+
+    bool ok() const { return valid; }
+
+private:
+
+    std::vector<uint8_t> pending;
+    bool valid = true;
+
+    bool apply(const uint8_t* message, size_t size)
+    {
+        uint8_t flags = message[0];
+        bool extended = (flags & chip8_stream_extended) != 0;
+        if (!(flags & chip8_stream_keyframe) && extended != frame.extended)
+            return false;
+        if (flags & chip8_stream_keyframe)
+        {
+            memset(frame.graphics, 0, sizeof(frame.graphics));
+            memset(frame.graphics_extended, 0, sizeof(frame.graphics_extended));
+        }
+        frame.extended = extended;
+        memcpy(&frame.frame_count, message + 4, sizeof(frame.frame_count));
+
+        size_t row_size = extended ? 16 : 8;
+        size_t offset = chip8_stream_header_size;
+        for (uint8_t r = 0; r < message[1]; ++r)
+        {
+            if (offset >= size)
+                return false;
+            uint8_t index = message[offset++];
+            size_t y = index & ~chip8_stream_row_rle;
+            if (y >= (extended ? 64u : 32u))
+                return false;
+            uint8_t row[16];
+            size_t filled = 0;
+            if (index & chip8_stream_row_rle)
+            {
+                while (filled < row_size)
+                {
+                    if (offset + 2 > size || message[offset] == 0 || filled + message[offset] > row_size)
+                        return false;
+                    memset(row + filled, message[offset + 1], message[offset]);
+                    filled += message[offset];
+                    offset += 2;
+                }
+            }
+            else
+            {
+                if (offset + row_size > size)
+                    return false;
+                memcpy(row, message + offset, row_size);
+                offset += row_size;
+            }
+
+            uint64_t* words = extended ? frame.graphics_extended[y] : &frame.graphics[y];
+            for (size_t w = 0; w < row_size / 8; ++w)
+            {
+                uint64_t word = 0;
+                for (int b = 0; b < 8; ++b)
+                    word = (word << 8) | row[w * 8 + b];
+                words[w] = word;
+            }
+        }
+        return offset == size;
+    }
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+// Instruction tracing.
+//
+// With a Chip8Trace attached (Chip8::trace), every instruction Chip8::step() executes is
+// pushed as a 32-byte Chip8TraceRecord into a single-producer single-consumer ring. A
+// Chip8TraceWriter thread drains the ring into a file, and tracedump turns the file into
+// text. Nothing is formatted on the emulation thread.
+//
+// Building with -DCHIP8_NO_TRACE compiles the hook out of step() altogether. Otherwise
+// run_cycles() checks Chip8::trace once per call and picks a traced or untraced loop, so an
+// untraced machine pays nothing per instruction. A lone step() still tests it each time.
+//
+// Trace file: "C8TR", u32 version, u32 sizeof(Chip8TraceRecord), then records.
+
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+
+struct Chip8TraceRecord
+{
+    uint64_t cycle;       // Instructions executed before this one
+    uint16_t pc;
+    uint16_t opcode;
+    uint16_t index;       // I after the instruction
+    uint16_t changed;     // Bit r set when Vr changed
+    uint8_t registers[16];  // V0-VF after the instruction, only the changed ones are printed
+};
+
+static const uint32_t chip8_trace_version = 1;
+
+class Chip8Trace {
+public:
+
+    static const size_t capacity = 1 << 16;
+
+    // Producer side. When the ring is full it waits for the writer instead of losing
+    // records, unless drop_when_full is set.
+    void push(const Chip8TraceRecord &record)
+    {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        while (h - tail.load(std::memory_order_acquire) >= capacity)
+        {
+            if (drop_when_full)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::yield();
+        }
+        records[h & (capacity - 1)] = record;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // Consumer side, copies out up to max records and returns how many
+    size_t pop(Chip8TraceRecord* out, size_t max)
+    {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t available = head.load(std::memory_order_acquire) - t;
+        size_t count = available < max ? static_cast<size_t>(available) : max;
+        for (size_t i = 0; i < count; ++i)
+            out[i] = records[(t + i) & (capacity - 1)];
+        tail.store(t + count, std::memory_order_release);
+        return count;
+    }
+
+    bool empty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    uint64_t dropped_records() const { return dropped.load(std::memory_order_relaxed); }
+
+    bool drop_when_full = false;
+
+private:
+
+    // head and tail on their own cache lines so producer and consumer don't share one
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) std::atomic<uint64_t> dropped{0};
+    Chip8TraceRecord records[capacity];
+};
+
+// Background thread writing a Chip8Trace to a file
+class Chip8TraceWriter {
+public:
+
+    ~Chip8TraceWriter() { stop(); }
+
+    bool start(const char* filename, Chip8Trace &source)
+    {
+        stop();
+        file = fopen(filename, "wb");
+        if (file == nullptr)
+            return false;
+
+        uint32_t header[2] = {chip8_trace_version, sizeof(Chip8TraceRecord)};
+        fwrite("C8TR", 1, 4, file);
+        fwrite(header, sizeof(header), 1, file);
+
+        trace = &source;
+        running.store(true);
+        worker = std::thread([this] { drain(); });
+        return true;
+    }
+
+    // Writes out whatever is left in the ring and closes the file
+    void stop()
+    {
+        if (file == nullptr)
+            return;
+        running.store(false);
+        worker.join();
+        fclose(file);
+        file = nullptr;
+    }
+
+private:
+
+    FILE* file = nullptr;
+    Chip8Trace* trace = nullptr;
+    std::atomic<bool> running{false};
+    std::thread worker;
+
+    void drain()
+    {
+        Chip8TraceRecord batch[4096];
+        for (;;)
+        {
+            bool last = !running.load();
+            size_t count;
+            while ((count = trace->pop(batch, 4096)) > 0)
+                fwrite(batch, sizeof(Chip8TraceRecord), count, file);
+            if (last)
+                return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+// One line per record, registers only where they changed
+inline void print_trace_record(FILE* out, const Chip8TraceRecord &record)
+{
+    fprintf(out, "%10llu %03X %04X I=%03X", static_cast<unsigned long long>(record.cycle),
+            record.pc, record.opcode, record.index);
+    for (int r = 0; r < 16; ++r)
+        if (record.changed & (1 << r))
+            fprintf(out, " V%X=%02X", r, record.registers[r]);
+    fputc('\n', out);
+}
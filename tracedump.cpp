@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.cpp"
+
+// Prints a trace written by headless/play --trace as text, one instruction per line.
+// Usage: tracedump <trace> [first] [count]
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: tracedump <trace> [first] [count]\n");
+        return 1;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (in == nullptr)
+    {
+        fprintf(stderr, "Could not open trace: %s\n", argv[1]);
+        return 1;
+    }
+
+    char magic[4];
+    uint32_t header[2];
+    if (fread(magic, 1, 4, in) != 4 || fread(header, sizeof(header), 1, in) != 1 ||
+        memcmp(magic, "C8TR", 4) != 0 || header[0] != chip8_trace_version || header[1] != sizeof(Chip8TraceRecord))
+    {
+        fprintf(stderr, "Not a trace file: %s\n", argv[1]);
+        fclose(in);
+        return 1;
+    }
+
+    unsigned long long first = argc > 2 ? strtoull(argv[2], nullptr, 10) : 0;
+    unsigned long long count = argc > 3 ? strtoull(argv[3], nullptr, 10) : ~0ull;
+    fseek(in, static_cast<long>(first * sizeof(Chip8TraceRecord)), SEEK_CUR);
+
+    Chip8TraceRecord batch[4096];
+    size_t got;
+    while (count > 0 && (got = fread(batch, sizeof(Chip8TraceRecord), 4096, in)) > 0)
+    {
+        for (size_t i = 0; i < got && count > 0; ++i, --count)
+            print_trace_record(stdout, batch[i]);
+    }
+
+    fclose(in);
+    return 0;
+}
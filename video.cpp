@@ -0,0 +1,275 @@
+#pragma once
+
+// Video capture of what a machine draws, for regression runs and looking at them later.
+//
+// The emulation thread calls Chip8VideoWriter::frame() once per 60 Hz frame. A frame that
+// looks the same as the one before only bumps a counter, so the common case is a
+// generation check or one memcmp. A changed frame is copied into a bounded
+// single-producer single-consumer queue, preceded by one repeat entry for the frames held
+// back. A writer thread drains the queue into the file, so fwrite and the disk never run on
+// the emulation thread. When the queue is full frame() waits for the writer, or drops the
+// frame and counts it with drop_when_full set, the same as Chip8Trace.
+//
+// Raw files are compact and keep the repeats:
+//   header    "C8FV", u32 version
+//   records   u8 kind, then
+//             0: CHIP-8 frame, 32 rows of 8 bytes
+//             1: SUPER-CHIP frame, 64 rows of 16 bytes
+//             2: u32 count, the previous frame is shown count more times
+// Rows start with the leftmost pixel in the top bit of their first byte, and numbers are
+// in host byte order.
+//
+// Y4M files play anywhere. They are always 128x64 at 60 fps, with CHIP-8 pixels doubled,
+// and the writer thread writes repeats out as whole frames again.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include "framebuffer.cpp"
+
+static const uint32_t chip8_video_version = 1;
+
+class Chip8VideoWriter {
+public:
+
+    enum class Format { Raw, Y4M };
+
+    static const size_t capacity = 256;  // Changed frames, a bit over 4 seconds of them
+
+    Chip8VideoWriter() : queue(new Entry[capacity]) {}
+    ~Chip8VideoWriter() { stop(); }
+
+    Chip8VideoWriter(const Chip8VideoWriter &) = delete;
+    Chip8VideoWriter &operator=(const Chip8VideoWriter &) = delete;
+
+    // Y4M for files ending in .y4m, raw otherwise
+    static Format format_for(const char* filename)
+    {
+        size_t length = strlen(filename);
+        return length >= 4 && strcmp(filename + length - 4, ".y4m") == 0 ? Format::Y4M : Format::Raw;
+    }
+
+    bool start(const char* filename, Format file_format)
+    {
+        stop();
+        file = fopen(filename, "wb");
+        if (file == nullptr)
+            return false;
+
+        format = file_format;
+        if (format == Format::Raw)
+        {
+            fwrite("C8FV", 1, 4, file);
+            fwrite(&chip8_video_version, sizeof(chip8_video_version), 1, file);
+        }
+        else
+            fputs("YUV4MPEG2 W128 H64 F60:1 Ip A1:1 C420jpeg\n", file);
+
+        head.store(0);
+        tail.store(0);
+        have_last = false;
+        held_repeats = 0;
+        captured = 0;
+        repeated = 0;
+        dropped.store(0);
+        running.store(true);
+        worker = std::thread([this] { drain(); });
+        return true;
+    }
+
+    // Emulation thread, once per 60 Hz frame
+    void frame(const Chip8 &cpu)
+    {
+        if (file == nullptr)
+            return;
+        if (have_last && same_picture(cpu))
+        {
+            ++held_repeats;
+            ++repeated;
+            return;
+        }
+
+        // Pushed before the frame so the writer sees them in order. If they don't fit the
+        // frame goes too, and they stay held for the next one.
+        Entry* entry = nullptr;
+        if (held_repeats == 0 || push_repeats())
+        {
+            held_repeats = 0;
+            entry = claim();
+        }
+        if (entry == nullptr)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        entry->repeats = 0;
+        chip8_capture_frame(cpu, entry->frame);
+        last = entry->frame;
+        last_generation = cpu.display_generation;
+        have_last = true;
+        ++captured;
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Writes out held repeats and everything queued, then closes the file
+    void stop()
+    {
+        if (file == nullptr)
+            return;
+        if (held_repeats > 0)
+        {
+            bool drop = drop_when_full;
+            drop_when_full = false;  // The tail of the run shouldn't go missing
+            push_repeats();
+            drop_when_full = drop;
+            held_repeats = 0;
+        }
+        running.store(false);
+        worker.join();
+        fclose(file);
+        file = nullptr;
+    }
+
+    // Emulation thread counts
+    uint64_t frames_captured() const { return captured; }
+    uint64_t frames_repeated() const { return repeated; }
+    uint64_t frames_dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    bool drop_when_full = false;
+
+private:
+
+    struct Entry
+    {
+        uint32_t repeats;  // Non-zero for a repeat entry, frame is unused then
+        Chip8Frame frame;
+    };
+
+    FILE* file = nullptr;
+    Format format = Format::Raw;
+    std::unique_ptr<Entry[]> queue;
+    std::atomic<bool> running{false};
+    std::thread worker;
+
+    // head and tail on their own cache lines so producer and consumer don't share one
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) std::atomic<uint64_t> dropped{0};
+
+    // Emulation thread only
+    Chip8Frame last;
+    uint64_t last_generation = 0;
+    bool have_last = false;
+    uint32_t held_repeats = 0;
+    uint64_t captured = 0;
+    uint64_t repeated = 0;
+
+    // Writer thread only, the last frame as it went into the file for Y4M repeats
+    uint8_t y4m_frame[128 * 64 * 3 / 2];
+
+    bool same_picture(const Chip8 &cpu) const
+    {
+        if (cpu.display_generation == last_generation)
+            return true;  // Nothing drew since
+        if (cpu.extendedScreenMode != last.extended)
+            return false;
+        if (cpu.extendedScreenMode)
+            return memcmp(cpu.graphics_extended, last.graphics_extended, sizeof(last.graphics_extended)) == 0;
+        return memcmp(cpu.graphics, last.graphics, sizeof(last.graphics)) == 0;
+    }
+
+    // Next free slot, nullptr when the queue is full and dropping is allowed
+    Entry* claim()
+    {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        while (h - tail.load(std::memory_order_acquire) >= capacity)
+        {
+            if (drop_when_full)
+                return nullptr;
+            std::this_thread::yield();
+        }
+        return &queue[h & (capacity - 1)];
+    }
+
+    bool push_repeats()
+    {
+        Entry* entry = claim();
+        if (entry == nullptr)
+            return false;
+        entry->repeats = held_repeats;
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+    void drain()
+    {
+        for (;;)
+        {
+            bool last_pass = !running.load();
+            uint64_t t = tail.load(std::memory_order_relaxed);
+            uint64_t h = head.load(std::memory_order_acquire);
+            for (; t != h; ++t)
+            {
+                write_entry(queue[t & (capacity - 1)]);
+                tail.store(t + 1, std::memory_order_release);
+            }
+            if (last_pass)
+                return;
+            if (t == head.load(std::memory_order_acquire))
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void write_entry(const Entry &entry)
+    {
+        if (format == Format::Raw)
+        {
+            if (entry.repeats > 0)
+            {
+                fputc(2, file);
+                fwrite(&entry.repeats, sizeof(entry.repeats), 1, file);
+                return;
+            }
+            uint8_t rows[64 * 16];
+            size_t size = entry.frame.extended ? pack_rows(&entry.frame.graphics_extended[0][0], 128, rows)
+                                               : pack_rows(entry.frame.graphics, 32, rows);
+            fputc(entry.frame.extended ? 1 : 0, file);
+            fwrite(rows, 1, size, file);
+            return;
+        }
+
+        if (entry.repeats == 0)
+            encode_y4m(entry.frame);
+        for (uint32_t i = 0; i < (entry.repeats > 0 ? entry.repeats : 1); ++i)
+        {
+            fwrite("FRAME\n", 1, 6, file);
+            fwrite(y4m_frame, 1, sizeof(y4m_frame), file);
+        }
+    }
+
+    // Words to bytes with the leftmost pixel first
+    static size_t pack_rows(const uint64_t* words, size_t count, uint8_t* out)
+    {
+        for (size_t w = 0; w < count; ++w)
+            for (int b = 0; b < 8; ++b)
+                *out++ = static_cast<uint8_t>(words[w] >> (56 - 8 * b));
+        return count * 8;
+    }
+
+    // Full range luma, black and white, grey chroma
+    void encode_y4m(const Chip8Frame &frame)
+    {
+        for (int y = 0; y < 64; ++y)
+            for (int x = 0; x < 128; ++x)
+            {
+                bool lit = frame.extended ? (frame.graphics_extended[y][x >> 6] >> (63 - (x & 63))) & 1
+                                          : (frame.graphics[y >> 1] >> (63 - (x >> 1))) & 1;
+                y4m_frame[y * 128 + x] = lit ? 255 : 0;
+            }
+        memset(y4m_frame + 128 * 64, 128, 128 * 64 / 2);
+    }
+};